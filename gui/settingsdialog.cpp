@@ -57,9 +57,13 @@ core::Settings SettingsDialog::settings() const
             result.approximation(core::Approximation::kNone);
         } else if (ui->rareEvent->isChecked()) {
             result.approximation(core::Approximation::kRareEvent);
-        } else {
-            GUI_ASSERT(ui->mcub->isChecked(), result);
+        } else if (ui->mcub->isChecked()) {
             result.approximation(core::Approximation::kMcub);
+        } else if (ui->bounds->isChecked()) {
+            result.approximation(core::Approximation::kBounds);
+        } else {
+            GUI_ASSERT(ui->inclusionExclusion->isChecked(), result);
+            result.approximation(core::Approximation::kInclusionExclusion);
         }
 
         result.limit_order(ui->productOrder->value());
@@ -101,6 +105,12 @@ void SettingsDialog::setupState(const core::Settings &initSettings)
     case core::Approximation::kMcub:
         ui->mcub->setChecked(true);
         break;
+    case core::Approximation::kBounds:
+        ui->bounds->setChecked(true);
+        break;
+    case core::Approximation::kInclusionExclusion:
+        ui->inclusionExclusion->setChecked(true);
+        break;
     }
 }
 
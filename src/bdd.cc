@@ -20,7 +20,10 @@
 
 #include "bdd.h"
 
+#include <unordered_set>
+
 #include <boost/multiprecision/miller_rabin.hpp>
+#include <boost/random/mersenne_twister.hpp>
 #include <boost/range/algorithm.hpp>
 
 #include "ext/find_iterator.h"
@@ -34,17 +37,46 @@ int GetPrimeNumber(int n) {
   assert(n > 0 && "Only natural numbers.");
   if (n % 2 == 0)
     ++n;
-  while (boost::multiprecision::miller_rabin_test(n, 25) == false)
+  boost::random::mt19937 gen;  // The default generator is not thread-safe.
+  while (boost::multiprecision::miller_rabin_test(n, 25, gen) == false)
     n += 2;
   return n;
 }
 
-Bdd::Bdd(const Pdag* graph, const Settings& settings)
+namespace {
+
+/// The min product of the argument sizes to run Apply concurrently.
+const std::int64_t kMinConcurrentWork = 1 << 16;
+/// The depth of the concurrent Apply recursion to stop spawning tasks.
+const int kMaxSpawnDepth = 16;
+
+}  // namespace
+
+Bdd::Bdd(const Pdag* graph, const Settings& settings, int max_vertices,
+         const Pdag::IndexMap<double>* p_vars)
     : kSettings_(settings),
+      size_(0),
+      num_free_(0),
+      gc_limit_(1 << 14),
+      and_table_(1000, settings.cache_size()),
+      or_table_(1000, settings.cache_size()),
+      consensus_table_(1000, settings.cache_size()),
+      kOne_(0, false),
       coherent_(graph->coherent()),
-      kOne_(new Terminal<Ite>(true)),
-      function_id_(2) {
+      num_created_(0),
+      kMaxVertices_(max_vertices),
+      scheduler_(nullptr),
+      num_concurrent_applies_(0),
+      num_collections_(0),
+      num_combinations_(0),
+      max_intermediate_size_(0),
+      num_retained_tables_(0),
+      num_truncations_(0),
+      num_dropped_vertices_(0) {
   TIMER(DEBUG3, "Converting PDAG into BDD");
+  AllocateVertex();  // The terminal vertex at the position 0.
+  nodes_[0] = {0, kOne_, kOne_};
+  Rehash(GetPrimeNumber(1000));
   if (graph->IsTrivial()) {
     const Gate& top_gate = graph->root();
     assert(top_gate.args().size() == 1);
@@ -52,26 +84,58 @@ Bdd::Bdd(const Pdag* graph, const Settings& settings)
     int child = *top_gate.args().begin();
     if (top_gate.constant()) {
       // Constant case should only happen to the top gate.
-      root_ = {child < 0, kOne_};
+      root_ = Function(kOne_ ^ (child < 0), this);
     } else {
       const Variable& var = top_gate.args<Variable>().begin()->second;
-      root_ = {child < 0,
-               FindOrAddVertex(var.index(), kOne_, kOne_, true, var.order())};
+      root_ = Function(FindOrAddVertex(var.index(), kOne_, kOne_ ^ true,
+                                       var.order()) ^ (child < 0),
+                       this);
       index_to_order_.emplace(var.index(), var.order());
     }
+  } else if (p_vars) {
+    std::unordered_map<int, std::pair<Bounds, int>> gates;
+    Bounds bounds = ConvertBounds(graph->root(), *p_vars, &gates);
+    if (graph->complement()) {
+      root_ = Function(bounds.first.edge() ^ true, this);
+      lower_root_ = Function(bounds.second.edge() ^ true, this);
+    } else {
+      root_ = bounds.second;
+      lower_root_ = bounds.first;
+    }
   } else {
     std::unordered_map<int, std::pair<Function, int>> gates;
-    root_ = ConvertGraph(graph->root(), &gates);
-    root_.complement ^= graph->complement();
+    Function root = ConvertGraph(graph->root(), &gates);
+    root_ = Function(root.edge() ^ graph->complement(), this);
   }
+  if (!lower_root_)
+    lower_root_ = root_;
   ClearMarks(false);
-  TestStructure(root_.vertex);
-  LOG(DEBUG4) << "# of BDD vertices created: " << function_id_ - 1;
-  LOG(DEBUG4) << "# of entries in unique table: " << unique_table_.size();
+  TestStructure(root_.vertex());
+  LOG(DEBUG4) << "# of BDD vertices created: " << num_created_;
+  LOG(DEBUG4) << "# of entries in unique table: " << num_vertices();
+  LOG(DEBUG4) << "# of garbage collections: " << num_collections_;
+  LOG(DEBUG4) << "# of concurrent Apply calls: " << num_concurrent_applies_;
   LOG(DEBUG4) << "# of entries in AND table: " << and_table_.size();
   LOG(DEBUG4) << "# of entries in OR table: " << or_table_.size();
+  LOG(DEBUG4) << "AND table hit rate: " << and_table_.hit_rate();
+  LOG(DEBUG4) << "OR table hit rate: " << or_table_.hit_rate();
+  LOG(DEBUG4) << "Argument combination order: "
+              << kCombinationToString[static_cast<int>(
+                     kSettings_.combination())];
+  LOG(DEBUG4) << "# of argument combinations: " << num_combinations_;
+  if (max_intermediate_size_)
+    LOG(DEBUG4) << "Max counted intermediate function size: "
+                << max_intermediate_size_;
+  LOG(DEBUG4) << "# of gates reusing computation tables: "
+              << num_retained_tables_;
+  if (p_vars) {
+    LOG(DEBUG4) << "# of functions truncated to width "
+                << kSettings_.bdd_width() << ": " << num_truncations_;
+    LOG(DEBUG4) << "# of vertices replaced by terminals: "
+                << num_dropped_vertices_;
+  }
   ClearMarks(false);
-  LOG(DEBUG4) << "# of ITE in BDD: " << CountIteNodes(root_.vertex);
+  LOG(DEBUG4) << "# of ITE in BDD: " << CountIteNodes(root_.vertex());
   ClearMarks(false);
   if (coherent_) {  // Clear tables if no more calculations are expected.
     Freeze();
@@ -82,58 +146,152 @@ Bdd::Bdd(const Pdag* graph, const Settings& settings)
 
 Bdd::~Bdd() noexcept = default;
 
+int Bdd::EstimateSize(const Pdag* graph, const Settings& settings,
+                      int max_vertices) noexcept {
+  return Bdd(graph, settings, max_vertices, nullptr).num_created_;
+}
+
 void Bdd::Analyze() noexcept {
   zbdd_ = std::make_unique<Zbdd>(this, kSettings_);
+  if (!coherent_) {
+    LOG(DEBUG4) << "# of entries in consensus table: "
+                << consensus_table_.size();
+    LOG(DEBUG4) << "Consensus table hit rate: " << consensus_table_.hit_rate();
+  }
   zbdd_->Analyze();
   if (!coherent_)  // The BDD has been used by the ZBDD.
     Freeze();
 }
 
-ItePtr Bdd::FindOrAddVertex(int index, const VertexPtr& high,
-                            const VertexPtr& low, bool complement_edge,
-                            int order) noexcept {
+Bdd::Edge Bdd::FindOrAddVertex(int index, Edge high, Edge low, int order,
+                               bool module, bool coherent) noexcept {
   assert(index > 0 && "Only positive indices are expected.");
-  IteWeakPtr& in_table =
-      unique_table_.FindOrAdd(index, high->id(),
-                              complement_edge ? -low->id() : low->id());
-  if (!in_table.expired())
-    return in_table.lock();
-  assert(order > 0 && "Improper order.");
-  ItePtr ite(new Ite(index, order, function_id_++, high, low));
-  ite->complement_edge(complement_edge);
-  in_table = ite;
-  return ite;
+  assert(buckets_ && "No modifications after the freeze.");
+  bool complement = high.complement();  // Only the low edge is attributed.
+  high = high ^ complement;
+  low = low ^ complement;
+  if (!scheduler_ && num_vertices() >= 0.75 * num_buckets_)
+    Rehash(GetPrimeNumber(2 * num_buckets_));
+  std::atomic<Vertex>& head = buckets_[GetBucket(index, high, low)];
+  Vertex first = head.load(std::memory_order_acquire);
+  Vertex searched = 0;  // The end of the chain searched so far.
+  Vertex vertex = 0;  // The new vertex if not found.
+  while (true) {
+    for (Vertex it = first; it != searched; it = next_[it]) {
+      const Node& node = nodes_[it];
+      if (node.index == index && node.high == high && node.low == low) {
+        if (vertex)  // Another thread has added the same vertex.
+          nodes_[vertex].index = 0;
+        return Edge(it, complement);
+      }
+    }
+    if (!vertex) {
+      assert(order > 0 && "Improper order.");
+      vertex = AllocateVertex();
+      assert(!num_refs_[vertex] && "Reclaimed vertex in use.");
+      nodes_[vertex] = {index, high, low};
+      orders_[vertex] = order;
+      flags_[vertex] = (module ? kModule : 0) | (coherent ? kCoherent : 0);
+    }
+    searched = first;
+    next_[vertex] = first;
+    if (head.compare_exchange_weak(first, vertex, std::memory_order_release,
+                                   std::memory_order_acquire)) {
+      break;
+    }
+  }
+  num_created_.fetch_add(1, std::memory_order_relaxed);
+  return Edge(vertex, complement);
 }
 
-ItePtr Bdd::FindOrAddVertex(const ItePtr& ite, const VertexPtr& high,
-                            const VertexPtr& low,
-                            bool complement_edge) noexcept {
-  ItePtr in_table =
-      FindOrAddVertex(ite->index(), high, low, complement_edge, ite->order());
-  if (in_table->unique()) {
-    in_table->module(ite->module());
-    in_table->coherent(ite->coherent());
-  }
-  assert(in_table->module() == ite->module());
-  assert(in_table->coherent() == ite->coherent());
+Bdd::Edge Bdd::FindOrAddVertex(Vertex ite, Edge high, Edge low) noexcept {
+  Ite prototype(ite, this);
+  Edge in_table = FindOrAddVertex(prototype.index(), high, low,
+                                  prototype.order(), prototype.module(),
+                                  prototype.coherent());
+  assert(this->ite(in_table.vertex()).module() == prototype.module());
+  assert(this->ite(in_table.vertex()).coherent() == prototype.coherent());
   return in_table;
 }
 
-ItePtr Bdd::FindOrAddVertex(const Gate& gate, const VertexPtr& high,
-                            const VertexPtr& low,
-                            bool complement_edge) noexcept {
+Bdd::Edge Bdd::FindOrAddVertex(const Gate& gate, Edge high,
+                               Edge low) noexcept {
   assert(gate.module() && "Only module gates are expected for proxies.");
-  ItePtr in_table =
-      FindOrAddVertex(gate.index(), high, low, complement_edge, gate.order());
-  if (in_table->unique()) {
-    in_table->module(gate.module());
-    in_table->coherent(gate.coherent());
-  }
-  assert(in_table->module() == gate.module());
-  assert(in_table->coherent() == gate.coherent());
+  Edge in_table = FindOrAddVertex(gate.index(), high, low, gate.order(),
+                                  gate.module(), gate.coherent());
+  assert(ite(in_table.vertex()).module() == gate.module());
+  assert(ite(in_table.vertex()).coherent() == gate.coherent());
   return in_table;
 }
 
+Bdd::Vertex Bdd::AllocateVertex() noexcept {
+  int num_free = num_free_.load(std::memory_order_relaxed);
+  while (num_free > 0) {
+    if (num_free_.compare_exchange_weak(num_free, num_free - 1,
+                                        std::memory_order_relaxed)) {
+      return free_[num_free - 1];
+    }
+  }
+  Vertex vertex = size_.fetch_add(1, std::memory_order_relaxed);
+  assert(vertex < (Vertex(1) << 31) && "Edge handles are exhausted.");
+  nodes_.grow(vertex);
+  num_refs_.grow(vertex);
+  orders_.grow(vertex);
+  flags_.grow(vertex);
+  next_.grow(vertex);
+  return vertex;
+}
+
+void Bdd::Rehash(int num_buckets) noexcept {
+  assert(!scheduler_ && "Rehashing in concurrent computations.");
+  buckets_ = std::make_unique<std::atomic<Vertex>[]>(num_buckets);
+  num_buckets_ = num_buckets;
+  for (Vertex vertex = 1; vertex < size_; ++vertex) {
+    const Node& node = nodes_[vertex];
+    if (!node.index)
+      continue;  // Reclaimed position.
+    std::atomic<Vertex>& head =
+        buckets_[GetBucket(node.index, node.high, node.low)];
+    next_[vertex] = head.load(std::memory_order_relaxed);
+    head.store(vertex, std::memory_order_relaxed);
+  }
+}
+
+void Bdd::CollectGarbage() noexcept {
+  if (num_vertices() < gc_limit_)
+    return;
+  std::vector<Vertex> reachable;
+  for (Vertex vertex = 1; vertex < size_; ++vertex) {
+    if (num_refs_[vertex])
+      reachable.push_back(vertex);
+  }
+  while (!reachable.empty()) {
+    Vertex vertex = reachable.back();
+    reachable.pop_back();
+    if (terminal(vertex) || flags_[vertex] & kReach)
+      continue;
+    flags_[vertex] |= kReach;
+    reachable.push_back(nodes_[vertex].high.vertex());
+    reachable.push_back(nodes_[vertex].low.vertex());
+  }
+  free_.clear();
+  // The lowest positions are reused first.
+  for (Vertex vertex = size_ - 1; vertex > 0; --vertex) {
+    if (flags_[vertex] & kReach) {
+      flags_[vertex] &= ~kReach;
+    } else {
+      nodes_[vertex].index = 0;
+      free_.push_back(vertex);
+    }
+  }
+  num_free_ = free_.size();
+  Rehash(num_buckets_);
+  ClearTables();
+  consensus_table_.clear();
+  ++num_collections_;
+  gc_limit_ = std::max(gc_limit_, 2 * num_vertices());
+}
+
 Bdd::Function Bdd::ConvertGraph(
     const Gate& gate,
     std::unordered_map<int, std::pair<Function, int>>* gates) noexcept {
@@ -150,35 +308,31 @@ Bdd::Function Bdd::ConvertGraph(
   }
   std::vector<Function> args;
   for (const Gate::ConstArg<Variable>& arg : gate.args<Variable>()) {
-    args.push_back(
-        {arg.first < 0, FindOrAddVertex(arg.second.index(), kOne_, kOne_, true,
-                                        arg.second.order())});
+    args.emplace_back(FindOrAddVertex(arg.second.index(), kOne_, kOne_ ^ true,
+                                      arg.second.order()) ^ (arg.first < 0),
+                      this);
     index_to_order_.emplace(arg.second.index(), arg.second.order());
   }
   for (const Gate::ConstArg<Gate>& arg : gate.args<Gate>()) {
     Function res = ConvertGraph(arg.second, gates);
     if (arg.second.module()) {
-      args.push_back(
-          {arg.first < 0, FindOrAddVertex(arg.second, kOne_, kOne_, true)});
+      args.emplace_back(
+          FindOrAddVertex(arg.second, kOne_, kOne_ ^ true) ^ (arg.first < 0),
+          this);
     } else {
-      bool complement = (arg.first < 0) ^ res.complement;
-      args.push_back({complement, res.vertex});
+      args.emplace_back(res.edge() ^ (arg.first < 0), this);
     }
   }
-  boost::sort(args, [](const Function& lhs, const Function& rhs) {
-    if (lhs.vertex->terminal())
-      return true;
-    if (rhs.vertex->terminal())
-      return false;
-    return Ite::Ref(lhs.vertex).order() > Ite::Ref(rhs.vertex).order();
-  });
-  auto it = args.cbegin();
-  for (result = *it++; it != args.cend(); ++it) {
-    result = Apply(gate.type(), result.vertex, it->vertex, result.complement,
-                   it->complement);
+  result = Combine(gate.type(), &args);
+  // The positions of vertices are reused only after garbage collection,
+  // which clears the tables,
+  // so the computation results stay valid for the following gates.
+  if (and_table_.size() + or_table_.size() > kSettings_.cache_retention()) {
+    ClearTables();
+  } else {
+    ++num_retained_tables_;
   }
-  ClearTables();
-  assert(result.vertex);
+  assert(result);
   if (gate.module())
     modules_.emplace(gate.index(), result);
   if (gate.parents().size() > 1)
@@ -186,189 +340,425 @@ Bdd::Function Bdd::ConvertGraph(
   return result;
 }
 
-std::pair<int, int> Bdd::GetMinMaxId(const VertexPtr& arg_one,
-                                     const VertexPtr& arg_two,
-                                     bool complement_one,
-                                     bool complement_two) noexcept {
-  assert(!arg_one->terminal() && !arg_two->terminal());
-  assert(arg_one->id() && arg_two->id());
-  assert(arg_one->id() != arg_two->id());
-  int min_id = arg_one->id() * (complement_one ? -1 : 1);
-  int max_id = arg_two->id() * (complement_two ? -1 : 1);
-  if (arg_one->id() > arg_two->id())
-    std::swap(min_id, max_id);
-  return {min_id, max_id};
+Bdd::Bounds Bdd::ConvertBounds(
+    const Gate& gate, const Pdag::IndexMap<double>& p_vars,
+    std::unordered_map<int, std::pair<Bounds, int>>* gates) noexcept {
+  assert(!gate.constant() && "Unexpected constant gate!");
+  Bounds result;  // For the NRVO, due to memoization.
+  if (auto it_entry = ext::find(*gates, gate.index())) {
+    std::pair<Bounds, int>& entry = it_entry->second;
+    result = entry.first;
+    assert(entry.second < gate.parents().size());  // Processed parents.
+    if (++entry.second == gate.parents().size())
+      gates->erase(it_entry);
+    return result;
+  }
+  std::vector<Bounds> args;
+  for (const Gate::ConstArg<Variable>& arg : gate.args<Variable>()) {
+    Function var(FindOrAddVertex(arg.second.index(), kOne_, kOne_ ^ true,
+                                 arg.second.order()) ^ (arg.first < 0),
+                 this);
+    args.emplace_back(var, var);
+    index_to_order_.emplace(arg.second.index(), arg.second.order());
+  }
+  for (const Gate::ConstArg<Gate>& arg : gate.args<Gate>()) {
+    Bounds res = ConvertBounds(arg.second, p_vars, gates);
+    if (arg.first < 0) {  // The complement swaps the bounds.
+      args.emplace_back(Function(res.second.edge() ^ true, this),
+                        Function(res.first.edge() ^ true, this));
+    } else {
+      args.push_back(std::move(res));
+    }
+  }
+  // The intermediate results are truncated
+  // to keep the width bounded for gates with many arguments.
+  auto apply = [this, &gate, &p_vars](const Function& lhs,
+                                      const Function& rhs, bool upper) {
+    ++num_combinations_;
+    return Truncate(Apply(gate.type(), lhs, rhs), upper, p_vars);
+  };
+  result = args.front();
+  for (auto it = std::next(args.begin()); it != args.end(); ++it) {
+    result.first = apply(result.first, it->first, false);
+    result.second = apply(result.second, it->second, true);
+  }
+  ClearTables();  // Release the truncated vertices.
+  assert(result.first && result.second);
+  if (gate.parents().size() > 1)
+    gates->insert({gate.index(), {result, 1}});
+  return result;
+}
+
+Bdd::Function Bdd::Truncate(const Function& function, bool upper,
+                            const Pdag::IndexMap<double>& p_vars) noexcept {
+  if (function.edge().terminal())
+    return function;
+  std::vector<Ite> vertices;
+  auto collect = [this, &vertices](Vertex vertex, const auto& self) {
+    if (terminal(vertex))
+      return;
+    Ite ite(vertex, this);
+    if (ite.mark())
+      return;
+    ite.mark(true);
+    vertices.push_back(ite);
+    self(ite.high(), self);
+    self(ite.low(), self);
+  };
+  collect(function.vertex(), collect);
+  ClearMarks(function.vertex(), false);
+  const int width = kSettings_.bdd_width();
+  if (vertices.size() <= width)
+    return function;
+
+  // Top-down propagation of the probabilities to reach vertices
+  // through the vertices kept in the graph.
+  std::stable_sort(vertices.begin(), vertices.end(),
+                   [](const Ite& lhs, const Ite& rhs) {
+                     return lhs.order() < rhs.order();
+                   });
+  std::unordered_map<Vertex, double> reach = {{function.vertex(), 1}};
+  auto propagate = [&reach](Vertex vertex, double p) {
+    if (!terminal(vertex))
+      reach[vertex] += p;
+  };
+  auto greater_reach = [&reach](const Ite& lhs, const Ite& rhs) {
+    return reach.find(lhs.vertex())->second > reach.find(rhs.vertex())->second;
+  };
+  std::unordered_set<Vertex> dropped;
+  for (auto it = vertices.begin(), it_level = it; it != vertices.end();
+       it = it_level) {
+    int order = it->order();
+    it_level = std::find_if(it, vertices.end(), [order](const Ite& ite) {
+      return ite.order() != order;
+    });
+    auto it_end = std::partition(it, it_level, [&reach](const Ite& ite) {
+      return reach.count(ite.vertex());
+    });
+    if (std::distance(it, it_end) > width) {
+      std::nth_element(it, it + width, it_end, greater_reach);
+      for (auto it_drop = it + width; it_drop != it_end; ++it_drop)
+        dropped.insert(it_drop->vertex());
+      it_end = it + width;
+    }
+    for (; it != it_end; ++it) {
+      double p_reach = reach.find(it->vertex())->second;
+      double p_var = p_vars[it->index()];
+      propagate(it->high(), p_reach * p_var);
+      propagate(it->low(), p_reach * (1 - p_var));
+    }
+  }
+  if (dropped.empty())
+    return function;
+  ++num_truncations_;
+  num_dropped_vertices_ += dropped.size();
+
+  // The if-then-else is monotone in both branches,
+  // so replacing sub-functions with constants bounds the whole function.
+  // Sub-functions are tracked with their complement interpretation.
+  std::unordered_map<std::uint32_t, Edge> results;
+  auto rebuild = [this, upper, &dropped, &results](Edge edge,
+                                                   const auto& self) -> Edge {
+    if (edge.terminal())
+      return edge;
+    if (dropped.count(edge.vertex()))
+      return kOne_ ^ !upper;
+    if (auto it = ext::find(results, edge.value()))
+      return it->second;
+    const Node& node = nodes_[edge.vertex()];
+    Edge high = self(node.high ^ edge.complement(), self);
+    Edge low = self(node.low ^ edge.complement(), self);
+    Edge result =
+        high == low ? high : FindOrAddVertex(edge.vertex(), high, low);
+    results.emplace(edge.value(), result);
+    return result;
+  };
+  return Function(rebuild(function.edge(), rebuild), this);
+}
+
+Bdd::Function Bdd::Combine(Operator type,
+                           std::vector<Function>* args) noexcept {
+  assert(!args->empty() && "No arguments to combine.");
+  auto apply = [this, type](const Function& lhs, const Function& rhs) {
+    ++num_combinations_;
+    return Apply(type, lhs, rhs);
+  };
+  switch (kSettings_.combination()) {
+    case Combination::kOrder: {
+      boost::sort(*args, [this](const Function& lhs, const Function& rhs) {
+        if (lhs.edge().terminal())
+          return true;
+        if (rhs.edge().terminal())
+          return false;
+        return orders_[lhs.vertex()] > orders_[rhs.vertex()];
+      });
+      Function result = args->front();
+      for (auto it = std::next(args->begin()); it != args->end(); ++it)
+        result = apply(result, *it);
+      return result;
+    }
+    case Combination::kBalanced: {
+      // Neighbors in the variable order are likely to share variables.
+      boost::sort(*args, [this](const Function& lhs, const Function& rhs) {
+        if (lhs.edge().terminal())
+          return !rhs.edge().terminal();
+        if (rhs.edge().terminal())
+          return false;
+        return orders_[lhs.vertex()] < orders_[rhs.vertex()];
+      });
+      for (int size = args->size(); size > 1; size = (size + 1) / 2) {
+        for (int i = 0; i < size / 2; ++i)
+          (*args)[i] = apply((*args)[2 * i], (*args)[2 * i + 1]);
+        if (size % 2)
+          (*args)[size / 2] = std::move((*args)[size - 1]);
+      }
+      return args->front();
+    }
+    case Combination::kSize: {
+      std::vector<std::pair<int, Function>> sized;
+      for (Function& arg : *args) {
+        int size = CountVertices(arg.vertex());
+        max_intermediate_size_ = std::max(max_intermediate_size_, size);
+        sized.emplace_back(size, std::move(arg));
+      }
+      std::stable_sort(sized.begin(), sized.end(),
+                       [](const auto& lhs, const auto& rhs) {
+                         return lhs.first < rhs.first;
+                       });
+      Function result = sized.front().second;
+      for (auto it = std::next(sized.begin()); it != sized.end(); ++it)
+        result = apply(result, it->second);
+      return result;
+    }
+    case Combination::kQueue: {
+      using Entry = std::pair<int, Function>;
+      auto greater = [](const Entry& lhs, const Entry& rhs) {
+        return lhs.first > rhs.first;
+      };
+      std::vector<Entry> heap;
+      for (Function& arg : *args) {
+        int size = CountVertices(arg.vertex());
+        max_intermediate_size_ = std::max(max_intermediate_size_, size);
+        heap.emplace_back(size, std::move(arg));
+      }
+      std::make_heap(heap.begin(), heap.end(), greater);
+      while (heap.size() > 1) {
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        Entry first = std::move(heap.back());
+        heap.pop_back();
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        Function result = apply(first.second, heap.back().second);
+        int size = CountVertices(result.vertex());
+        max_intermediate_size_ = std::max(max_intermediate_size_, size);
+        heap.back() = {size, std::move(result)};
+        std::push_heap(heap.begin(), heap.end(), greater);
+      }
+      return heap.front().second;
+    }
+  }
+  assert(false && "Unexpected combination order.");
+  return args->front();
+}
+
+int Bdd::CountVertices(Vertex vertex) noexcept {
+  auto count = [this](Vertex root, const auto& self) -> int {
+    if (terminal(root))
+      return 0;
+    Ite ite(root, this);
+    if (ite.mark())
+      return 0;
+    ite.mark(true);
+    return 1 + self(ite.high(), self) + self(ite.low(), self);
+  };
+  int num_vertices = count(vertex, count);
+  ClearMarks(vertex, false);
+  return num_vertices;
 }
 
 /// Specialization of Apply for AND operator with BDD vertices.
 template <>
-Bdd::Function Bdd::Apply<kAnd>(const VertexPtr& arg_one,
-                               const VertexPtr& arg_two, bool complement_one,
-                               bool complement_two) noexcept {
-  assert(arg_one->id() && arg_two->id());  // Both are reduced function graphs.
-  if (arg_one->terminal()) {
-    if (complement_one)
-      return {true, kOne_};
-    return {complement_two, arg_two};
-  }
-  if (arg_two->terminal()) {
-    if (complement_two)
-      return {true, kOne_};
-    return {complement_one, arg_one};
-  }
-  if (arg_one->id() == arg_two->id()) {  // Reduction detection.
-    if (complement_one ^ complement_two)
-      return {true, kOne_};
-    return {complement_one, arg_one};
-  }
-  std::pair<int, int> min_max_id =
-      GetMinMaxId(arg_one, arg_two, complement_one, complement_two);
-  if (auto it = ext::find(and_table_, min_max_id))
-    return it->second;
-  Function result = Apply<kAnd>(Ite::Ptr(arg_one), Ite::Ptr(arg_two),
-                                complement_one, complement_two);
-  and_table_.emplace(min_max_id, result);
+Bdd::Edge Bdd::Apply<kAnd>(Edge arg_one, Edge arg_two, int depth) noexcept {
+  assert(arg_one && arg_two);  // Both are reduced function graphs.
+  if (arg_one.terminal())
+    return arg_one.complement() ? arg_one : arg_two;
+  if (arg_two.terminal())
+    return arg_two.complement() ? arg_two : arg_one;
+  if (arg_one.vertex() == arg_two.vertex())  // Reduction detection.
+    return arg_one == arg_two ? arg_one : kOne_ ^ true;
+  std::pair<std::uint32_t, std::uint32_t> key = GetMinMaxKey(arg_one, arg_two);
+  std::uint32_t value;
+  if (and_table_.find(key, &value))
+    return Edge(value >> 1, value & 1);
+  Edge result = ApplyIte<kAnd>(arg_one, arg_two, depth);
+  and_table_.emplace(key, result.value());
   return result;
 }
 
 /// Specialization of Apply for OR operator with BDD vertices.
 template <>
-Bdd::Function Bdd::Apply<kOr>(const VertexPtr& arg_one,
-                              const VertexPtr& arg_two, bool complement_one,
-                              bool complement_two) noexcept {
-  assert(arg_one->id() && arg_two->id());  // Both are reduced function graphs.
-  if (arg_one->terminal()) {
-    if (!complement_one)
-      return {false, kOne_};
-    return {complement_two, arg_two};
-  }
-  if (arg_two->terminal()) {
-    if (!complement_two)
-      return {false, kOne_};
-    return {complement_one, arg_one};
-  }
-  if (arg_one->id() == arg_two->id()) {  // Reduction detection.
-    if (complement_one ^ complement_two)
-      return {false, kOne_};
-    return {complement_one, arg_one};
-  }
-  std::pair<int, int> min_max_id =
-      GetMinMaxId(arg_one, arg_two, complement_one, complement_two);
-  if (auto it = ext::find(or_table_, min_max_id))
-    return it->second;
-  Function result = Apply<kOr>(Ite::Ptr(arg_one), Ite::Ptr(arg_two),
-                               complement_one, complement_two);
-  or_table_.emplace(min_max_id, result);
+Bdd::Edge Bdd::Apply<kOr>(Edge arg_one, Edge arg_two, int depth) noexcept {
+  assert(arg_one && arg_two);  // Both are reduced function graphs.
+  if (arg_one.terminal())
+    return arg_one.complement() ? arg_two : arg_one;
+  if (arg_two.terminal())
+    return arg_two.complement() ? arg_one : arg_two;
+  if (arg_one.vertex() == arg_two.vertex())  // Reduction detection.
+    return arg_one == arg_two ? arg_one : kOne_;
+  std::pair<std::uint32_t, std::uint32_t> key = GetMinMaxKey(arg_one, arg_two);
+  std::uint32_t value;
+  if (or_table_.find(key, &value))
+    return Edge(value >> 1, value & 1);
+  Edge result = ApplyIte<kOr>(arg_one, arg_two, depth);
+  or_table_.emplace(key, result.value());
   return result;
 }
 
 template <Operator Type>
-Bdd::Function Bdd::Apply(ItePtr ite_one, ItePtr ite_two,
-                         bool complement_one,
-                         bool complement_two) noexcept {
-  if (ite_one->order() > ite_two->order()) {
-    ite_one.swap(ite_two);
-    std::swap(complement_one, complement_two);
-  }
-
-  Function high;
-  Function low;
-  if (ite_one->order() == ite_two->order()) {  // The same variable.
-    assert(ite_one->index() == ite_two->index());
-    high = Apply<Type>(ite_one->high(), ite_two->high(), complement_one,
-                       complement_two);
-    low = Apply<Type>(ite_one->low(), ite_two->low(),
-                      complement_one ^ ite_one->complement_edge(),
-                      complement_two ^ ite_two->complement_edge());
+Bdd::Edge Bdd::ApplyIte(Edge ite_one, Edge ite_two, int depth) noexcept {
+  if (num_created_.load(std::memory_order_relaxed) > kMaxVertices_)
+    return kOne_;  // The estimation is cut short.
+  if (orders_[ite_one.vertex()] > orders_[ite_two.vertex()])
+    std::swap(ite_one, ite_two);
+  const Node& node_one = nodes_[ite_one.vertex()];
+  Edge high_one = node_one.high ^ ite_one.complement();
+  Edge low_one = node_one.low ^ ite_one.complement();
+  Edge high_two = ite_two;
+  Edge low_two = ite_two;
+  if (orders_[ite_one.vertex()] == orders_[ite_two.vertex()]) {
+    const Node& node_two = nodes_[ite_two.vertex()];
+    assert(node_one.index == node_two.index);
+    high_two = node_two.high ^ ite_two.complement();
+    low_two = node_two.low ^ ite_two.complement();
   } else {
-    assert(ite_one->order() < ite_two->order());
-    high =
-        Apply<Type>(ite_one->high(), ite_two, complement_one, complement_two);
-    low = Apply<Type>(ite_one->low(), ite_two,
-                      complement_one ^ ite_one->complement_edge(),
-                      complement_two);
+    assert(orders_[ite_one.vertex()] < orders_[ite_two.vertex()]);
   }
-
-  bool complement_edge = high.complement ^ low.complement;
-  if (complement_edge || (high.vertex->id() != low.vertex->id())) {
-    high.vertex =
-        FindOrAddVertex(ite_one, high.vertex, low.vertex, complement_edge);
+  Edge high;
+  Edge low;
+  if (scheduler_ && depth < kMaxSpawnDepth) {
+    auto apply_high = [this, high_one, high_two, depth] {
+      return Apply<Type>(high_one, high_two, depth + 1);
+    };
+    TaskScheduler::Job<decltype(apply_high)> high_task(apply_high);
+    scheduler_->Spawn(&high_task);
+    low = Apply<Type>(low_one, low_two, depth + 1);
+    scheduler_->Join(&high_task);
+    high = high_task.result();
+  } else {
+    high = Apply<Type>(high_one, high_two, depth + 1);
+    low = Apply<Type>(low_one, low_two, depth + 1);
   }
+  if (high == low)
+    return high;
+  return FindOrAddVertex(ite_one.vertex(), high, low);
+}
 
-  return high;
+Bdd::Edge Bdd::ApplyConcurrently(Operator type, Edge arg_one, Edge arg_two,
+                                 int num_arg_vertices) noexcept {
+  int num_expected = num_vertices() + 4 * num_arg_vertices;
+  if (num_expected >= 0.75 * num_buckets_)
+    Rehash(GetPrimeNumber(num_expected / 0.75 + 1));
+  ConcurrentCacheTable& table = type == kAnd ? and_table_ : or_table_;
+  table.reserve(table.size() + 4 * num_arg_vertices);
+  TaskScheduler scheduler(kSettings_.num_threads());
+  scheduler_ = &scheduler;
+  table.concurrent(true);
+  Edge result = scheduler.Run([this, type, arg_one, arg_two] {
+    if (type == kAnd)
+      return Apply<kAnd>(arg_one, arg_two, 0);
+    assert(type == kOr && "Unsupported operator.");
+    return Apply<kOr>(arg_one, arg_two, 0);
+  });
+  table.concurrent(false);
+  scheduler_ = nullptr;
+  ++num_concurrent_applies_;
+  return result;
 }
 
-Bdd::Function Bdd::Apply(Operator type,
-                         const VertexPtr& arg_one, const VertexPtr& arg_two,
-                         bool complement_one, bool complement_two) noexcept {
-  assert(arg_one->id() && arg_two->id());  // Both are reduced function graphs.
-  if (type == kAnd) {
-    return Apply<kAnd>(arg_one, arg_two, complement_one, complement_two);
+Bdd::Function Bdd::Apply(Operator type, const Function& arg_one,
+                         const Function& arg_two) noexcept {
+  assert(arg_one && arg_two);  // Both are reduced function graphs.
+  CollectGarbage();  // All the live vertices are held by functions.
+  if (kSettings_.num_threads() > 1 && !arg_one.edge().terminal() &&
+      !arg_two.edge().terminal()) {
+    std::int64_t size_one = CountVertices(arg_one.vertex());
+    std::int64_t size_two = CountVertices(arg_two.vertex());
+    if (size_one * size_two >= kMinConcurrentWork) {
+      return Function(ApplyConcurrently(type, arg_one.edge(), arg_two.edge(),
+                                        size_one + size_two),
+                      this);
+    }
   }
+  if (type == kAnd)
+    return Function(Apply<kAnd>(arg_one.edge(), arg_two.edge(), 0), this);
   assert(type == kOr && "Unsupported operator.");
-  return Apply<kOr>(arg_one, arg_two, complement_one, complement_two);
+  return Function(Apply<kOr>(arg_one.edge(), arg_two.edge(), 0), this);
 }
 
-Bdd::Function Bdd::CalculateConsensus(const ItePtr& ite,
-                                      bool complement) noexcept {
-  ClearTables();
-  return Apply<kAnd>(ite->high(), ite->low(), complement,
-                     ite->complement_edge() ^ complement);
+Bdd::Function Bdd::CalculateConsensus(Vertex ite, bool complement) noexcept {
+  std::pair<std::uint32_t, std::uint32_t> key = {ite, complement};
+  if (auto it = ext::find(consensus_table_, key))
+    return Function(it->second, this);
+  // No garbage is collected during the conversion into ZBDD,
+  // so the computation results stay valid between the consensus calculations.
+  if (and_table_.size() + or_table_.size() > kSettings_.cache_retention())
+    ClearTables();
+  Node node = nodes_[ite];
+  Edge result =
+      Apply<kAnd>(node.high ^ complement, node.low ^ complement, 0);
+  consensus_table_.emplace(key, result);
+  return Function(result, this);
 }
 
-int Bdd::CountIteNodes(const VertexPtr& vertex) noexcept {
-  if (vertex->terminal())
+int Bdd::CountIteNodes(Vertex vertex) noexcept {
+  if (terminal(vertex))
     return 0;
-  Ite& ite = Ite::Ref(vertex);
+  Ite ite(vertex, this);
   if (ite.mark())
     return 0;
   ite.mark(true);
   int in_module = 0;
   if (ite.module()) {
     const Function& module = modules_.find(ite.index())->second;
-    in_module = CountIteNodes(module.vertex);
+    in_module = CountIteNodes(module.vertex());
   }
   return 1 + in_module + CountIteNodes(ite.high()) + CountIteNodes(ite.low());
 }
 
-void Bdd::ClearMarks(const VertexPtr& vertex, bool mark) noexcept {
-  if (vertex->terminal())
+void Bdd::ClearMarks(Vertex vertex, bool mark) noexcept {
+  if (terminal(vertex))
     return;
-  Ite& ite = Ite::Ref(vertex);
+  Ite ite(vertex, this);
   if (ite.mark() == mark)
     return;
   ite.mark(mark);
   if (ite.module()) {
     const Function& res = modules_.find(ite.index())->second;
-    ClearMarks(res.vertex, mark);
+    ClearMarks(res.vertex(), mark);
   }
   ClearMarks(ite.high(), mark);
   ClearMarks(ite.low(), mark);
 }
 
-void Bdd::TestStructure(const VertexPtr& vertex) noexcept {
-  if (vertex->terminal())
+void Bdd::TestStructure(Vertex vertex) noexcept {
+  if (terminal(vertex))
     return;
-  Ite& ite = Ite::Ref(vertex);
+  Ite ite(vertex, this);
   if (ite.mark())
     return;
   ite.mark(true);
   assert(ite.index() && "Illegal index for a node.");
   assert(ite.order() && "Improper order for nodes.");
-  assert(ite.high() && ite.low() && "Malformed node high/low pointers.");
-  assert(
-      !(!ite.complement_edge() && ite.high()->id() == ite.low()->id()) &&
-      "Reduction rule failure.");
-  assert(!(!ite.high()->terminal() &&
-           ite.order() >= Ite::Ref(ite.high()).order()) &&
+  assert(!nodes_[vertex].high.complement() && "Complement high edge.");
+  assert(!(!ite.complement_edge() && ite.high() == ite.low()) &&
+         "Reduction rule failure.");
+  assert(!(!terminal(ite.high()) && ite.order() >= orders_[ite.high()]) &&
          "Ordering of nodes failed.");
-  assert(!(!ite.low()->terminal() &&
-           ite.order() >= Ite::Ref(ite.low()).order()) &&
+  assert(!(!terminal(ite.low()) && ite.order() >= orders_[ite.low()]) &&
          "Ordering of nodes failed.");
   if (ite.module()) {
     const Function& res = modules_.find(ite.index())->second;
-    assert(!res.vertex->terminal() && "Terminal modules must be removed.");
-    TestStructure(res.vertex);
+    assert(!terminal(res.vertex()) && "Terminal modules must be removed.");
+    TestStructure(res.vertex());
   }
   TestStructure(ite.high());
   TestStructure(ite.low());
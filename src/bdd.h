@@ -22,9 +22,13 @@
 #define SCRAM_SRC_BDD_H_
 
 #include <cmath>
+#include <cstdint>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <forward_list>
+#include <limits>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -34,6 +38,8 @@
 #include <boost/noncopyable.hpp>
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 
+#include "ext/bits.h"
+#include "parallel.h"
 #include "pdag.h"
 #include "settings.h"
 
@@ -321,59 +327,6 @@ class NonTerminal : public Vertex<T>, public IntrusivePtrCast<T> {
   bool mark_;  ///< Traversal mark.
 };
 
-/// Representation of non-terminal if-then-else vertices in BDD graphs.
-/// This class is designed to help construct and manipulate BDD graphs.
-///
-/// This class provides one attributed complement edge.
-/// The attributed edge applies to the low/false/0 branch of the vertex.
-/// However, there is no logic to check
-/// if the complement edge manipulations are valid.
-/// Consistency is the responsibility of BDD algorithms and users.
-class Ite : public NonTerminal<Ite> {
-  /// Special handling of the complement flag in computing low id signature.
-  ///
-  /// @param[in] ite  Ite vertex.
-  ///
-  /// @returns The signed number for complement low id.
-  friend int get_low_id(const Ite& ite) noexcept {
-    return ite.complement_edge_ ? -ite.low()->id() : ite.low()->id();
-  }
-
- public:
-  using NonTerminal::NonTerminal;
-
-  /// @returns true if the low edge is complement.
-  bool complement_edge() const { return complement_edge_; }
-
-  /// Sets the complement flag for the low edge.
-  ///
-  /// @param[in] flag  Indicator to treat the low branch as a complement.
-  void complement_edge(bool flag) { complement_edge_ = flag; }
-
-  /// @returns The probability of the function graph.
-  double p() const { return p_; }
-
-  /// Sets the probability of the function graph.
-  ///
-  /// @param[in] value  Calculated value for the probability.
-  void p(double value) { p_ = value; }
-
-  /// @returns Saved results of importance factor calculations.
-  double factor() const { return factor_; }
-
-  /// Memorized results of importance factor calculations.
-  ///
-  /// @param[in] value  Calculation results for importance factor.
-  void factor(double value) { factor_ = value; }
-
- private:
-  bool complement_edge_ = false;  ///< Flag for complement edge.
-  double p_ = 0;  ///< Probability of the function graph.
-  double factor_ = 0;  ///< Importance factor calculation results.
-};
-
-using ItePtr = IntrusivePtr<Ite>;  ///< Shared if-then-else vertices.
-
 /// Prime number generation for hash tables.
 ///
 /// @param[in] n  The starting candidate for a prime number.
@@ -560,8 +513,14 @@ class UniqueTable {
 /// The implementation of the table
 /// is very much coupled with the BDD use cases.
 ///
+/// The table grows with rehashing only up to its maximum capacity.
+/// Upon reaching the maximum capacity,
+/// the table becomes a bounded lossy cache,
+/// and new entries simply overwrite the colliding old ones.
+///
 /// @tparam V  The type of the value/result of BDD Apply.
 ///            The type must provide swap(), reset(), and operator bool().
+/// @tparam K  The type of the key hashable with boost::hash_value.
 ///
 /// @note The API is designed after STL maps as drop-in replacement for BDD.
 ///       This approach allows performance testing with the baseline.
@@ -569,13 +528,13 @@ class UniqueTable {
 ///
 /// @warning The behavior is very different from standard maps.
 ///          References can easily be invalidated upon rehashing or insertion.
-template <class V>
+template <class V, class K = std::pair<int, int>>
 class CacheTable {
  public:
   /// Public typedefs similar to the standard maps.
   ///
   /// @{
-  using key_type = std::pair<int, int>;
+  using key_type = K;
   using mapped_type = V;
   using value_type = std::pair<key_type, mapped_type>;
   using container_type = std::vector<value_type>;
@@ -584,17 +543,38 @@ class CacheTable {
 
   /// Constructor with average expectations for computations.
   ///
-  /// @param[in] init_capacity
-  explicit CacheTable(int init_capacity = 1000)
+  /// @param[in] init_capacity  The starting capacity for the table.
+  /// @param[in] max_capacity  The limit on the capacity of the table.
+  ///                          The limit is rounded up to a prime number.
+  explicit CacheTable(int init_capacity = 1000,
+                      int max_capacity = std::numeric_limits<int>::max())
       : size_(0),
         max_load_factor_(0.75),
-        table_(core::GetPrimeNumber(init_capacity)) {}
+        max_capacity_(core::GetPrimeNumber(max_capacity)),
+        num_hits_(0),
+        num_misses_(0),
+        table_(core::GetPrimeNumber(std::min(init_capacity, max_capacity))) {
+    assert(max_capacity > 0 && "The table must be able to hold an entry.");
+  }
 
   /// @returns The number of entires in the table.
   int size() const { return size_; }
 
+  /// @returns The ratio of successful lookups to all lookups
+  ///          over the lifetime of the table.
+  double hit_rate() const {
+    std::int64_t num_lookups = num_hits_ + num_misses_;
+    return num_lookups ? static_cast<double>(num_hits_) / num_lookups : 0;
+  }
+
+  /// @returns The number of successful lookups
+  ///          over the lifetime of the table.
+  std::int64_t num_hits() const { return num_hits_; }
+
   /// Removes all entries from the table.
   void clear() {
+    if (size_ == 0)
+      return;
     for (value_type& entry : table_) {
       if (entry.second)
         entry.second.reset();
@@ -616,7 +596,7 @@ class CacheTable {
     }
     if (n <= size_)
       return;
-    Rehash(core::GetPrimeNumber(n / max_load_factor_ + 1));
+    Rehash(GetCapacity(n / max_load_factor_ + 1));
   }
 
   /// Searches for existing entry.
@@ -628,8 +608,11 @@ class CacheTable {
   iterator find(const key_type& key) {
     int index = boost::hash_value(key) % table_.size();
     value_type& entry = table_[index];
-    if (!entry.second || entry.first != key)
+    if (!entry.second || entry.first != key) {
+      ++num_misses_;
       return table_.end();
+    }
+    ++num_hits_;
     return table_.begin() + index;
   }
 
@@ -647,8 +630,10 @@ class CacheTable {
   void emplace(const key_type& key, const mapped_type& value) {
     assert(value && "Empty computation results!");
 
-    if (size_ >= (max_load_factor_ * table_.size()))
-      Rehash(core::GetPrimeNumber(table_.size() * 2));
+    if (size_ >= (max_load_factor_ * table_.size()) &&
+        table_.size() < max_capacity_) {
+      Rehash(GetCapacity(table_.size() * 2));
+    }
 
     int index = boost::hash_value(key) % table_.size();
     value_type& entry = table_[index];
@@ -659,10 +644,23 @@ class CacheTable {
   }
 
  private:
+  /// Computes a new capacity for the table within the limit.
+  ///
+  /// @param[in] n  The desired capacity.
+  ///
+  /// @returns A prime capacity not exceeding the maximum capacity.
+  int GetCapacity(std::int64_t n) const {
+    if (n >= max_capacity_)
+      return max_capacity_;
+    return std::min(core::GetPrimeNumber(static_cast<int>(n)), max_capacity_);
+  }
+
   /// Rehashes the table with a new capacity.
   ///
   /// @param[in] new_capacity  Desired size of the underlying container.
   void Rehash(int new_capacity) {
+    if (new_capacity == table_.size())
+      return;
     int new_size = 0;
     std::vector<value_type> new_table(new_capacity);
     for (value_type& entry : table_) {
@@ -681,38 +679,503 @@ class CacheTable {
 
   int size_;  ///< The total number of elements in the table.
   double max_load_factor_;  ///< The limit on (size / capacity) ratio.
+  int max_capacity_;  ///< The bound on the size of the underlying container.
+  std::int64_t num_hits_;  ///< The number of successful lookups.
+  std::int64_t num_misses_;  ///< The number of failed lookups.
   std::vector<value_type> table_;  ///< The main container.
 };
 
+/// Array of elements in geometrically growing blocks.
+/// The blocks are never moved once allocated,
+/// so the elements can be accessed while other threads grow the array.
+///
+/// @tparam T  The default-constructible type of elements.
+template <class T>
+class BlockArray : private boost::noncopyable {
+ public:
+  BlockArray() {
+    for (std::atomic<T*>& block : blocks_)
+      block.store(nullptr, std::memory_order_relaxed);
+  }
+
+  ~BlockArray() noexcept { clear(); }
+
+  /// @param[in] pos  The position of an element in the grown array.
+  ///
+  /// @returns The element at the position.
+  T& operator[](std::uint32_t pos) {
+    std::pair<int, std::uint32_t> location = Locate(pos);
+    return blocks_[location.first].load(
+        std::memory_order_acquire)[location.second];
+  }
+
+  /// @param[in] pos  The position of an element in the grown array.
+  ///
+  /// @returns The element at the position.
+  const T& operator[](std::uint32_t pos) const {
+    return const_cast<BlockArray*>(this)->operator[](pos);
+  }
+
+  /// Allocates the storage for an element.
+  /// The new elements are value-initialized.
+  ///
+  /// @param[in] pos  The position of the element.
+  void grow(std::uint32_t pos) {
+    std::atomic<T*>& block = blocks_[Locate(pos).first];
+    if (block.load(std::memory_order_acquire))
+      return;
+    T* storage = new T[kFirstBlockSize << Locate(pos).first]();
+    T* expected = nullptr;  // Another thread may allocate the same block.
+    if (!block.compare_exchange_strong(expected, storage,
+                                       std::memory_order_acq_rel)) {
+      delete[] storage;
+    }
+  }
+
+  /// Releases all the elements.
+  void clear() noexcept {
+    for (std::atomic<T*>& block : blocks_)
+      delete[] block.exchange(nullptr);
+  }
+
+ private:
+  static const int kFirstBlockBits = 10;  ///< The log2 of the first block.
+  static const std::uint32_t kFirstBlockSize = 1 << kFirstBlockBits;
+
+  /// @param[in] pos  The position of an element.
+  ///
+  /// @returns The block and the offset in the block.
+  static std::pair<int, std::uint32_t> Locate(std::uint32_t pos) {
+    std::uint64_t shifted = std::uint64_t(pos) + kFirstBlockSize;
+    int bit = ext::last_one_bit_index(shifted);
+    return {bit - kFirstBlockBits,
+            static_cast<std::uint32_t>(shifted - (std::uint64_t(1) << bit))};
+  }
+
+  /// The blocks of doubling sizes to cover all 32-bit positions.
+  std::array<std::atomic<T*>, 33 - kFirstBlockBits> blocks_;
+};
+
+/// Lossy cache of BDD computation results
+/// for concurrent lookups and insertions without locks.
+/// The keys and values are 32-bit edge handles.
+/// Every entry is guarded with a sequence number (seqlock):
+/// a writer gives up on the entry being written by another thread,
+/// and a reader misses the entry changed while reading.
+///
+/// The table grows like CacheTable only in the sequential mode.
+/// The capacity is fixed while the table is concurrently used,
+/// and the lookup statistics are not collected.
+class ConcurrentCacheTable {
+ public:
+  using key_type = std::pair<std::uint32_t, std::uint32_t>;  ///< Edge values.
+
+  /// @param[in] init_capacity  The starting capacity for the table.
+  /// @param[in] max_capacity  The limit on the capacity of the table.
+  ///                          The limit is rounded up to a prime number.
+  ConcurrentCacheTable(int init_capacity, int max_capacity)
+      : size_(0),
+        max_load_factor_(0.75),
+        max_capacity_(core::GetPrimeNumber(max_capacity)),
+        num_hits_(0),
+        num_misses_(0),
+        concurrent_(false),
+        capacity_(0) {
+    assert(max_capacity > 0 && "The table must be able to hold an entry.");
+    Rehash(core::GetPrimeNumber(std::min(init_capacity, max_capacity)));
+  }
+
+  /// @returns The number of entires in the table.
+  int size() const { return size_; }
+
+  /// @returns The ratio of successful lookups to all sequential lookups
+  ///          over the lifetime of the table.
+  double hit_rate() const {
+    std::int64_t num_lookups = num_hits_ + num_misses_;
+    return num_lookups ? static_cast<double>(num_hits_) / num_lookups : 0;
+  }
+
+  /// Switches the table between the sequential and concurrent use.
+  ///
+  /// @param[in] flag  true for the concurrent use.
+  ///
+  /// @pre The table is not used by other threads.
+  void concurrent(bool flag) {
+    concurrent_ = flag;
+    if (flag)
+      return;
+    size_ = 0;  // The concurrent insertions are not counted.
+    for (int i = 0; i < capacity_; ++i) {
+      if (table_[i].value.load(std::memory_order_relaxed) != kEmpty)
+        ++size_;
+    }
+  }
+
+  /// Removes all entries from the table.
+  ///
+  /// @pre The table is used sequentially.
+  void clear() {
+    if (size_ == 0)
+      return;
+    for (int i = 0; i < capacity_; ++i)
+      table_[i].value.store(kEmpty, std::memory_order_relaxed);
+    size_ = 0;
+  }
+
+  /// Prepares the table for more entries.
+  ///
+  /// @param[in] n  The number of expected entries.
+  ///
+  /// @pre The table is used sequentially.
+  ///
+  /// @post If n is 0 and the table is empty,
+  ///       the memory is freed as much as possible.
+  ///       Using after release of memory is undefined.
+  void reserve(int n) {
+    if (size_ == 0 && n == 0) {
+      table_.reset();
+      capacity_ = 0;
+      return;
+    }
+    if (n <= size_)
+      return;
+    Rehash(GetCapacity(n / max_load_factor_ + 1));
+  }
+
+  /// Searches for existing entry.
+  ///
+  /// @param[in] key  Ordered argument edge values of BDD Apply.
+  /// @param[out] value  The result edge value if found.
+  ///
+  /// @returns true if the entry with the given key is found.
+  bool find(const key_type& key, std::uint32_t* value) {
+    Entry& entry = table_[boost::hash_value(key) % capacity_];
+    std::uint32_t version = entry.version.load(std::memory_order_acquire);
+    std::uint32_t first = entry.first.load(std::memory_order_relaxed);
+    std::uint32_t second = entry.second.load(std::memory_order_relaxed);
+    std::uint32_t result = entry.value.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    bool hit = !(version & 1) &&
+               entry.version.load(std::memory_order_relaxed) == version &&
+               result != kEmpty && first == key.first && second == key.second;
+    if (hit) {
+      *value = result;
+      if (!concurrent_)
+        ++num_hits_;
+    } else if (!concurrent_) {
+      ++num_misses_;
+    }
+    return hit;
+  }
+
+  /// Emplaces a new entry or drops it if the entry is being written.
+  ///
+  /// @param[in] key  Ordered argument edge values of BDD Apply.
+  /// @param[in] value  The result edge value of BDD Apply.
+  void emplace(const key_type& key, std::uint32_t value) {
+    assert(value != kEmpty && "Empty computation results!");
+    if (!concurrent_ && size_ >= (max_load_factor_ * capacity_) &&
+        capacity_ < max_capacity_) {
+      Rehash(GetCapacity(capacity_ * std::int64_t(2)));
+    }
+    Entry& entry = table_[boost::hash_value(key) % capacity_];
+    std::uint32_t version = entry.version.load(std::memory_order_relaxed);
+    if (version & 1 ||
+        !entry.version.compare_exchange_strong(version, version + 1,
+                                               std::memory_order_relaxed)) {
+      return;  // Another thread is writing the entry.
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    if (!concurrent_ &&
+        entry.value.load(std::memory_order_relaxed) == kEmpty) {
+      ++size_;
+    }
+    entry.first.store(key.first, std::memory_order_relaxed);
+    entry.second.store(key.second, std::memory_order_relaxed);
+    entry.value.store(value, std::memory_order_relaxed);
+    entry.version.store(version + 2, std::memory_order_release);
+  }
+
+ private:
+  /// The value reserved for empty entries.
+  static const std::uint32_t kEmpty = ~std::uint32_t(0);
+
+  /// The key and value guarded with the version (odd while written).
+  struct Entry {
+    std::atomic<std::uint32_t> version;  ///< The sequence number.
+    std::atomic<std::uint32_t> first;  ///< The first argument value.
+    std::atomic<std::uint32_t> second;  ///< The second argument value.
+    std::atomic<std::uint32_t> value;  ///< The result value.
+  };
+
+  /// Computes a new capacity for the table within the limit.
+  ///
+  /// @param[in] n  The desired capacity.
+  ///
+  /// @returns A prime capacity not exceeding the maximum capacity.
+  int GetCapacity(std::int64_t n) const {
+    if (n >= max_capacity_)
+      return max_capacity_;
+    return std::min(core::GetPrimeNumber(static_cast<int>(n)), max_capacity_);
+  }
+
+  /// Rehashes the table with a new capacity.
+  ///
+  /// @param[in] new_capacity  Desired size of the underlying container.
+  void Rehash(int new_capacity) {
+    if (new_capacity == capacity_)
+      return;
+    std::unique_ptr<Entry[]> new_table(new Entry[new_capacity]);
+    for (int i = 0; i < new_capacity; ++i) {
+      new_table[i].version.store(0, std::memory_order_relaxed);
+      new_table[i].value.store(kEmpty, std::memory_order_relaxed);
+    }
+    int new_size = 0;
+    for (int i = 0; i < capacity_; ++i) {
+      std::uint32_t value = table_[i].value.load(std::memory_order_relaxed);
+      if (value == kEmpty)
+        continue;
+      key_type key = {table_[i].first.load(std::memory_order_relaxed),
+                      table_[i].second.load(std::memory_order_relaxed)};
+      Entry& new_entry = new_table[boost::hash_value(key) % new_capacity];
+      if (new_entry.value.load(std::memory_order_relaxed) == kEmpty)
+        ++new_size;
+      new_entry.first.store(key.first, std::memory_order_relaxed);
+      new_entry.second.store(key.second, std::memory_order_relaxed);
+      new_entry.value.store(value, std::memory_order_relaxed);
+    }
+    size_ = new_size;
+    capacity_ = new_capacity;
+    table_.swap(new_table);
+  }
+
+  int size_;  ///< The number of entries counted in the sequential mode.
+  double max_load_factor_;  ///< The limit on (size / capacity) ratio.
+  int max_capacity_;  ///< The bound on the size of the underlying container.
+  std::int64_t num_hits_;  ///< The number of successful lookups.
+  std::int64_t num_misses_;  ///< The number of failed lookups.
+  bool concurrent_;  ///< The indicator of the concurrent use.
+  int capacity_;  ///< The number of entries in the underlying container.
+  std::unique_ptr<Entry[]> table_;  ///< The main container.
+};
+
 class Zbdd;  // For analysis purposes.
 
 /// Analysis of PDAGs with Binary Decision Diagrams.
 /// This binary decision diagram data structure
 /// represents Reduced Ordered BDD with attributed edges.
 ///
+/// The if-then-else vertices are kept in a node store
+/// and refer to each other with 32-bit edge handles.
+/// The attributes of vertices that are not part of the unique signature
+/// are kept in side arrays indexed by vertex positions.
+/// Unreachable vertices are reclaimed by mark-and-sweep garbage collection
+/// between the top-level computations.
+///
+/// Large top-level computations are run in fork-join parallel
+/// if the analysis settings allow more than one thread.
+/// The store, the unique table, and the AND/OR computation tables
+/// accept concurrent insertions without locks;
+/// the rest of the facilities are sequential.
+///
 /// @note The low/else edge is chosen to have the attribute for an ITE vertex.
 ///       There is only one terminal vertex of value 1/True.
 class Bdd : private boost::noncopyable {
  public:
-  using VertexPtr = IntrusivePtr<Vertex<Ite>>;  ///< BDD vertex base.
-  using TerminalPtr = IntrusivePtr<Terminal<Ite>>;  ///< Terminal vertices.
+  /// Position of a vertex in the node store.
+  /// The position 0 is reserved for the terminal vertex.
+  using Vertex = std::uint32_t;
+
+  /// Attributed edge handle to a vertex in the node store.
+  /// The handle packs the position of the vertex
+  /// with the complement flag in the lowest bit,
+  /// so the constant True and False are the handles 0 and 1.
+  class Edge {
+   public:
+    /// Constructs an empty handle to initialize table entries.
+    Edge() noexcept : value_(kEmpty) {}
+
+    /// @param[in] vertex  The position of the vertex.
+    /// @param[in] complement  Interpretation of the vertex as complement.
+    Edge(Vertex vertex, bool complement) noexcept
+        : value_(vertex << 1 | complement) {}
+
+    /// @returns The position of the vertex.
+    Vertex vertex() const { return value_ >> 1; }
+
+    /// @returns true if the vertex is interpreted as complement.
+    bool complement() const { return value_ & 1; }
+
+    /// @returns true if the edge leads to the terminal vertex.
+    bool terminal() const { return value_ < 2; }
+
+    /// @returns The packed value of the handle.
+    std::uint32_t value() const { return value_; }
+
+    /// @returns true if the handle is not empty.
+    explicit operator bool() const { return value_ != kEmpty; }
+
+    /// Empties the handle.
+    void reset() { value_ = kEmpty; }
+
+    /// Swaps with another edge.
+    void swap(Edge& other) noexcept { std::swap(value_, other.value_); }
+
+    /// @param[in] flag  Indicator to complement the edge.
+    ///
+    /// @returns The complement edge if the flag is set,
+    ///          this edge otherwise.
+    Edge operator^(bool flag) const {
+      Edge edge;
+      edge.value_ = value_ ^ flag;
+      return edge;
+    }
+
+    /// @returns true if the edges denote the same function.
+    friend bool operator==(Edge lhs, Edge rhs) {
+      return lhs.value_ == rhs.value_;
+    }
+
+    /// @returns true if the edges denote different functions.
+    friend bool operator!=(Edge lhs, Edge rhs) { return !(lhs == rhs); }
+
+   private:
+    /// The handle value reserved for empty edges.
+    static const std::uint32_t kEmpty = ~std::uint32_t(0);
+
+    std::uint32_t value_;  ///< The position and the complement flag.
+  };
+
+  /// Unique signature of an if-then-else vertex in the node store.
+  /// The high edge is never complement.
+  struct Node {
+    std::int32_t index;  ///< Index of the variable; 0 for unused positions.
+    Edge high;  ///< 1 (True/then) branch in the Shannon decomposition.
+    Edge low;  ///< O (False/else) branch with the complement attribute.
+  };
 
   /// Holder of computation resultant functions and gate representations.
-  struct Function {
-    bool complement;  ///< The interpretation of the function.
-    VertexPtr vertex;  ///< The root vertex of the BDD function graph.
+  /// The function graph is kept alive in the node store
+  /// as long as the holder exists.
+  class Function {
+   public:
+    /// Constructs an empty function.
+    Function() noexcept : bdd_(nullptr) {}
+
+    /// @param[in] edge  The root edge of the function graph.
+    /// @param[in,out] bdd  The host BDD of the function graph.
+    Function(Edge edge, Bdd* bdd) noexcept : edge_(edge), bdd_(bdd) {
+      ++bdd_->num_refs_[edge_.vertex()];
+    }
+
+    /// @param[in] other  The function to share the graph with.
+    Function(const Function& other) noexcept
+        : edge_(other.edge_), bdd_(other.bdd_) {
+      if (bdd_)
+        ++bdd_->num_refs_[edge_.vertex()];
+    }
+
+    /// @param[in] other  The function to take over.
+    Function(Function&& other) noexcept : edge_(other.edge_), bdd_(other.bdd_) {
+      other.bdd_ = nullptr;
+    }
+
+    /// @param[in] other  The function to copy or move.
+    ///
+    /// @returns Reference to this function.
+    Function& operator=(Function other) noexcept {
+      swap(other);
+      return *this;
+    }
+
+    /// Releases the graph for garbage collection.
+    ~Function() noexcept {
+      if (bdd_)
+        --bdd_->num_refs_[edge_.vertex()];
+    }
+
+    /// @returns The root edge of the function graph.
+    Edge edge() const { return edge_; }
+
+    /// @returns The root vertex of the function graph.
+    Vertex vertex() const { return edge_.vertex(); }
+
+    /// @returns The interpretation of the function.
+    bool complement() const { return edge_.complement(); }
 
     /// @returns true if the function is initialized.
-    explicit operator bool() const { return vertex != nullptr; }
+    explicit operator bool() const { return bdd_ != nullptr; }
 
-    /// Clears the function's root vertex pointer.
-    void reset() { vertex = nullptr; }
+    /// Clears the function's root vertex.
+    void reset() { Function().swap(*this); }
 
     /// Swaps with another function.
     void swap(Function& other) noexcept {
-      std::swap(complement, other.complement);
-      vertex.swap(other.vertex);
+      std::swap(edge_, other.edge_);
+      std::swap(bdd_, other.bdd_);
     }
+
+   private:
+    Edge edge_;  ///< The root edge of the function graph.
+    Bdd* bdd_;  ///< The host BDD or nullptr for empty functions.
+  };
+
+  /// Accessor of an if-then-else vertex in the node store.
+  /// The accessor is a light handle to pass by value.
+  class Ite {
+   public:
+    /// @param[in] vertex  The position of a non-terminal vertex.
+    /// @param[in,out] bdd  The host BDD of the vertex.
+    Ite(Vertex vertex, Bdd* bdd) : vertex_(vertex), bdd_(bdd) {
+      assert(!terminal(vertex) && "Terminal vertices are not ITE.");
+    }
+
+    /// @returns The position of the vertex.
+    Vertex vertex() const { return vertex_; }
+
+    /// @returns The index of the vertex variable.
+    int index() const { return bdd_->nodes_[vertex_].index; }
+
+    /// @returns The order of the vertex variable.
+    int order() const {
+      assert(bdd_->orders_[vertex_] > 0);
+      return bdd_->orders_[vertex_];
+    }
+
+    /// @returns true if this vertex represents a module gate.
+    bool module() const { return bdd_->flags_[vertex_] & kModule; }
+
+    /// @returns true if the vertex represents a coherent module.
+    bool coherent() const { return bdd_->flags_[vertex_] & kCoherent; }
+
+    /// @returns (1/True/then/left) branch vertex.
+    Vertex high() const { return bdd_->nodes_[vertex_].high.vertex(); }
+
+    /// @returns (0/False/else/right) branch vertex.
+    Vertex low() const { return bdd_->nodes_[vertex_].low.vertex(); }
+
+    /// @returns true if the low edge is complement.
+    bool complement_edge() const {
+      return bdd_->nodes_[vertex_].low.complement();
+    }
+
+    /// @returns The mark of this vertex.
+    bool mark() const { return bdd_->flags_[vertex_] & kMark; }
+
+    /// Marks this vertex.
+    ///
+    /// @param[in] flag  A flag with the meaning for the user of marks.
+    void mark(bool flag) {
+      if (flag) {
+        bdd_->flags_[vertex_] |= kMark;
+      } else {
+        bdd_->flags_[vertex_] &= ~kMark;
+      }
+    }
+
+   private:
+    Vertex vertex_;  ///< The position in the node store.
+    Bdd* bdd_;  ///< The host BDD.
   };
 
   /// Provides access to consensus calculation private facilities.
@@ -726,7 +1189,7 @@ class Bdd : private boost::noncopyable {
     /// @param[in] complement  Interpretation of the BDD vertex.
     ///
     /// @returns The consensus BDD function.
-    Function operator()(Bdd* bdd, const ItePtr& ite, bool complement) noexcept {
+    Function operator()(Bdd* bdd, Vertex ite, bool complement) noexcept {
       return bdd->CalculateConsensus(ite, complement);
     }
   };
@@ -740,14 +1203,67 @@ class Bdd : private boost::noncopyable {
   /// @pre The PDAG has variable ordering.
   ///
   /// @note BDD construction may take considerable time.
-  Bdd(const Pdag* graph, const Settings& settings);
+  Bdd(const Pdag* graph, const Settings& settings)
+      : Bdd(graph, settings, std::numeric_limits<int>::max(), nullptr) {}
+
+  /// Constructs an approximate BDD
+  /// with the number of vertices per variable level
+  /// limited by the width in the analysis settings.
+  /// The least probable vertices beyond the width are replaced
+  /// with terminals to over-approximate the root function
+  /// and under-approximate the lower bound root function.
+  ///
+  /// @param[in] graph  Preprocessed and partially normalized PDAG.
+  /// @param[in] settings  The analysis settings.
+  /// @param[in] p_vars  Probabilities of the variables mapped by indices.
+  ///
+  /// @pre The PDAG has variable ordering.
+  ///
+  /// @note Modules are not kept as separate function graphs.
+  Bdd(const Pdag* graph, const Settings& settings,
+      const Pdag::IndexMap<double>& p_vars)
+      : Bdd(graph, settings, std::numeric_limits<int>::max(), &p_vars) {}
 
   /// To handle incomplete ZBDD type with unique pointers.
   ~Bdd() noexcept;
 
+  /// Builds a BDD with a limit on the number of vertices
+  /// to estimate the quality of the PDAG variable ordering.
+  ///
+  /// @param[in] graph  Preprocessed and partially normalized PDAG.
+  /// @param[in] settings  The analysis settings.
+  /// @param[in] max_vertices  The limit on the number of created vertices.
+  ///
+  /// @returns The number of created BDD vertices.
+  ///          The number exceeds the limit
+  ///          if the construction has been cut short.
+  ///
+  /// @pre The PDAG has variable ordering.
+  static int EstimateSize(const Pdag* graph, const Settings& settings,
+                          int max_vertices) noexcept;
+
+  /// @param[in] vertex  The position of a vertex.
+  ///
+  /// @returns true if the vertex is the terminal vertex 1/True.
+  static bool terminal(Vertex vertex) { return vertex == 0; }
+
+  /// @param[in] vertex  The position of a non-terminal vertex.
+  ///
+  /// @returns The accessor of the if-then-else vertex.
+  Ite ite(Vertex vertex) { return Ite(vertex, this); }
+
+  /// @returns The number of positions in the node store.
+  ///          Vertex data can be kept by analyses in arrays of this size.
+  int store_size() const { return size_; }
+
   /// @returns The root function of the ROBDD.
+  ///          The function is an upper bound for approximate BDD.
   const Function& root() const { return root_; }
 
+  /// @returns The lower bound root function of approximate BDD.
+  ///          The function is the same as the root for exact BDD.
+  const Function& lower_root() const { return lower_root_; }
+
   /// @returns Mapping of PDAG modules and BDD graph vertices.
   const std::unordered_map<int, Function>& modules() const { return modules_; }
 
@@ -759,6 +1275,12 @@ class Bdd : private boost::noncopyable {
   /// @returns true if the BDD has been constructed from a coherent PDAG.
   bool coherent() const { return coherent_; }
 
+  /// @returns The number of consensus calculations
+  ///          reused from the memoization table for prime implicants.
+  std::int64_t num_consensus_hits() const {
+    return consensus_table_.num_hits();
+  }
+
   /// Helper function to clear and set vertex marks.
   ///
   /// @param[in] mark  Desired mark for BDD vertices.
@@ -767,7 +1289,7 @@ class Bdd : private boost::noncopyable {
   ///
   /// @warning If the graph is discontinuously and partially marked,
   ///          this function will not help with the mess.
-  void ClearMarks(bool mark) { ClearMarks(root_.vertex, mark); }
+  void ClearMarks(bool mark) { ClearMarks(root_.vertex(), mark); }
 
   /// Runs the Qualitative analysis
   /// with the representation of a PDAG as ROBDD.
@@ -782,54 +1304,112 @@ class Bdd : private boost::noncopyable {
   }
 
  private:
-  using IteWeakPtr = WeakIntrusivePtr<Ite>;  ///< Pointer in containers.
-  using ComputeTable = CacheTable<Function>;  ///< Computation results.
+  /// Sequential computation results with ordered edge handles as keys.
+  using ComputeTable =
+      CacheTable<Edge, std::pair<std::uint32_t, std::uint32_t>>;
+  using Bounds = std::pair<Function, Function>;  ///< {lower, upper} functions.
+
+  /// Vertex attribute bits in the side array of flags.
+  enum Flag : std::uint8_t {
+    kModule = 1 << 0,  ///< The vertex represents a module gate.
+    kCoherent = 1 << 1,  ///< The module is coherent.
+    kMark = 1 << 2,  ///< Traversal mark for users.
+    kReach = 1 << 3  ///< Garbage collection mark of live vertices.
+  };
+
+  /// Constructs a BDD with a limit on the number of vertices.
+  /// Upon reaching the limit,
+  /// the computations are cut short with invalid results.
+  ///
+  /// @param[in] graph  Preprocessed and partially normalized PDAG.
+  /// @param[in] settings  The analysis settings.
+  /// @param[in] max_vertices  The limit on the number of created vertices.
+  /// @param[in] p_vars  Variable probabilities for approximate BDD
+  ///                    or nullptr for exact BDD.
+  Bdd(const Pdag* graph, const Settings& settings, int max_vertices,
+      const Pdag::IndexMap<double>* p_vars);
 
   /// Finds or adds a unique if-then-else vertex in BDD.
   /// All vertices in the BDD must be created with this functions.
   /// Otherwise, the BDD may not be reduced.
   ///
+  /// A new vertex is published by swapping the head of its bucket.
+  /// If another thread has published the same vertex first,
+  /// the new vertex is left unused for garbage collection.
+  ///
   /// @param[in] index  Positive index of the variable.
-  /// @param[in] high  The high vertex.
-  /// @param[in] low  The low vertex.
-  /// @param[in] complement_edge  Interpretation of the low vertex.
+  /// @param[in] high  The high edge.
+  /// @param[in] low  The low edge.
   /// @param[in] order The order for the vertex variable.
+  /// @param[in] module  The vertex represents a module gate.
+  /// @param[in] coherent  The module is coherent.
   ///
-  /// @returns If-then-else node with the given parameters.
+  /// @returns The edge to the vertex with the given parameters.
+  ///          The edge is complement if the high edge is complement.
   ///
-  /// @pre Non-expired pointers in the unique table are
-  ///      either in the BDD or in the computation table.
-  ItePtr FindOrAddVertex(int index, const VertexPtr& high, const VertexPtr& low,
-                         bool complement_edge, int order) noexcept;
+  /// @warning This function is not aware of reduction rules.
+  Edge FindOrAddVertex(int index, Edge high, Edge low, int order,
+                       bool module = false, bool coherent = false) noexcept;
 
   /// Finds or adds a replacement for an existing node
   /// or a new node based on an existing node.
   ///
   /// @param[in] ite  An existing vertex.
-  /// @param[in] high  The new high vertex.
-  /// @param[in] low  The new low vertex.
-  /// @param[in] complement_edge  Interpretation of the low vertex.
+  /// @param[in] high  The new high edge.
+  /// @param[in] low  The new low edge.
   ///
-  /// @returns Ite for a replacement.
+  /// @returns The edge to the replacement vertex.
   ///
   /// @warning This function is not aware of reduction rules.
-  ItePtr FindOrAddVertex(const ItePtr& ite, const VertexPtr& high,
-                         const VertexPtr& low, bool complement_edge) noexcept;
+  Edge FindOrAddVertex(Vertex ite, Edge high, Edge low) noexcept;
 
   /// Find or adds a BDD ITE vertex using information from gates.
   ///
   /// @param[in] gate  Gate with index, order, and other information.
-  /// @param[in] high  The new high vertex.
-  /// @param[in] low  The new low vertex.
-  /// @param[in] complement_edge  Interpretation of the low vertex.
+  /// @param[in] high  The new high edge.
+  /// @param[in] low  The new low edge.
   ///
-  /// @returns Ite for a replacement.
+  /// @returns The edge to the vertex representing the gate.
   ///
   /// @pre The gate is a module.
   ///
   /// @warning This function is not aware of reduction rules.
-  ItePtr FindOrAddVertex(const Gate& gate, const VertexPtr& high,
-                         const VertexPtr& low, bool complement_edge) noexcept;
+  Edge FindOrAddVertex(const Gate& gate, Edge high, Edge low) noexcept;
+
+  /// Computes the unique table bucket of a vertex signature.
+  ///
+  /// @param[in] index  Index of the variable.
+  /// @param[in] high  The non-complement high edge.
+  /// @param[in] low  The low edge.
+  ///
+  /// @returns The bucket number in the unique table.
+  int GetBucket(int index, Edge high, Edge low) const {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, index);
+    boost::hash_combine(seed, high.value());
+    boost::hash_combine(seed, low.value());
+    return seed % num_buckets_;
+  }
+
+  /// Takes a reclaimed or new position in the node store.
+  ///
+  /// @returns The position for a new vertex.
+  Vertex AllocateVertex() noexcept;
+
+  /// Redistributes the live vertices into new buckets of the unique table.
+  ///
+  /// @param[in] num_buckets  The desired number of buckets.
+  ///
+  /// @pre No concurrent computations.
+  void Rehash(int num_buckets) noexcept;
+
+  /// Reclaims the vertices unreachable from the function holders
+  /// if the number of vertices has grown over the collection limit.
+  /// The computation tables are cleared upon the collection
+  /// because the positions of the reclaimed vertices are reused.
+  ///
+  /// @pre No vertex is referenced outside of the function holders.
+  void CollectGarbage() noexcept;
 
   /// Converts all gates in the PDAG
   /// into function BDD graphs.
@@ -845,22 +1425,72 @@ class Bdd : private boost::noncopyable {
       const Gate& gate,
       std::unordered_map<int, std::pair<Function, int>>* gates) noexcept;
 
-  /// Computes minimum and maximum ids for keys in computation tables.
+  /// Converts all gates in the PDAG
+  /// into lower and upper bound functions with limited width.
+  /// Modules are converted as regular gates.
+  ///
+  /// @param[in] gate  The root or current parent gate of the graph.
+  /// @param[in] p_vars  Probabilities of the variables mapped by indices.
+  /// @param[in,out] gates  Processed gates with use counts.
+  ///
+  /// @returns The lower and upper bound functions of the gate.
+  ///
+  /// @pre The memoization container is not used outside of this function.
+  Bounds ConvertBounds(
+      const Gate& gate, const Pdag::IndexMap<double>& p_vars,
+      std::unordered_map<int, std::pair<Bounds, int>>* gates) noexcept;
+
+  /// Limits the number of vertices per variable level of a function graph.
+  /// The vertices with the least probability to be reached from the root
+  /// are replaced with the terminal 1 for the upper bound
+  /// or with the terminal 0 for the lower bound.
+  ///
+  /// @param[in] function  The function graph to truncate.
+  /// @param[in] upper  true for over-approximation, false for under.
+  /// @param[in] p_vars  Probabilities of the variables mapped by indices.
+  ///
+  /// @returns The function itself if it is within the width limit,
+  ///          or the bounding function with the limited width.
+  ///
+  /// @pre Non-terminal node marks are clear (false).
+  /// @post The marks are clear.
+  Function Truncate(const Function& function, bool upper,
+                    const Pdag::IndexMap<double>& p_vars) noexcept;
+
+  /// Combines gate argument functions
+  /// in the order given by the analysis settings.
+  ///
+  /// @param[in] type  The operator or type of the gate.
+  /// @param[in,out] args  The non-empty set of argument functions.
+  ///
+  /// @returns The BDD function of the gate.
+  ///
+  /// @post The argument container is in an unspecified state.
+  Function Combine(Operator type, std::vector<Function>* args) noexcept;
+
+  /// Counts the number of if-then-else vertices in a function graph
+  /// without descending into module graphs.
+  ///
+  /// @param[in] vertex  The root vertex of the function graph.
+  ///
+  /// @returns The number of ITE vertices reachable from the root.
+  ///
+  /// @pre Non-terminal node marks are clear (false).
+  /// @post The marks are clear.
+  int CountVertices(Vertex vertex) noexcept;
+
+  /// Computes the key for computation tables.
   ///
   /// @param[in] arg_one  First argument function graph.
   /// @param[in] arg_two  Second argument function graph.
-  /// @param[in] complement_one  Interpretation of arg_one as complement.
-  /// @param[in] complement_two  Interpretation of arg_two as complement.
   ///
-  /// @returns A pair of min and max integers with a sign for a complement.
-  ///
-  /// @pre The arguments are not be the same function.
-  ///      Equal ID functions are handled by the reduction.
-  /// @pre Even though the arguments are not ItePtr type,
-  ///      they are if-then-else vertices.
-  std::pair<int, int> GetMinMaxId(const VertexPtr& arg_one,
-                                  const VertexPtr& arg_two, bool complement_one,
-                                  bool complement_two) noexcept;
+  /// @returns The ordered pair of the min and max edge handle values.
+  static std::pair<std::uint32_t, std::uint32_t> GetMinMaxKey(
+      Edge arg_one, Edge arg_two) {
+    if (arg_one.value() > arg_two.value())
+      return {arg_two.value(), arg_one.value()};
+    return {arg_one.value(), arg_two.value()};
+  }
 
   /// Applies Boolean operation to BDD graphs.
   /// This is the main function for the operation.
@@ -870,48 +1500,64 @@ class Bdd : private boost::noncopyable {
   ///
   /// @param[in] arg_one  First argument function graph.
   /// @param[in] arg_two  Second argument function graph.
-  /// @param[in] complement_one  Interpretation of arg_one as complement.
-  /// @param[in] complement_two  Interpretation of arg_two as complement.
+  /// @param[in] depth  The depth of the recursion for task spawning.
   ///
-  /// @returns The BDD function as a result of operation.
+  /// @returns The edge to the resultant function graph.
   ///
   /// @note The order of arguments does not matter for two variable operators.
   template <Operator Type>
-  Function Apply(const VertexPtr& arg_one, const VertexPtr& arg_two,
-                 bool complement_one, bool complement_two) noexcept;
+  Edge Apply(Edge arg_one, Edge arg_two, int depth) noexcept;
 
   /// Applies Boolean operation to BDD ITE graphs.
+  /// The high branch is spawned as a task
+  /// near the top of a concurrent computation.
   ///
   /// @tparam Type  The operator enum.
   ///
   /// @param[in] ite_one  First argument function graph.
   /// @param[in] ite_two  Second argument function graph.
-  /// @param[in] complement_one  Interpretation of arg_one as complement.
-  /// @param[in] complement_two  Interpretation of arg_two as complement.
+  /// @param[in] depth  The depth of the recursion for task spawning.
   ///
-  /// @returns The BDD function as a result of operation.
+  /// @returns The edge to the resultant function graph.
+  ///
+  /// @pre The arguments are different non-terminal functions.
   template <Operator Type>
-  Function Apply(ItePtr ite_one, ItePtr ite_two, bool complement_one,
-                 bool complement_two) noexcept;
+  Edge ApplyIte(Edge ite_one, Edge ite_two, int depth) noexcept;
 
-  /// Applies Boolean operation to BDD graphs.
-  /// This is a convenience function
-  /// if the operator type cannot be determined at compile time.
+  /// Applies Boolean operation to BDD graphs
+  /// with fork-join tasks on multiple threads.
+  /// The unique and computation tables are sized up front
+  /// because they cannot be rehashed during the computation.
+  ///
+  /// @param[in] type  The operator or type of the gate.
+  /// @param[in] arg_one  First argument function graph.
+  /// @param[in] arg_two  Second argument function graph.
+  /// @param[in] num_arg_vertices  The number of vertices in the arguments.
+  ///
+  /// @returns The edge to the resultant function graph.
+  ///
+  /// @pre The operator is either AND or OR.
+  Edge ApplyConcurrently(Operator type, Edge arg_one, Edge arg_two,
+                         int num_arg_vertices) noexcept;
+
+  /// Applies Boolean operation to BDD functions.
+  /// This is the entry point for top-level computations,
+  /// which may collect garbage before the operation.
+  /// The operation runs concurrently
+  /// if more than one thread is allowed
+  /// and the product of the argument sizes is large enough.
   ///
   /// @param[in] type  The operator or type of the gate.
   /// @param[in] arg_one  First argument function graph.
   /// @param[in] arg_two  Second argument function graph.
-  /// @param[in] complement_one  Interpretation of arg_one as complement.
-  /// @param[in] complement_two  Interpretation of arg_two as complement.
   ///
   /// @returns The BDD function as a result of operation.
   ///
   /// @pre The operator is either AND or OR.
   ///
   /// @note The order of arguments does not matter for two variable operators.
-  Function Apply(Operator type,
-                 const VertexPtr& arg_one, const VertexPtr& arg_two,
-                 bool complement_one, bool complement_two) noexcept;
+  Function Apply(Operator type, const Function& arg_one,
+                 const Function& arg_two) noexcept;
 
   /// Calculates consensus of high and low of an if-then-else BDD vertex.
   ///
@@ -919,7 +1565,7 @@ class Bdd : private boost::noncopyable {
   /// @param[in] complement  Interpretation of the BDD vertex.
   ///
   /// @returns The consensus BDD function.
-  Function CalculateConsensus(const ItePtr& ite, bool complement) noexcept;
+  Function CalculateConsensus(Vertex ite, bool complement) noexcept;
 
   /// Counts the number of if-then-else nodes.
   ///
@@ -928,7 +1574,7 @@ class Bdd : private boost::noncopyable {
   /// @returns The number of ITE nodes in the BDD.
   ///
   /// @pre Non-terminal node marks are clear (false).
-  int CountIteNodes(const VertexPtr& vertex) noexcept;
+  int CountIteNodes(Vertex vertex) noexcept;
 
   /// Clears marks of vertices in BDD graph.
   ///
@@ -936,7 +1582,7 @@ class Bdd : private boost::noncopyable {
   /// @param[in] mark  The desired mark for the vertices.
   ///
   /// @note Marks will propagate to modules as well.
-  void ClearMarks(const VertexPtr& vertex, bool mark) noexcept;
+  void ClearMarks(Vertex vertex, bool mark) noexcept;
 
   /// Checks BDD graphs for errors in the structure.
   /// Errors are assertions that fail at runtime.
@@ -944,7 +1590,10 @@ class Bdd : private boost::noncopyable {
   /// @param[in] vertex  The root vertex of BDD.
   ///
   /// @pre Non-terminal node marks are clear (false).
-  void TestStructure(const VertexPtr& vertex) noexcept;
+  void TestStructure(Vertex vertex) noexcept;
+
+  /// @returns The number of live and unreclaimed vertices in the store.
+  int num_vertices() const { return size_ - 1 - num_free_; }
 
   /// Clears all memoization tables.
   void ClearTables() noexcept {
@@ -957,36 +1606,71 @@ class Bdd : private boost::noncopyable {
   ///
   /// @pre No more graph modifications after the freeze.
   void Freeze() noexcept {
-    unique_table_.Release();
+    buckets_.reset();
+    num_buckets_ = 0;
+    next_.clear();
+    free_ = std::vector<Vertex>();
+    num_free_ = 0;
     ClearTables();
+    consensus_table_.clear();
     and_table_.reserve(0);
     or_table_.reserve(0);
+    consensus_table_.reserve(0);
   }
 
   const Settings kSettings_;  ///< Analysis settings.
-  Function root_;  ///< The root function of this BDD.
-  bool coherent_;  ///< Inherited coherence from PDAG.
+
+  /// The node store with the terminal vertex at the position 0.
+  /// The side arrays below are indexed by the same vertex positions.
+  BlockArray<Node> nodes_;
+  BlockArray<std::uint32_t> num_refs_;  ///< The function holders per vertex.
+  BlockArray<std::int32_t> orders_;  ///< The orders of the vertex variables.
+  BlockArray<std::uint8_t> flags_;  ///< Flag attributes of the vertices.
+  std::atomic<Vertex> size_;  ///< The number of positions in the store.
+  std::vector<Vertex> free_;  ///< Reclaimed positions for new vertices.
+  std::atomic<int> num_free_;  ///< The number of unused reclaimed positions.
+  int gc_limit_;  ///< The number of vertices to trigger garbage collection.
 
   /// Table of unique if-then-else nodes denoting function graphs.
-  /// The key consists of ite(index, id_high, id_low),
-  /// where IDs are unique (id_high != id_low) identifications of
-  /// unique reduced-ordered function graphs.
-  UniqueTable<Ite> unique_table_;
+  /// The key consists of ite(index, high, low) edge handles.
+  /// The buckets hold the first vertex of the collision chain (0 if empty),
+  /// and the chains are linked through the side array of next vertices.
+  /// New vertices are only prepended to the chains.
+  /// @{
+  std::unique_ptr<std::atomic<Vertex>[]> buckets_;
+  int num_buckets_;
+  BlockArray<Vertex> next_;
+  /// @}
 
   /// Tables of processed computations over functions.
-  /// The argument functions are recorded with their IDs (not vertex indices).
   /// In order to keep only unique computations,
-  /// the argument IDs must be ordered.
-  /// The key is {min_id, max_id}.
+  /// the argument edge handles must be ordered.
+  /// The key is {min_edge, max_edge}.
   /// @{
-  ComputeTable and_table_;
-  ComputeTable or_table_;
+  ConcurrentCacheTable and_table_;
+  ConcurrentCacheTable or_table_;
   /// @}
 
+  /// Table of consensus calculations for prime implicants.
+  /// The key is {vertex, complement} of the if-then-else vertex.
+  ComputeTable consensus_table_;
+
+  const Edge kOne_;  ///< The edge to the terminal True.
+  Function root_;  ///< The root function of this BDD.
+  Function lower_root_;  ///< The lower bound root function.
+  bool coherent_;  ///< Inherited coherence from PDAG.
   std::unordered_map<int, Function> modules_;  ///< Module graphs.
   std::unordered_map<int, int> index_to_order_;  ///< Indices and orders.
-  const TerminalPtr kOne_;  ///< Terminal True.
-  int function_id_;  ///< Identification assignment for new function graphs.
+  std::atomic<int> num_created_;  ///< The number of created vertices.
+  const int kMaxVertices_;  ///< The limit on the number of created vertices.
+  TaskScheduler* scheduler_;  ///< The scheduler of the concurrent computation.
+  int num_concurrent_applies_;  ///< The number of concurrent computations.
+  int num_collections_;  ///< The number of garbage collections.
+  int num_combinations_;  ///< The number of Apply calls on gate arguments.
+  int max_intermediate_size_;  ///< The largest counted intermediate function.
+  int num_retained_tables_;  ///< The number of gates reusing the caches.
+  int num_truncations_;  ///< The number of functions cut to the width.
+  int num_dropped_vertices_;  ///< The number of vertices replaced by terminals.
   std::unique_ptr<Zbdd> zbdd_;  ///< ZBDD as a result of analysis.
 };
 
@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2017 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file checkpoint.cc
+/// Implementation of the checkpoint directory of analysis targets.
+
+#include "checkpoint.h"
+
+#include <fstream>
+#include <sstream>
+#include <typeinfo>
+#include <unordered_map>
+
+#include <boost/filesystem.hpp>
+
+#include "ccf_group.h"
+#include "error.h"
+#include "expression.h"
+#include "logger.h"
+#include "reporter.h"
+#include "xml.h"
+
+namespace fs = boost::filesystem;
+
+namespace scram {
+
+namespace {
+
+const char kManifest[] = "manifest";  ///< The file with the checkpoint hash.
+const std::uint64_t kHashBasis = 14695981039346656037ULL;  ///< FNV-1a start.
+
+/// Accumulates the 64-bit FNV-1a hash of bytes.
+///
+/// @param[in] data  The bytes to hash.
+/// @param[in] size  The number of bytes.
+/// @param[in,out] hash  The running hash value.
+void HashBytes(const void* data, std::size_t size, std::uint64_t* hash) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i < size; ++i) {
+    *hash ^= bytes[i];
+    *hash *= 1099511628211ULL;
+  }
+}
+
+/// Accumulates the hash of a string.
+void HashValue(const std::string& value, std::uint64_t* hash) {
+  HashBytes(value.data(), value.size() + 1, hash);  // With the terminator.
+}
+
+/// Accumulates the hash of a trivially copyable value.
+template <typename T>
+void HashValue(const T& value, std::uint64_t* hash) {
+  HashBytes(&value, sizeof(value), hash);
+}
+
+/// Hashes the model constructs reachable from gates.
+/// The shared constructs are hashed once and memoized.
+class Fingerprinter {
+ public:
+  /// @returns The hash of the gate with its formula and dependencies.
+  std::uint64_t Hash(const mef::Gate& gate) {
+    auto it = gates_.find(&gate);
+    if (it != gates_.end())
+      return it->second;
+    std::uint64_t hash = kHashBasis;
+    HashValue(gate.id(), &hash);
+    HashValue(Hash(gate.formula()), &hash);
+    return gates_[&gate] = hash;
+  }
+
+ private:
+  /// @returns The hash of the formula with its arguments.
+  std::uint64_t Hash(const mef::Formula& formula) {
+    std::uint64_t hash = kHashBasis;
+    HashValue(formula.type(), &hash);
+    if (formula.type() == mef::kVote)
+      HashValue(formula.vote_number(), &hash);
+    for (const mef::Formula::EventArg& arg : formula.event_args()) {
+      HashValue(arg.which(), &hash);
+      boost::apply_visitor([this, &hash](auto* event) {
+        HashValue(this->Hash(*event), &hash);
+      }, arg);
+    }
+    for (const mef::FormulaPtr& arg : formula.formula_args())
+      HashValue(Hash(*arg), &hash);
+    return hash;
+  }
+
+  /// @returns The hash of the basic event with its probability model.
+  std::uint64_t Hash(const mef::BasicEvent& basic_event) {
+    std::uint64_t hash = kHashBasis;
+    HashValue(basic_event.id(), &hash);
+    if (basic_event.HasExpression())
+      HashValue(Hash(basic_event.expression()), &hash);
+    if (basic_event.HasCcf())
+      HashValue(Hash(basic_event.ccf_gate()), &hash);
+    return hash;
+  }
+
+  /// @returns The hash of the house event with its state.
+  std::uint64_t Hash(const mef::HouseEvent& house_event) {
+    std::uint64_t hash = kHashBasis;
+    HashValue(house_event.id(), &hash);
+    HashValue(house_event.state(), &hash);
+    return hash;
+  }
+
+  /// @returns The hash of the expression kind, value, and arguments.
+  std::uint64_t Hash(mef::Expression& expression) {
+    auto it = expressions_.find(&expression);
+    if (it != expressions_.end())
+      return it->second;
+    std::uint64_t hash = kHashBasis;
+    HashValue(std::string(typeid(expression).name()), &hash);
+    HashValue(expression.value(), &hash);
+    for (mef::Expression* arg : expression.args())
+      HashValue(Hash(*arg), &hash);
+    return expressions_[&expression] = hash;
+  }
+
+  std::unordered_map<const mef::Gate*, std::uint64_t> gates_;  ///< Memo.
+  /// The memo of shared expressions, e.g., parameters.
+  std::unordered_map<const mef::Expression*, std::uint64_t> expressions_;
+};
+
+}  // namespace
+
+Checkpoint::Checkpoint(const std::string& directory,
+                       const core::Settings& settings, bool resume)
+    : directory_(directory), resume_(resume) {
+  std::ostringstream hash_stream;
+  hash_stream << std::hex << Hash(settings);
+  std::string hash = hash_stream.str();
+  fs::path manifest = directory_ / kManifest;
+  try {
+    fs::create_directories(directory_);
+    if (resume_ && fs::exists(manifest)) {
+      std::ifstream in(manifest.string());
+      std::string stored;
+      in >> stored;
+      if (stored != hash)
+        throw ValidationError(
+            directory + " : The checkpoint is for other analysis settings.");
+      return;
+    }
+    resume_ = false;
+    for (fs::directory_iterator it(directory_), end; it != end; ++it) {
+      if (it->path().extension() == ".xml")
+        fs::remove(it->path());
+    }
+  } catch (const fs::filesystem_error& err) {
+    throw IOError(directory + " : Cannot access the checkpoint directory: " +
+                  err.what());
+  }
+  std::ofstream out(manifest.string());
+  out << hash << "\n";
+  out.close();
+  if (!out.good())
+    throw IOError(manifest.string() + " : Cannot write the checkpoint.");
+}
+
+Checkpoint::~Checkpoint() noexcept = default;
+
+bool Checkpoint::Restore(const core::RiskAnalysis::Result::Id& id,
+                         const mef::Gate& gate, double* p_total,
+                         std::string* warning) noexcept {
+  return resume_ && Load(id, gate, p_total, warning);
+}
+
+bool Checkpoint::Load(const core::RiskAnalysis::Result::Id& id,
+                      const mef::Gate& gate, double* p_total,
+                      std::string* warning) noexcept {
+  fs::path file = directory_ / FileName(id);
+  boost::system::error_code ec;
+  if (!fs::exists(file, ec))
+    return false;
+  try {
+    std::unique_ptr<xmlpp::DomParser> parser =
+        ConstructDomParser(file.string());
+    const xmlpp::Element* root = parser->get_document()->get_root_node();
+    if (root->get_name() != "target")
+      throw ValidationError(file.string() + " : Not a checkpoint fragment.");
+    if (GetAttributeValue(root, "fingerprint") != Fingerprint(gate)) {
+      LOG(DEBUG2) << "The target has changed since the checkpoint: " << file;
+      return false;
+    }
+    if (root->get_attribute("probability"))
+      *p_total = CastAttributeValue<double>(root, "probability");
+    if (root->get_attribute("warning"))
+      *warning = GetAttributeValue(root, "warning");
+    fragments_.emplace(file.filename().string(), std::move(parser));
+  } catch (const std::exception& err) {
+    LOG(WARNING) << "Discarding the checkpoint of the target: " << err.what();
+    return false;
+  }
+  return true;
+}
+
+void Checkpoint::Save(const core::RiskAnalysis::Result& result,
+                      const mef::Gate& gate) noexcept {
+  fs::path file = directory_ / FileName(result.id);
+  fs::path temp = file;
+  temp += ".tmp";
+  try {
+    std::ofstream out(temp.string());
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    {
+      XmlStreamElement target("target", out);
+      target.SetAttribute("fingerprint", Fingerprint(gate));
+      Reporter().ReportTarget(result, &target);
+    }
+    out.close();
+    if (!out.good())
+      throw IOError(temp.string() + " : Cannot write the checkpoint.");
+    fs::rename(temp, file);  // Atomic replacement for partial writes.
+  } catch (const std::exception& err) {
+    LOG(ERROR) << "Failed to checkpoint the target: " << err.what();
+  }
+}
+
+const xmlpp::Element*
+Checkpoint::Find(const core::RiskAnalysis::Result::Id& id) const {
+  auto it = fragments_.find(FileName(id));
+  if (it == fragments_.end())
+    return nullptr;
+  return it->second->get_document()->get_root_node();
+}
+
+std::string Checkpoint::FileName(const core::RiskAnalysis::Result::Id& id) {
+  struct {
+    std::string operator()(const mef::Gate* gate) { return gate->id(); }
+    std::string operator()(const std::pair<const mef::InitiatingEvent&,
+                                           const mef::Sequence&>& sequence) {
+      // The '@' is not allowed in the names of the model elements.
+      return sequence.first.name() + "@" + sequence.second.name();
+    }
+  } extractor;
+  return boost::apply_visitor(extractor, id) + ".xml";
+}
+
+std::uint64_t Checkpoint::Hash(const core::Settings& settings) {
+  std::uint64_t hash = kHashBasis;
+  // Only the settings affecting the results of targets.
+  std::ostringstream values;
+  values.precision(17);
+  values << static_cast<int>(settings.algorithm()) << ' '
+         << static_cast<int>(settings.approximation()) << ' '
+         << settings.prime_implicants() << ' ' << settings.limit_order() << ' '
+         << settings.cut_off() << ' ' << settings.bdd_width() << ' '
+         << settings.inclusion_exclusion_depth() << ' '
+         << settings.sort_products() << ' ' << settings.mission_time() << ' '
+         << settings.time_step() << ' ' << settings.probability_analysis()
+         << ' ' << settings.safety_integrity_levels() << ' '
+         << settings.importance_analysis() << ' '
+         << settings.uncertainty_analysis() << ' ' << settings.ccf_analysis()
+         << ' ' << settings.num_trials() << ' ' << settings.num_quantiles()
+         << ' ' << settings.num_bins() << ' ' << settings.seed() << ' '
+         << settings.fallback();
+  HashValue(values.str(), &hash);
+  return hash;
+}
+
+std::string Checkpoint::Fingerprint(const mef::Gate& gate) {
+  std::ostringstream fingerprint;
+  fingerprint << std::hex << Fingerprinter().Hash(gate);
+  return fingerprint.str();
+}
+
+}  // namespace scram
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2017 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file checkpoint.h
+/// Durable checkpoints of completed analysis targets.
+
+#ifndef SCRAM_SRC_CHECKPOINT_H_
+#define SCRAM_SRC_CHECKPOINT_H_
+
+#include <cstdint>
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+
+#include "event.h"
+#include "risk_analysis.h"
+#include "settings.h"
+
+namespace xmlpp {
+class DomParser;
+class Element;
+}  // namespace xmlpp
+
+namespace scram {
+
+/// Checkpoint directory with the reported results of every completed target.
+/// Each target is kept in its own XML fragment file
+/// written atomically right after the target analysis,
+/// so an interrupted run loses at most the targets in progress.
+///
+/// Every fragment carries the dependency fingerprint of its target,
+/// i.e., the hash of all the gates, events, expressions, parameters,
+/// CCF models, and house-event states reachable from the target.
+/// Only the targets with unchanged fingerprints are restored,
+/// so a revised model is re-analyzed only for the affected targets.
+/// The directory is bound to the analysis settings with a manifest hash;
+/// the restoration with other settings is rejected.
+class Checkpoint : public core::RiskAnalysis::Checkpoint {
+ public:
+  /// @param[in] directory  The checkpoint directory to create or reuse.
+  /// @param[in] settings  The analysis settings.
+  /// @param[in] resume  Reuse of the unchanged targets in the directory.
+  ///                    Otherwise, the stale fragments are discarded.
+  ///
+  /// @throws IOError  The directory is not accessible.
+  /// @throws ValidationError  The checkpoint is for other settings.
+  Checkpoint(const std::string& directory, const core::Settings& settings,
+             bool resume);
+
+  ~Checkpoint() noexcept override;
+
+  bool Restore(const core::RiskAnalysis::Result::Id& id, const mef::Gate& gate,
+               double* p_total, std::string* warning) noexcept override;
+
+  /// Writes the report fragment of the target.
+  /// Failures are logged without interrupting the analysis.
+  void Save(const core::RiskAnalysis::Result& result,
+            const mef::Gate& gate) noexcept override;
+
+  bool Collect(const core::RiskAnalysis::Result::Id& id, const mef::Gate& gate,
+               double* p_total, std::string* warning) noexcept override {
+    return Load(id, gate, p_total, warning);
+  }
+
+  /// @param[in] id  The analysis target.
+  ///
+  /// @returns The restored report fragment of the target.
+  ///          nullptr if the target is not restored.
+  const xmlpp::Element* Find(const core::RiskAnalysis::Result::Id& id) const;
+
+ private:
+  /// Loads the report fragment of the target if its dependencies are intact.
+  ///
+  /// @param[in] id  The analysis target.
+  /// @param[in] gate  The top gate of the target.
+  /// @param[out] p_total  The total probability of the target if reported.
+  /// @param[out] warning  The warning about the target results if reported.
+  ///
+  /// @returns true if the fragment is loaded.
+  bool Load(const core::RiskAnalysis::Result::Id& id, const mef::Gate& gate,
+            double* p_total, std::string* warning) noexcept;
+
+  /// @returns The unique file name of the target fragment.
+  static std::string FileName(const core::RiskAnalysis::Result::Id& id);
+
+  /// @returns The hash of the settings affecting the analysis results.
+  static std::uint64_t Hash(const core::Settings& settings);
+
+  /// @returns The hexadecimal dependency fingerprint of the target gate.
+  static std::string Fingerprint(const mef::Gate& gate);
+
+  boost::filesystem::path directory_;  ///< The checkpoint directory.
+  bool resume_;  ///< Restoration of the completed targets.
+  /// The parsed fragments of the restored targets.
+  std::map<std::string, std::unique_ptr<xmlpp::DomParser>> fragments_;
+};
+
+}  // namespace scram
+
+#endif  // SCRAM_SRC_CHECKPOINT_H_
@@ -58,12 +58,7 @@ Config::Config(const std::string& config_file) {
     throw IOError("The file '" + config_file + "' could not be loaded.");
 
   std::unique_ptr<xmlpp::DomParser> parser = ConstructDomParser(config_file);
-  try {
-    validator.validate(parser->get_document());
-  } catch (const xmlpp::validity_error&) {
-    throw ValidationError("Config XML failed schema validation:\n" +
-                          xmlpp::format_xml_error());
-  }
+  ValidateDocument(parser->get_document(), &validator, "Config XML");
   const xmlpp::Node* root = parser->get_document()->get_root_node();
   assert(root->get_name() == "scram");
   fs::path base_path = fs::path(config_file).parent_path();
@@ -118,9 +113,24 @@ void Config::GatherOptions(const xmlpp::Node* root) {
       } else if (name == "prime-implicants") {
         settings_.prime_implicants(true);
 
+      } else if (name == "sort-products") {
+        settings_.sort_products(true);
+
+      } else if (name == "fallback") {
+        settings_.fallback(true);
+
       } else if (name == "approximation") {
         SetApproximation(option_group);
 
+      } else if (name == "variable-order") {
+        settings_.variable_order(GetAttributeValue(option_group, "name"));
+
+      } else if (name == "combination") {
+        settings_.combination(GetAttributeValue(option_group, "name"));
+
+      } else if (name == "preprocessing") {
+        SetPreprocessing(option_group);
+
       } else if (name == "limits") {
         SetLimits(option_group);
       }
@@ -174,6 +184,15 @@ void Config::SetApproximation(const xmlpp::Element* approx) {
   settings_.approximation(GetAttributeValue(approx, "name"));
 }
 
+void Config::SetPreprocessing(const xmlpp::Element* preprocessing) {
+  for (const xmlpp::Node* node : preprocessing->find("./pass")) {
+    const xmlpp::Element* pass = XmlElement(node);
+    settings_.preprocessing_pass(
+        GetAttributeValue(pass, "name"),
+        GetBoolFromString(GetAttributeValue(pass, "enabled")));
+  }
+}
+
 void Config::SetLimits(const xmlpp::Element* limits) {
   for (const xmlpp::Node* node : limits->find("./*")) {
     const xmlpp::Element* limit = XmlElement(node);
@@ -201,6 +220,36 @@ void Config::SetLimits(const xmlpp::Element* limits) {
 
     } else if (name == "seed") {
       settings_.seed(CastChildText<int>(limit));
+
+    } else if (name == "cache-size") {
+      settings_.cache_size(CastChildText<int>(limit));
+
+    } else if (name == "cache-retention") {
+      settings_.cache_retention(CastChildText<int>(limit));
+
+    } else if (name == "bdd-width") {
+      settings_.bdd_width(CastChildText<int>(limit));
+
+    } else if (name == "inclusion-exclusion-depth") {
+      settings_.inclusion_exclusion_depth(CastChildText<int>(limit));
+
+    } else if (name == "product-buffer") {
+      settings_.product_buffer(CastChildText<int>(limit));
+
+    } else if (name == "pass-iterations") {
+      settings_.pass_iterations(CastChildText<int>(limit));
+
+    } else if (name == "pass-budget") {
+      settings_.pass_budget(CastChildText<double>(limit));
+
+    } else if (name == "number-of-threads") {
+      settings_.num_threads(CastChildText<int>(limit));
+
+    } else if (name == "number-of-workers") {
+      settings_.num_workers(CastChildText<int>(limit));
+
+    } else if (name == "memory-limit") {
+      settings_.memory_limit(CastChildText<int>(limit));
     }
   }
 }
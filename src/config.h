@@ -95,6 +95,11 @@ class Config {
   /// @param[in] approx  Approximation element node.
   void SetApproximation(const xmlpp::Element* approx);
 
+  /// Extracts the enable flags of preprocessing passes.
+  ///
+  /// @param[in] preprocessing  Preprocessing element node.
+  void SetPreprocessing(const xmlpp::Element* preprocessing);
+
   /// Extracts limits for analysis.
   ///
   /// @param[in] limits  An XML element containing various limits.
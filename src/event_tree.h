@@ -249,6 +249,13 @@ class Sequence : public Element, public Usage {
     return instructions_;
   }
 
+  /// @returns The end state given with the "end-state" attribute
+  ///          to group sequences for the aggregate analysis,
+  ///          or an empty string if the sequence is not grouped.
+  std::string end_state() const {
+    return HasAttribute("end-state") ? GetAttribute("end-state").value : "";
+  }
+
  private:
   /// Instructions to execute with the sequence.
   std::vector<Instruction*> instructions_;
@@ -19,6 +19,9 @@
 
 #include "event_tree_analysis.h"
 
+#include <algorithm>
+#include <map>
+
 #include "expression/numerical.h"
 #include "ext/find_iterator.h"
 
@@ -157,6 +160,64 @@ void EventTreeAnalysis::Analyze() noexcept {
     sequences_.push_back(
         {*sequence.first, std::move(gate), is_expression_only});
   }
+  CollectEndStates();
+}
+
+void EventTreeAnalysis::CollectEndStates() noexcept {
+  std::map<std::string, std::vector<const Result*>> groups;  // Stable order.
+  for (const Result& result : sequences_) {
+    std::string end_state = result.sequence.end_state();
+    if (!end_state.empty())
+      groups[end_state].push_back(&result);
+  }
+  for (const auto& group : groups) {
+    end_state_sequences_.push_back(
+        std::make_unique<mef::Sequence>(group.first));
+    auto gate = std::make_unique<mef::Gate>("__" + group.first);
+    // The collect instructions are homogeneous in the event tree;
+    // thus, a group with expressions may only be mixed
+    // with the sequences of paths without any collect instructions.
+    // These sequences are skipped
+    // like the paths without expressions of a sequence with expressions.
+    bool is_expression_only =
+        std::any_of(group.second.begin(), group.second.end(),
+                    [](const Result* result) {
+                      return result->is_expression_only;
+                    });
+    if (is_expression_only) {
+      std::vector<mef::Expression*> arg_expressions;
+      for (const Result* result : group.second) {
+        if (!result->is_expression_only)
+          continue;
+        arg_expressions.push_back(
+            &boost::get<mef::BasicEvent*>(
+                 result->gate->formula().event_args().front())
+                 ->expression());
+      }
+      auto event = std::make_unique<mef::BasicEvent>("__" + group.first);
+      if (arg_expressions.size() == 1) {
+        event->expression(arg_expressions.front());
+      } else {
+        expressions_.push_back(
+            std::make_unique<mef::Add>(std::move(arg_expressions)));
+        event->expression(expressions_.back().get());
+      }
+      gate->formula(std::make_unique<mef::Formula>(mef::kNull));
+      gate->formula().AddArgument(event.get());
+      events_.push_back(std::move(event));
+    } else if (group.second.size() == 1) {
+      gate->formula(Clone(group.second.front()->gate->formula()));
+    } else {
+      // The sequence formulas are cloned
+      // to keep the end state independent of the sequence results.
+      auto or_formula = std::make_unique<mef::Formula>(mef::kOr);
+      for (const Result* result : group.second)
+        or_formula->AddArgument(Clone(result->gate->formula()));
+      gate->formula(std::move(or_formula));
+    }
+    end_states_.push_back(
+        {*end_state_sequences_.back(), std::move(gate), is_expression_only});
+  }
 }
 
 void EventTreeAnalysis::CollectSequences(const mef::Branch& initial_state,
@@ -68,6 +68,14 @@ class EventTreeAnalysis : public Analysis {
   std::vector<Result>& sequences() { return sequences_; }
   /// @}
 
+  /// @returns The end states grouping the sequences by their attribute.
+  ///          The end states are analyzed as sequences
+  ///          with the union of the formulas of the grouped sequences.
+  /// @{
+  const std::vector<Result>& end_states() const { return end_states_; }
+  std::vector<Result>& end_states() { return end_states_; }
+  /// @}
+
  private:
   /// Expressions and formulas collected in an event tree path.
   struct PathCollector {
@@ -96,8 +104,21 @@ class EventTreeAnalysis : public Analysis {
   void CollectSequences(const mef::Branch& initial_state,
                         SequenceCollector* result) noexcept;
 
+  /// Groups the gathered sequences into end states.
+  /// The end state of expression-only sequences
+  /// is the sum of the sequence expressions
+  /// because the sequences are mutually exclusive paths.
+  /// The sequences without collected expressions in such groups
+  /// are skipped as the paths without expressions in a sequence.
+  ///
+  /// @pre The sequences are gathered.
+  void CollectEndStates() noexcept;
+
   const mef::InitiatingEvent& initiating_event_;  ///< The analysis initiator.
   std::vector<Result> sequences_;  ///< Gathered sequences.
+  std::vector<Result> end_states_;  ///< Aggregated sequences.
+  /// The end states as sequences for identification in results.
+  std::vector<std::unique_ptr<mef::Sequence>> end_state_sequences_;
   /// Newly created expressions.
   std::vector<std::unique_ptr<mef::Expression>> expressions_;
   std::vector<std::unique_ptr<mef::Event>> events_;  ///< Newly created events.
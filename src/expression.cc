@@ -46,6 +46,14 @@ void Expression::Reset() noexcept {
     arg->Reset();
 }
 
+void Expression::ResetDerived() noexcept {
+  if (!sampled_)
+    return;
+  sampled_ = false;
+  for (Expression* arg : args_)
+    arg->ResetDerived();
+}
+
 bool Expression::IsDeviate() noexcept {
   return ext::any_of(args_, [](Expression* arg) { return arg->IsDeviate(); });
 }
@@ -120,6 +120,12 @@ class Expression : private boost::noncopyable {
   /// its arguments are not going to get any calls.
   void Reset() noexcept;
 
+  /// Resets the sampled values derived from the random deviates
+  /// but keeps the samples of the deviates themselves,
+  /// so that the same sample can be re-evaluated
+  /// with other values of non-deviate arguments, e.g., the mission time.
+  virtual void ResetDerived() noexcept;
+
  protected:
   /// Registers an additional argument expression.
   ///
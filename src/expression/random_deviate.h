@@ -39,6 +39,9 @@ class RandomDeviate : public Expression {
   using Expression::Expression;
 
   bool IsDeviate() noexcept override { return true; }
+
+  /// Keeps the sampled value of the deviate.
+  void ResetDerived() noexcept override {}
 };
 
 /// Uniform distribution.
@@ -54,6 +54,24 @@ constexpr int count_trailing_zero_bits(std::uint64_t bits) noexcept {
 #endif
 }
 
+/// Finds the most significant 1 bit.
+///
+/// @param[in] bits  The positive number representing a bit array.
+///
+/// @returns The index of the last 1 bit.
+///
+/// @pre bits is not 0.
+constexpr int last_one_bit_index(std::uint64_t bits) noexcept {
+#if defined(__GNUC__)
+  return 63 - __builtin_clzl(bits);
+#else
+  int i = 63;
+  while (!test_bit(bits, i))
+    --i;
+  return i;
+#endif
+}
+
 /// Helper function to map single bit integer/enum values into indices.
 ///
 /// @param[in] bits  The value represented as an array of bits.
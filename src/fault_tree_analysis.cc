@@ -20,6 +20,7 @@
 
 #include "fault_tree_analysis.h"
 
+#include <future>
 #include <iostream>
 #include <string>
 
@@ -28,6 +29,8 @@
 
 #include "event.h"
 #include "logger.h"
+#include "parallel.h"
+#include "product_store.h"
 
 namespace scram {
 namespace core {
@@ -79,15 +82,117 @@ double Product::p() const {
   return p;
 }
 
-std::vector<int> ProductContainer::Distribution() const {
-  std::vector<int> distribution;
-  for (const std::vector<int>& product : products_) {
-    int index = product.empty() ? 0 : product.size() - 1;
-    if (distribution.size() <= index)
-      distribution.resize(index + 1);
-    distribution[index]++;
+namespace {
+
+/// The number of product ranges per analysis thread
+/// to balance the uneven sizes of the ranges.
+const int kRangesPerThread = 4;
+
+/// Folds products in disjoint ranges concurrently.
+/// The partial results are merged in the order of the ranges,
+/// so the result does not depend on the thread scheduling.
+///
+/// @tparam T  The copyable type of the result.
+/// @tparam F  The folding function of a product into a partial result.
+/// @tparam M  The merging function of a partial result into the total.
+///
+/// @param[in] products  The analysis products.
+/// @param[in] init  The initial value of partial results.
+/// @param[in] fold  The thread-safe folding function.
+/// @param[in] merge  The merging function.
+///
+/// @returns The total result.
+template <typename T, class F, class M>
+T Fold(const Zbdd& products, const T& init, F fold, M merge) {
+  int num_threads = products.settings().num_threads();
+  std::vector<Zbdd::Range> ranges =
+      products.Partition(num_threads > 1 ? num_threads * kRangesPerThread : 1);
+  std::vector<std::future<T>> partials;
+  for (const Zbdd::Range& range : ranges) {
+    partials.push_back(Workers::Spawn(num_threads, [&range, &init, &fold] {
+      T partial = init;
+      for (const std::vector<int>& product : range)
+        fold(product, &partial);
+      return partial;
+    }));
+  }
+  T result = init;
+  for (std::future<T>& partial : partials)
+    merge(partial.get(), &result);
+  return result;
+}
+
+}  // namespace
+
+ProductContainer::ProductContainer(const Zbdd& products,
+                                   const Pdag& graph) noexcept
+    : products_(products), graph_(graph) {
+  Pdag::IndexMap<bool> filter = Fold(
+      products_, Pdag::IndexMap<bool>(graph_.basic_events().size()),
+      [](const std::vector<int>& product, Pdag::IndexMap<bool>* partial) {
+        for (int i : product)
+          (*partial)[std::abs(i)] = true;
+      },
+      [](const Pdag::IndexMap<bool>& partial, Pdag::IndexMap<bool>* result) {
+        auto it = result->begin();
+        for (bool in_product : partial) {
+          if (in_product)
+            *it = true;
+          ++it;
+        }
+      });
+  auto it = filter.begin();
+  for (const mef::BasicEvent* event : graph_.basic_events()) {
+    if (*it++)
+      product_events_.insert(event);
   }
-  return distribution;
+}
+
+std::vector<ProductContainer::Range>
+ProductContainer::Partition(int max_ranges) const {
+  std::vector<Range> ranges;
+  for (const Zbdd::Range& range : products_.Partition(max_ranges))
+    ranges.push_back(Range(range, graph_));
+  return ranges;
+}
+
+std::vector<int> ProductContainer::Distribution() const {
+  return Fold(
+      products_, std::vector<int>(),
+      [](const std::vector<int>& product, std::vector<int>* partial) {
+        int index = product.empty() ? 0 : product.size() - 1;
+        if (partial->size() <= index)
+          partial->resize(index + 1);
+        (*partial)[index]++;
+      },
+      [](const std::vector<int>& partial, std::vector<int>* result) {
+        if (result->size() < partial.size())
+          result->resize(partial.size());
+        for (int i = 0; i < partial.size(); ++i)
+          (*result)[i] += partial[i];
+      });
+}
+
+double ProductContainer::SumProbabilities() const {
+  return Fold(
+      products_, 0.0,
+      [this](const std::vector<int>& product, double* partial) {
+        *partial += Product(product, graph_).p();
+      },
+      [](double partial, double* result) { *result += partial; });
+}
+
+void ProductContainer::VisitByProbability(
+    int buffer_size,
+    const std::function<void(const Product&)>& visitor) const {
+  ProductStore store(buffer_size);
+  for (const std::vector<int>& product : products_)
+    store.Add(product, Product(product, graph_).p());
+  LOG(DEBUG3) << "Sorting " << store.size() << " products with "
+              << store.num_blocks() << " blocks on disk";
+  store.Visit([this, &visitor](const std::vector<int>& product, double) {
+    visitor(Product(product, graph_));
+  });
 }
 
 FaultTreeAnalysis::FaultTreeAnalysis(const mef::Gate& root,
@@ -116,6 +221,25 @@ void FaultTreeAnalysis::Analyze() noexcept {
   LOG(DEBUG2) << "Stored the result for reporting in " << DUR(store_time);
 }
 
+template <>
+const Zbdd& FaultTreeAnalyzer<Bdd>::GenerateProducts(
+    const Pdag* graph) noexcept {
+  if (Analysis::settings().approximation() == Approximation::kBounds &&
+      Analysis::settings().probability_analysis()) {
+    // The truncation of the BDD is guided by the probabilities
+    // at the mission time.
+    Pdag::IndexMap<double> p_vars;
+    p_vars.reserve(graph->basic_events().size());
+    for (const mef::BasicEvent* event : graph->basic_events())
+      p_vars.push_back(event->p());
+    algorithm_ = std::make_unique<Bdd>(graph, Analysis::settings(), p_vars);
+  } else {
+    algorithm_ = std::make_unique<Bdd>(graph, Analysis::settings());
+  }
+  algorithm_->Analyze();
+  return algorithm_->products();
+}
+
 void FaultTreeAnalysis::Store(const Zbdd& products,
                               const Pdag& graph) noexcept {
   // Special cases of sets.
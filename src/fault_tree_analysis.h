@@ -23,6 +23,7 @@
 
 #include <cstdlib>
 
+#include <functional>
 #include <memory>
 #include <unordered_set>
 #include <vector>
@@ -122,24 +123,38 @@ class ProductContainer {
   };
 
  public:
+  /// Disjoint range of products for concurrent processing.
+  class Range {
+    friend class ProductContainer;
+
+   public:
+    /// Begin and end iterators over products in the range.
+    /// @{
+    auto begin() const {
+      return boost::make_transform_iterator(range_.begin(),
+                                            ProductExtractor{graph_});
+    }
+    auto end() const {
+      return boost::make_transform_iterator(range_.end(),
+                                            ProductExtractor{graph_});
+    }
+    /// @}
+
+   private:
+    /// @param[in] range  The range of products with indices.
+    /// @param[in] graph  The host graph.
+    Range(const Zbdd::Range& range, const Pdag& graph) noexcept
+        : range_(range), graph_(graph) {}
+
+    Zbdd::Range range_;  ///< The source range of the analysis results.
+    const Pdag& graph_;  ///< The host graph.
+  };
+
   /// The constructor also collects basic events in products.
   ///
   /// @param[in] products  Sets with indices of events from calculations.
   /// @param[in] graph  PDAG with basic event indices and pointers.
-  ProductContainer(const Zbdd& products, const Pdag& graph) noexcept
-      : products_(products),
-        graph_(graph) {
-    Pdag::IndexMap<bool> filter(graph_.basic_events().size());
-    for (const std::vector<int>& result_set : products_) {
-      for (int i : result_set) {
-        i = std::abs(i);
-        if (filter[i])
-          continue;
-        filter[i] = true;
-        product_events_.insert(graph_.basic_events()[i]);
-      }
-    }
-  }
+  ProductContainer(const Zbdd& products, const Pdag& graph) noexcept;
 
   /// @returns Collection of basic events that are in the products.
   const std::unordered_set<const mef::BasicEvent*>& product_events() const {
@@ -164,9 +179,39 @@ class ProductContainer {
   /// @returns The number of products in the container.
   int size() const { return products_.size(); }
 
+  /// Splits the products into disjoint ranges
+  /// that can be enumerated and processed concurrently.
+  /// The ranges in order make up the same sequence of products
+  /// as the whole container iteration,
+  /// so the merge of the partial results in this order is deterministic.
+  ///
+  /// @param[in] max_ranges  The max number of ranges.
+  ///
+  /// @returns The ranges in the order of the container iteration.
+  std::vector<Range> Partition(int max_ranges) const;
+
   /// @returns The product distribution by order.
   std::vector<int> Distribution() const;
 
+  /// @returns The sum of the product probabilities.
+  ///
+  /// @pre Events are initialized with expressions.
+  double SumProbabilities() const;
+
+  /// Visits products in the descending order of their probabilities.
+  /// The memory for sorting is bounded by the buffer size;
+  /// the rest of the products are sorted out-of-core in temporary files.
+  ///
+  /// @param[in] buffer_size  The max number of products sorted in memory.
+  /// @param[in] visitor  The visitor of products.
+  ///
+  /// @throws IOError  The temporary storage fails.
+  ///
+  /// @pre Events are initialized with expressions.
+  void VisitByProbability(
+      int buffer_size,
+      const std::function<void(const Product&)>& visitor) const;
+
  private:
   const Zbdd& products_;  ///< Container of analysis results.
   const Pdag& graph_;  ///< The analysis graph.
@@ -302,7 +347,7 @@ class FaultTreeAnalyzer : public FaultTreeAnalysis {
 
  private:
   void Preprocess(Pdag* graph) noexcept override {
-    CustomPreprocessor<Algorithm>{graph}();
+    CustomPreprocessor<Algorithm>{graph, Analysis::settings()}();
   }
 
   const Zbdd& GenerateProducts(const Pdag* graph) noexcept override {
@@ -314,6 +359,18 @@ class FaultTreeAnalyzer : public FaultTreeAnalysis {
   std::unique_ptr<Algorithm> algorithm_;  ///< Analysis algorithm.
 };
 
+/// Generates products with the BDD algorithm.
+/// The bounds approximation builds the bounded-width BDD
+/// instead of the exact BDD of the graph,
+/// and the products belong to its upper bound function.
+///
+/// @param[in] graph  The analysis PDAG.
+///
+/// @returns The set of products.
+template <>
+const Zbdd& FaultTreeAnalyzer<Bdd>::GenerateProducts(
+    const Pdag* graph) noexcept;
+
 }  // namespace core
 }  // namespace scram
 
@@ -25,13 +25,17 @@
 
 #include "event.h"
 #include "logger.h"
+#include "parameter.h"
 #include "zbdd.h"
 
 namespace scram {
 namespace core {
 
 ImportanceAnalysis::ImportanceAnalysis(const ProbabilityAnalysis* prob_analysis)
-    : Analysis(prob_analysis->settings()) {}
+    : Analysis(prob_analysis->settings()) {
+  for (const std::pair<double, double>& point : prob_analysis->p_time())
+    times_.push_back(point.second);
+}
 
 void ImportanceAnalysis::Analyze() noexcept {
   CLOCK(imp_time);
@@ -44,24 +48,42 @@ void ImportanceAnalysis::Analyze() noexcept {
   for (int i = 0; i < basic_events.size(); ++i) {
     if (occurrences[i] == 0)
       continue;
-    const mef::BasicEvent& event = *basic_events[i];
-    double p_var = event.p();
-    ImportanceFactors imp{};
-    imp.occurrence = occurrences[i];
-    imp.mif = this->CalculateMif(i);
-    if (p_total != 0) {
-      imp.cif = p_var * imp.mif / p_total;
-      imp.raw = 1 + (1 - p_var) * imp.mif / p_total;
-      imp.dif = p_var * imp.raw;
-      if (p_total != p_var * imp.mif)
-        imp.rrw = p_total / (p_total - p_var * imp.mif);
+    importance_.push_back(
+        {*basic_events[i], CalculateFactors(i, p_total, occurrences[i])});
+  }
+  // The same graph is re-evaluated in the order of the time steps,
+  // so the last evaluation restores the final mission time.
+  for (double time : times_) {
+    ImportanceTimePoint point{time, {}, {}};
+    double p_time = this->UpdateProbabilities(time);
+    for (int i = 0; i < basic_events.size(); ++i) {
+      if (occurrences[i] == 0)
+        continue;
+      point.probabilities.push_back(basic_events[i]->p());
+      point.factors.push_back(CalculateFactors(i, p_time, occurrences[i]));
     }
-    importance_.push_back({event, imp});
+    importance_time_.push_back(std::move(point));
   }
   LOG(DEBUG3) << "Calculated importance factors in " << DUR(imp_time);
   Analysis::AddAnalysisTime(DUR(imp_time));
 }
 
+ImportanceFactors ImportanceAnalysis::CalculateFactors(
+    int index, double p_total, int occurrence) noexcept {
+  double p_var = this->basic_events()[index]->p();
+  ImportanceFactors imp{};
+  imp.occurrence = occurrence;
+  imp.mif = this->CalculateMif(index);
+  if (p_total != 0) {
+    imp.cif = p_var * imp.mif / p_total;
+    imp.raw = 1 + (1 - p_var) * imp.mif / p_total;
+    imp.dif = p_var * imp.raw;
+    if (p_total != p_var * imp.mif)
+      imp.rrw = p_total / (p_total - p_var * imp.mif);
+  }
+  return imp;
+}
+
 std::vector<int> ImportanceAnalyzerBase::occurrences() noexcept {
   Pdag::IndexMap<int> result(prob_analyzer_->graph()->basic_events().size());
   for (const std::vector<int>& product : prob_analyzer_->products()) {
@@ -71,12 +93,20 @@ std::vector<int> ImportanceAnalyzerBase::occurrences() noexcept {
   return result;
 }
 
+double ImportanceAnalyzerBase::UpdateProbabilities(double time) noexcept {
+  prob_analyzer_->mission_time().value(time);
+  auto it_p = p_vars_.begin();
+  for (const mef::BasicEvent* event : prob_analyzer_->graph()->basic_events())
+    *it_p++ = event->p();
+  return this->CalculateTotalProbability();
+}
+
 double ImportanceAnalyzer<Bdd>::CalculateMif(int index) noexcept {
   index += Pdag::kVariableStartIndex;
-  const Bdd::VertexPtr& root = bdd_graph_->root().vertex;
-  if (root->terminal())
+  Bdd::Vertex root = bdd_graph_->root().vertex();
+  if (Bdd::terminal(root))
     return 0;
-  bool original_mark = Ite::Ref(root).mark();
+  bool original_mark = bdd_graph_->ite(root).mark();
 
   int order = bdd_graph_->index_to_order().find(index)->second;
   double mif = CalculateMif(root, order, !original_mark);
@@ -84,17 +114,18 @@ double ImportanceAnalyzer<Bdd>::CalculateMif(int index) noexcept {
   return mif;
 }
 
-double ImportanceAnalyzer<Bdd>::CalculateMif(const Bdd::VertexPtr& vertex,
-                                             int order, bool mark) noexcept {
-  if (vertex->terminal())
+double ImportanceAnalyzer<Bdd>::CalculateMif(Bdd::Vertex vertex, int order,
+                                             bool mark) noexcept {
+  if (Bdd::terminal(vertex))
     return 0;
-  Ite& ite = Ite::Ref(vertex);
+  Bdd::Ite ite = bdd_graph_->ite(vertex);
   if (ite.mark() == mark)
-    return ite.factor();
+    return factors_[vertex];
   ite.mark(mark);
+  double& factor = factors_[vertex];
   if (ite.order() > order) {
     if (!ite.module()) {
-      ite.factor(0);
+      factor = 0;
     } else {  /// @todo Detect if the variable is in the module.
       // The assumption is
       // that the order of a module is always larger
@@ -105,10 +136,10 @@ double ImportanceAnalyzer<Bdd>::CalculateMif(const Bdd::VertexPtr& vertex,
         low = 1 - low;
       const Bdd::Function& res =
           bdd_graph_->modules().find(ite.index())->second;
-      double mif = CalculateMif(res.vertex, order, mark);
-      if (res.complement)
+      double mif = CalculateMif(res.vertex(), order, mark);
+      if (res.complement())
         mif = -mif;
-      ite.factor((high - low) * mif);
+      factor = (high - low) * mif;
     }
   } else if (ite.order() == order) {
     assert(!ite.module() && "A variable can't be a module.");
@@ -116,33 +147,32 @@ double ImportanceAnalyzer<Bdd>::CalculateMif(const Bdd::VertexPtr& vertex,
     double low = RetrieveProbability(ite.low());
     if (ite.complement_edge())
       low = 1 - low;
-    ite.factor(high - low);
+    factor = high - low;
   } else  {
     assert(ite.order() < order);
     double p_var = 0;
     if (ite.module()) {
       const Bdd::Function& res =
           bdd_graph_->modules().find(ite.index())->second;
-      p_var = RetrieveProbability(res.vertex);
-      if (res.complement)
+      p_var = RetrieveProbability(res.vertex());
+      if (res.complement())
         p_var = 1 - p_var;
     } else {
-      p_var = prob_analyzer()->p_vars()[ite.index()];
+      p_var = p_vars()[ite.index()];
     }
     double high = CalculateMif(ite.high(), order, mark);
     double low = CalculateMif(ite.low(), order, mark);
     if (ite.complement_edge())
       low = -low;
-    ite.factor(p_var * high + (1 - p_var) * low);
+    factor = p_var * high + (1 - p_var) * low;
   }
-  return ite.factor();
+  return factor;
 }
 
 double ImportanceAnalyzer<Bdd>::RetrieveProbability(
-    const Bdd::VertexPtr& vertex) noexcept {
-  if (vertex->terminal())
-    return 1;
-  return Ite::Ref(vertex).p();
+    Bdd::Vertex vertex) noexcept {
+  return static_cast<ProbabilityAnalyzer<Bdd>*>(prob_analyzer())
+      ->p_vertex(vertex);
 }
 
 }  // namespace core
@@ -52,6 +52,15 @@ struct ImportanceRecord {
   const ImportanceFactors factors;  ///< The importance factors of the event.
 };
 
+/// Importance factors of events at a point of the mission time.
+struct ImportanceTimePoint {
+  double time;  ///< The mission time.
+  /// The probabilities of the events in the order of the importance records.
+  std::vector<double> probabilities;
+  /// The importance factors in the order of the importance records.
+  std::vector<ImportanceFactors> factors;
+};
+
 class Zbdd;  // The container of products to be queries for important events.
 
 /// Analysis of importance factors of risk model variables.
@@ -79,7 +88,27 @@ class ImportanceAnalysis : public Analysis {
     return importance_;
   }
 
+  /// @returns The importance factors over the mission time
+  ///          at the time steps of the probability analysis.
+  ///          The empty container implies no time steps are requested.
+  ///
+  /// @pre The importance analysis is done.
+  const std::vector<ImportanceTimePoint>& importance_time() const {
+    return importance_time_;
+  }
+
  private:
+  /// Calculates the importance factors of a variable
+  /// with the current probabilities.
+  ///
+  /// @param[in] index  The position index of an event in events vector.
+  /// @param[in] p_total  The current total probability.
+  /// @param[in] occurrence  The number of products with the event.
+  ///
+  /// @returns The importance factors of the event.
+  ImportanceFactors CalculateFactors(int index, double p_total,
+                                     int occurrence) noexcept;
+
   /// @returns Total probability from the probability analysis.
   virtual double p_total() noexcept = 0;
   /// @returns All basic event candidates for importance calculations.
@@ -95,8 +124,20 @@ class ImportanceAnalysis : public Analysis {
   /// @returns Calculated value for MIF.
   virtual double CalculateMif(int index) noexcept = 0;
 
+  /// Re-evaluates the variable probabilities at another mission time
+  /// for the subsequent calculations of importance factors.
+  ///
+  /// @param[in] time  The mission time.
+  ///
+  /// @returns The total probability at the mission time.
+  virtual double UpdateProbabilities(double time) noexcept = 0;
+
   /// Container of important events and their importance factors.
   std::vector<ImportanceRecord> importance_;
+  /// The mission time points with the last at the final mission time.
+  std::vector<double> times_;
+  /// The importance factors over the mission time.
+  std::vector<ImportanceTimePoint> importance_time_;
 };
 
 /// Base class for analyzers of importance factors
@@ -109,7 +150,9 @@ class ImportanceAnalyzerBase : public ImportanceAnalysis {
   ///
   /// @param[in] prob_analyzer  Instantiated probability analyzer.
   explicit ImportanceAnalyzerBase(ProbabilityAnalyzerBase* prob_analyzer)
-      : ImportanceAnalysis(prob_analyzer), prob_analyzer_(prob_analyzer) {}
+      : ImportanceAnalysis(prob_analyzer),
+        prob_analyzer_(prob_analyzer),
+        p_vars_(prob_analyzer->p_vars()) {}
 
  protected:
   virtual ~ImportanceAnalyzerBase() = default;
@@ -117,15 +160,25 @@ class ImportanceAnalyzerBase : public ImportanceAnalysis {
   /// @returns A pointer to the helper probability analyzer.
   ProbabilityAnalyzerBase* prob_analyzer() { return prob_analyzer_; }
 
+  /// @returns The current variable probabilities for calculations.
+  Pdag::IndexMap<double>& p_vars() { return p_vars_; }
+
  private:
   double p_total() noexcept override { return prob_analyzer_->p_total(); }
   const std::vector<const mef::BasicEvent*>& basic_events() noexcept override {
     return prob_analyzer_->graph()->basic_events();
   }
   std::vector<int> occurrences() noexcept override;
+  double UpdateProbabilities(double time) noexcept override;
+
+  /// Calculates the total probability with the current variable probabilities.
+  ///
+  /// @returns The total probability.
+  virtual double CalculateTotalProbability() noexcept = 0;
 
   /// Calculator of the total probability.
   ProbabilityAnalyzerBase* prob_analyzer_;
+  Pdag::IndexMap<double> p_vars_;  ///< A copy of variable probabilities.
 };
 
 /// Analyzer of importance factors
@@ -137,25 +190,26 @@ class ImportanceAnalyzer : public ImportanceAnalyzerBase {
  public:
   /// @copydoc ImportanceAnalyzerBase::ImportanceAnalyzerBase
   explicit ImportanceAnalyzer(ProbabilityAnalyzer<Calculator>* prob_analyzer)
-      : ImportanceAnalyzerBase(prob_analyzer),
-        p_vars_(prob_analyzer->p_vars()) {}
+      : ImportanceAnalyzerBase(prob_analyzer) {}
 
  private:
   double CalculateMif(int index) noexcept override;
-  Pdag::IndexMap<double> p_vars_;  ///< A copy of variable probabilities.
+  double CalculateTotalProbability() noexcept override {
+    return static_cast<ProbabilityAnalyzer<Calculator>*>(prob_analyzer())
+        ->CalculateTotalProbability(p_vars());
+  }
 };
 
 template <class Calculator>
 double ImportanceAnalyzer<Calculator>::CalculateMif(int index) noexcept {
   index += Pdag::kVariableStartIndex;
   auto p_conditional = [index, this](bool state) {
-    p_vars_[index] = state;
-    return static_cast<ProbabilityAnalyzer<Calculator>*>(prob_analyzer())
-        ->CalculateTotalProbability(p_vars_);
+    p_vars()[index] = state;
+    return CalculateTotalProbability();
   };
-  double p_store = p_vars_[index];  // Save the original value for restoring.
+  double p_store = p_vars()[index];  // Save the original value for restoring.
   double mif = p_conditional(true) - p_conditional(false);
-  p_vars_[index] = p_store;  // Restore the probability for next calculation.
+  p_vars()[index] = p_store;  // Restore the probability for next calculation.
   return mif;
 }
 
@@ -170,11 +224,19 @@ class ImportanceAnalyzer<Bdd> : public ImportanceAnalyzerBase {
   /// @param[in] prob_analyzer  Instantiated probability analyzer.
   explicit ImportanceAnalyzer(ProbabilityAnalyzer<Bdd>* prob_analyzer)
       : ImportanceAnalyzerBase(prob_analyzer),
-        bdd_graph_(prob_analyzer->bdd_graph()) {}
+        bdd_graph_(prob_analyzer->bdd_graph()),
+        factors_(bdd_graph_->store_size()) {}
 
  private:
   double CalculateMif(int index) noexcept override;
 
+  /// @note The probabilities of the BDD vertices are updated
+  ///       for the calculations of importance factors.
+  double CalculateTotalProbability() noexcept override {
+    return static_cast<ProbabilityAnalyzer<Bdd>*>(prob_analyzer())
+        ->CalculateTotalProbability(p_vars());
+  }
+
   /// Calculates Marginal Importance Factor of a variable.
   ///
   /// @param[in] vertex  The root vertex of a function graph.
@@ -183,20 +245,20 @@ class ImportanceAnalyzer<Bdd> : public ImportanceAnalyzerBase {
   ///
   /// @returns Importance factor value.
   ///
-  /// @note Probability factor fields are used to save results.
+  /// @note The factors of the vertices are saved as the results.
   /// @note The graph needs cleaning its marks after this function
   ///       because the graph gets continuously-but-partially marked.
-  double CalculateMif(const Bdd::VertexPtr& vertex, int order,
-                      bool mark) noexcept;
+  double CalculateMif(Bdd::Vertex vertex, int order, bool mark) noexcept;
 
   /// Retrieves memorized probability values for BDD function graphs.
   ///
   /// @param[in] vertex  Vertex with calculated probabilities.
   ///
   /// @returns Saved probability value of the vertex.
-  double RetrieveProbability(const Bdd::VertexPtr& vertex) noexcept;
+  double RetrieveProbability(Bdd::Vertex vertex) noexcept;
 
   Bdd* bdd_graph_;  ///< Binary decision diagram for the analyzer.
+  std::vector<double> factors_;  ///< Importance factors of the BDD vertices.
 };
 
 }  // namespace core
@@ -20,11 +20,17 @@
 
 #include "initializer.h"
 
+#include <cerrno>
+#include <cstdlib>
+
+#include <algorithm>
+#include <fstream>
 #include <sstream>
 #include <type_traits>
 
 #include <boost/filesystem.hpp>
 #include <boost/range/algorithm.hpp>
+#include <boost/utility/string_ref.hpp>
 
 #include "cycle.h"
 #include "env.h"
@@ -137,6 +143,90 @@ xmlpp::NodeSet GetNonAttributeElements(const xmlpp::Element* xml_element) {
   return xml_element->find("./*[name() != 'attributes' and name() != 'label']");
 }
 
+/// @returns true if the input file is a flat table of reliability data.
+bool IsTableFile(const std::string& file) {
+  std::string extension = boost::filesystem::path(file).extension().string();
+  return extension == ".csv" || extension == ".tsv";
+}
+
+/// Splits the lines of a delimited table into fields
+/// referencing the table text without copies.
+class TableTokenizer {
+ public:
+  /// @param[in] text  The whole table text.
+  /// @param[in] delimiter  The field separator.
+  TableTokenizer(const std::string& text, char delimiter)
+      : pos_(text.data()),
+        end_(text.data() + text.size()),
+        delimiter_(delimiter) {}
+
+  /// @returns The line number of the last read fields.
+  int line() const { return line_; }
+
+  /// Reads the next line skipping empty and comment lines.
+  ///
+  /// @param[out] fields  The fields of the line without surrounding blanks.
+  ///
+  /// @returns false if the table is exhausted.
+  bool Next(std::vector<boost::string_ref>* fields) {
+    while (pos_ != end_) {
+      ++line_;
+      const char* first = pos_;
+      const char* last = std::find(pos_, end_, '\n');
+      pos_ = last == end_ ? end_ : last + 1;
+      boost::string_ref text = Trim(first, last);
+      if (text.empty() || text.front() == '#')
+        continue;
+      fields->clear();
+      for (first = text.begin();;) {
+        last = std::find(first, text.end(), delimiter_);
+        fields->push_back(Trim(first, last));
+        if (last == text.end())
+          break;
+        first = last + 1;
+      }
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  /// @returns The text range without the leading and trailing blanks.
+  static boost::string_ref Trim(const char* first, const char* last) {
+    auto is_blank = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+    while (first != last && is_blank(*first))
+      ++first;
+    while (last != first && is_blank(last[-1]))
+      --last;
+    return boost::string_ref(first, last - first);
+  }
+
+  const char* pos_;  ///< The start of the next line.
+  const char* end_;  ///< The end of the text.
+  char delimiter_;  ///< The field separator.
+  int line_ = 0;  ///< The current line number.
+};
+
+/// Interprets a table field as a number.
+///
+/// @param[in] field  The field within a null-terminated text.
+/// @param[in] line  The line number for error messages.
+///
+/// @returns The number in the field.
+///
+/// @throws ValidationError  The field is not a number.
+double CastTableField(boost::string_ref field, int line) {
+  char* end = nullptr;
+  errno = 0;
+  double value = std::strtod(field.data(), &end);
+  if (field.empty() || end != field.end() || errno == ERANGE) {
+    throw ValidationError("Line " + std::to_string(line) +
+                          ":\nFailed to interpret '" + field.to_string() +
+                          "' to a number.");
+  }
+  return value;
+}
+
 }  // namespace
 
 Initializer::Initializer(const std::vector<std::string>& xml_files,
@@ -145,6 +235,20 @@ Initializer::Initializer(const std::vector<std::string>& xml_files,
   ProcessInputFiles(xml_files);
 }
 
+Initializer::Initializer(std::shared_ptr<Model> model, core::Settings settings)
+    : model_(std::move(model)), settings_(std::move(settings)) {
+  model_->mission_time().value(settings_.mission_time());
+  CLOCK(valid_time);
+  LOG(DEBUG1) << "Validating the model";
+  ValidateInitialization();
+  LOG(DEBUG1) << "Validation is finished in " << DUR(valid_time);
+
+  CLOCK(setup_time);
+  LOG(DEBUG1) << "Setting up for the analysis";
+  SetupForAnalysis();
+  LOG(DEBUG1) << "Setup time " << DUR(setup_time);
+}
+
 void Initializer::CheckFileExistence(
     const std::vector<std::string>& xml_files) {
   for (auto& xml_file : xml_files) {
@@ -188,11 +292,20 @@ void Initializer::ProcessInputFiles(const std::vector<std::string>& xml_files) {
   LOG(DEBUG1) << "Processing input files";
   CheckFileExistence(xml_files);
   CheckDuplicateFiles(xml_files);
-  for (const auto& xml_file : xml_files) {
+  // The tables go last to be merged into the model from the XML files.
+  std::vector<std::string> input_files(xml_files);
+  std::stable_partition(
+      input_files.begin(), input_files.end(),
+      [](const std::string& file) { return !IsTableFile(file); });
+  for (const auto& input_file : input_files) {
     try {
-      ProcessInputFile(xml_file);
+      if (IsTableFile(input_file)) {
+        ProcessTableFile(input_file);
+      } else {
+        ProcessInputFile(input_file);
+      }
     } catch (ValidationError& err) {
-      err.msg("In file '" + xml_file + "', " + err.msg());
+      err.msg("In file '" + input_file + "', " + err.msg());
       throw;
     }
   }
@@ -341,12 +454,7 @@ void Initializer::ProcessInputFile(const std::string& xml_file) {
   static xmlpp::RelaxNGValidator validator(Env::input_schema());
 
   std::unique_ptr<xmlpp::DomParser> parser = ConstructDomParser(xml_file);
-  try {
-    validator.validate(parser->get_document());
-  } catch (const xmlpp::validity_error&) {
-    throw ValidationError("Document failed schema validation:\n" +
-                          xmlpp::format_xml_error());
-  }
+  ValidateDocument(parser->get_document(), &validator, "Document");
 
   const xmlpp::Node* root = parser->get_document()->get_root_node();
   assert(root->get_name() == "opsa-mef");
@@ -392,6 +500,117 @@ void Initializer::ProcessInputFile(const std::string& xml_file) {
   parsers_.emplace_back(std::move(parser));
 }
 
+void Initializer::ProcessTableFile(const std::string& table_file) {
+  TIMER(DEBUG2, "Reading the reliability data table");
+  std::ifstream in(table_file, std::ios::binary);
+  if (!in.good())
+    throw IOError(table_file + " : Cannot read the table file.");
+  std::string text;
+  in.seekg(0, std::ios::end);
+  text.resize(in.tellg());
+  in.seekg(0, std::ios::beg);
+  in.read(&text[0], text.size());
+  if (!in.good())
+    throw IOError(table_file + " : Cannot read the table file.");
+
+  if (!model_) {  // The table is the only input.
+    model_ = std::make_unique<Model>();
+    model_->mission_time().value(settings_.mission_time());
+  }
+  bool is_tsv = boost::filesystem::path(table_file).extension() == ".tsv";
+  TableTokenizer tokenizer(text, is_tsv ? '\t' : ',');
+  std::vector<boost::string_ref> fields;
+  if (!tokenizer.Next(&fields) || fields.size() < 3 ||
+      fields[0] != "element" || fields[1] != "name" ||
+      fields[2] != "distribution") {
+    throw ValidationError(
+        "The table must start with the element, name, distribution header.");
+  }
+  std::vector<double> args;
+  while (tokenizer.Next(&fields)) {
+    std::string line = "Line " + std::to_string(tokenizer.line()) + ":\n";
+    while (!fields.empty() && fields.back().empty())
+      fields.pop_back();
+    if (fields.size() < 3 || fields[1].empty())
+      throw ValidationError(line + "Missing the element name or distribution.");
+    std::string name = fields[1].to_string();
+    if (name.find_first_of(". ") != std::string::npos)
+      throw ValidationError(line + "The element name is malformed.");
+    args.clear();
+    for (auto it = fields.begin() + 3; it != fields.end(); ++it)
+      args.push_back(CastTableField(*it, tokenizer.line()));
+    try {
+      Expression* expression =
+          GetTableExpression(fields[2].to_string(), args);
+      if (fields[0] == "basic-event") {
+        auto basic_event = std::make_unique<BasicEvent>(std::move(name));
+        basic_event->expression(expression);
+        auto* ref_ptr = basic_event.get();
+        model_->Add(std::move(basic_event));
+        path_basic_events_.insert(ref_ptr);
+      } else if (fields[0] == "parameter") {
+        auto parameter = std::make_unique<Parameter>(std::move(name));
+        parameter->expression(expression);
+        auto* ref_ptr = parameter.get();
+        model_->Add(std::move(parameter));
+        path_parameters_.insert(ref_ptr);
+      } else {
+        throw ValidationError("Unknown element kind '" +
+                              fields[0].to_string() + "'.");
+      }
+    } catch (ValidationError& err) {
+      err.msg(line + err.msg());
+      throw;
+    }
+  }
+}
+
+Expression* Initializer::GetTableExpression(const std::string& distribution,
+                                            const std::vector<double>& args) {
+  auto register_expression = [this](std::unique_ptr<Expression> expression) {
+    auto* ret_ptr = expression.get();
+    model_->Add(std::move(expression));
+    return ret_ptr;
+  };
+  auto check_arity = [&distribution, &args](int min_args, int max_args) {
+    int num_args = args.size();
+    if (num_args < min_args || num_args > max_args) {
+      throw ValidationError("Invalid number of arguments for " + distribution +
+                            ".");
+    }
+  };
+  std::vector<Expression*> arg_expressions;
+  for (double arg : args) {
+    arg_expressions.push_back(
+        register_expression(std::make_unique<ConstantExpression>(arg)));
+  }
+  std::unique_ptr<Expression> expression;
+  if (distribution == "constant") {
+    check_arity(1, 1);
+    return arg_expressions.front();
+  } else if (distribution == "exponential") {
+    check_arity(1, 1);
+    expression = std::make_unique<Exponential>(arg_expressions.front(),
+                                               &model_->mission_time());
+  } else if (distribution == "lognormal") {
+    check_arity(2, 3);
+    if (arg_expressions.size() == 2) {
+      arg_expressions.push_back(
+          register_expression(std::make_unique<ConstantExpression>(0.95)));
+    }
+    expression = std::make_unique<LognormalDeviate>(
+        arg_expressions[0], arg_expressions[1], arg_expressions[2]);
+  } else {
+    throw ValidationError("Unknown distribution '" + distribution + "'.");
+  }
+  try {
+    expression->Validate();
+  } catch (InvalidArgument& err) {
+    throw ValidationError(err.msg());
+  }
+  return register_expression(std::move(expression));
+}
+
 /// Specializations for elements defined after registration.
 /// @{
 template <>
@@ -1299,6 +1518,19 @@ void Initializer::ValidateInitialization() {
     }
   }
 
+  // The end states are reported alongside the sequences.
+  for (const SequencePtr& sequence : model_->sequences()) {
+    if (!sequence->HasAttribute("end-state"))
+      continue;
+    std::string end_state = sequence->end_state();
+    if (end_state.empty() || end_state.find('.') != std::string::npos ||
+        ext::find(model_->sequences(), end_state)) {
+      throw ValidationError("Sequence " + sequence->name() +
+                            " has an invalid end state '" + end_state +
+                            "': The name is malformed or used by a sequence.");
+    }
+  }
+
   // The cycles in links are checked only after ensuring their valid locations.
   cycle::CheckCycle<Link>(links_, "event-tree link");
 
@@ -69,6 +69,16 @@ class Initializer : private boost::noncopyable {
   Initializer(const std::vector<std::string>& xml_files,
               core::Settings settings);
 
+  /// Validates and sets up a model constructed in memory
+  /// with the same semantic checks as the models from input files.
+  ///
+  /// @param[in] model  The model with fully defined constructs.
+  /// @param[in] settings  Analysis settings.
+  ///
+  /// @throws CycleError  The model contains cycles.
+  /// @throws ValidationError  The model contains errors.
+  Initializer(std::shared_ptr<Model> model, core::Settings settings);
+
   /// @returns The model built from the input files.
   std::shared_ptr<Model> model() const { return model_; }
 
@@ -156,6 +166,37 @@ class Initializer : private boost::noncopyable {
   /// @throws IOError  The input file is not accessible.
   void ProcessInputFile(const std::string& xml_file);
 
+  /// Reads a flat table of reliability data
+  /// with definitions of public basic events and parameters.
+  /// The table is tokenized in place
+  /// without the XML parsing and schema validation.
+  ///
+  /// The first line is the header with the element, name, and distribution
+  /// columns followed by the columns of distribution arguments:
+  /// the value for "constant",
+  /// the failure rate for "exponential" over the mission time,
+  /// the mean, error factor, and optional level for "lognormal".
+  /// Empty lines and lines starting with '#' are ignored.
+  ///
+  /// @param[in] table_file  The CSV or TSV (by the extension) input file.
+  ///
+  /// @pre The input file has not been passed before.
+  ///
+  /// @throws ValidationError  The table contains errors.
+  /// @throws IOError  The input file is not accessible.
+  void ProcessTableFile(const std::string& table_file);
+
+  /// Constructs the expression of a table row.
+  ///
+  /// @param[in] distribution  The name of the distribution.
+  /// @param[in] args  The arguments of the distribution.
+  ///
+  /// @returns The registered and validated expression.
+  ///
+  /// @throws ValidationError  The distribution or arguments are invalid.
+  Expression* GetTableExpression(const std::string& distribution,
+                                 const std::vector<double>& args);
+
   /// Processes definitions of elements
   /// that are left to be determined later.
   /// This late definition happens primarily due to unregistered dependencies.
@@ -27,11 +27,124 @@
 
 #include "mocus.h"
 
+#include <cstdint>
+
+#include <algorithm>
+#include <bitset>
+#include <future>
+
+#include <boost/range/algorithm.hpp>
+
 #include "logger.h"
+#include "parallel.h"
 
 namespace scram {
 namespace core {
 
+namespace {
+
+/// Family of cut sets packed into fixed-width bitsets.
+class BitsetFamily {
+ public:
+  using Word = std::uint64_t;  ///< The storage unit of bits.
+  static const int kWordBits = 64;  ///< The number of bits in a word.
+
+  /// @param[in] num_words  The number of words per cut set.
+  explicit BitsetFamily(int num_words) : num_words_(num_words) {}
+
+  /// @returns The number of cut sets in the family.
+  int size() const { return data_.size() / num_words_; }
+
+  /// @returns The words of the cut set at the position.
+  const Word* operator[](int i) const { return &data_[i * num_words_]; }
+
+  /// Adds a cut set with a single element.
+  ///
+  /// @param[in] bit  The position of the element.
+  void AddSingleton(int bit) {
+    data_.resize(data_.size() + num_words_);
+    data_[data_.size() - num_words_ + bit / kWordBits] |=
+        Word(1) << (bit % kWordBits);
+  }
+
+  /// Adds an empty cut set representing Unity.
+  void AddBase() { data_.resize(data_.size() + num_words_); }
+
+  /// Adds all the cut sets from another family.
+  void Append(const BitsetFamily& other) {
+    data_.insert(data_.end(), other.data_.begin(), other.data_.end());
+  }
+
+  /// Computes the cross product of two families.
+  ///
+  /// @param[in] other  The family to multiply with.
+  /// @param[in] limit_order  The limit on the size of resultant cut sets.
+  /// @param[in] max_size  The limit on the number of resultant cut sets.
+  ///
+  /// @returns false if the result grows beyond the size limit.
+  bool Multiply(const BitsetFamily& other, int limit_order, int max_size) {
+    std::vector<Word> result;
+    std::vector<Word> set(num_words_);
+    for (int i = 0; i < size(); ++i) {
+      for (int j = 0; j < other.size(); ++j) {
+        const Word* lhs = (*this)[i];
+        const Word* rhs = other[j];
+        for (int k = 0; k < num_words_; ++k)
+          set[k] = lhs[k] | rhs[k];
+        if (Count(set.data()) > limit_order)
+          continue;
+        if (result.size() == max_size * num_words_)
+          return false;
+        result.insert(result.end(), set.begin(), set.end());
+      }
+    }
+    data_.swap(result);
+    return true;
+  }
+
+  /// Removes duplicate and non-minimal cut sets.
+  void Minimize() {
+    std::vector<std::pair<int, int>> sizes;  // The cut set size and position.
+    for (int i = 0; i < size(); ++i)
+      sizes.emplace_back(Count((*this)[i]), i);
+    boost::sort(sizes);
+    std::vector<Word> result;
+    for (const std::pair<int, int>& entry : sizes) {
+      const Word* set = (*this)[entry.second];
+      auto it = result.cbegin();
+      for (; it != result.cend(); it += num_words_) {
+        if (IsSubset(&*it, set))
+          break;
+      }
+      if (it == result.cend())
+        result.insert(result.end(), set, set + num_words_);
+    }
+    data_.swap(result);
+  }
+
+ private:
+  /// @returns The number of elements in a cut set.
+  int Count(const Word* set) const {
+    int count = 0;
+    for (int i = 0; i < num_words_; ++i)
+      count += std::bitset<kWordBits>(set[i]).count();
+    return count;
+  }
+
+  /// @returns true if the first cut set is a subset of the second.
+  bool IsSubset(const Word* lhs, const Word* rhs) const {
+    Word extra = 0;  // Branch-free to let compilers vectorize the loop.
+    for (int i = 0; i < num_words_; ++i)
+      extra |= lhs[i] & ~rhs[i];
+    return !extra;
+  }
+
+  int num_words_;  ///< The fixed number of words per cut set.
+  std::vector<Word> data_;  ///< Cut sets stored contiguously.
+};
+
+}  // namespace
+
 Mocus::Mocus(const Pdag* graph, const Settings& settings)
     : graph_(graph),
       kSettings_(settings) {
@@ -42,6 +155,7 @@ void Mocus::Analyze() {
   if (graph_->IsTrivial()) {
     LOG(DEBUG2) << "The PDAG is trivial!";
     zbdd_ = std::make_unique<Zbdd>(graph_, kSettings_);
+    zbdd_->Analyze();  // Encodes the trivial products for iteration.
     return;
   }
 
@@ -62,12 +176,16 @@ Mocus::AnalyzeModule(const Gate& gate, const Settings& settings) noexcept {
     for (const Gate::ConstArg<Gate>& arg : args)
       gates.emplace(arg.first, &arg.second);
   };
-  add_gates(gate.args<Gate>());
   const int kMaxVariableIndex =
       Pdag::kVariableStartIndex + graph_->basic_events().size() - 1;
   auto container = std::make_unique<zbdd::CutSetContainer>(
       kSettings_, gate.index(), kMaxVariableIndex);
-  container->Merge(container->ConvertGate(gate));
+  if (AnalyzeDenseModule(gate, settings, container.get(), &gates)) {
+    LOG(DEBUG4) << "Generated cut sets with bitsets.";
+  } else {
+    add_gates(gate.args<Gate>());
+    container->Merge(container->ConvertGate(gate));
+  }
   while (int next_gate_index = container->GetNextGate()) {
     LOG(DEBUG5) << "Expanding gate G" << next_gate_index;
     const Gate* next_gate = gates.find(next_gate_index)->second;
@@ -85,6 +203,10 @@ Mocus::AnalyzeModule(const Gate& gate, const Settings& settings) noexcept {
     container->EliminateComplements();
     container->Minimize();
   }
+  // Sub-modules are independent and may be analyzed concurrently.
+  std::vector<
+      std::pair<int, std::future<std::unique_ptr<zbdd::CutSetContainer>>>>
+      sub_modules;
   for (const auto& entry : container->GatherModules()) {
     int index = entry.first;
     assert(index > 0 && "No complement modules are expected.");
@@ -99,13 +221,125 @@ Mocus::AnalyzeModule(const Gate& gate, const Settings& settings) noexcept {
     }
     Settings adjusted(settings);
     adjusted.limit_order(limit);
-    container->JoinModule(index,
-                          AnalyzeModule(*gates.find(index)->second, adjusted));
+    const Gate* module_gate = gates.find(index)->second;
+    sub_modules.emplace_back(
+        index, Workers::Spawn(kSettings_.num_threads(), [=] {
+          return AnalyzeModule(*module_gate, adjusted);
+        }));
   }
+  for (auto& sub_module : sub_modules)
+    container->JoinModule(sub_module.first, sub_module.second.get());
   container->EliminateConstantModules();
   container->Minimize();
   return container;
 }
 
+bool Mocus::AnalyzeDenseModule(const Gate& gate, const Settings& settings,
+                               zbdd::CutSetContainer* container,
+                               std::unordered_map<int, const Gate*>* modules) {
+  if (!gate.coherent())
+    return false;
+  // Gates of the module in topological order
+  // with the number of their parents within the module.
+  std::vector<const Gate*> gates;
+  std::unordered_map<int, int> num_parents;
+  std::vector<const Node*> elements;  // Variables and sub-modules.
+  std::unordered_map<int, int> positions;  // Element indices to bits.
+  auto add_element = [&elements, &positions](const Node& node) {
+    if (positions.emplace(node.index(), 0).second)
+      elements.push_back(&node);
+  };
+  // Stops as soon as the module is known to be unfit for bitsets.
+  auto gather = [&](const Gate& node, const auto& self) -> bool {
+    if (node.type() != kAnd && node.type() != kOr)
+      return false;
+    for (const Gate::ConstArg<Variable>& arg : node.args<Variable>())
+      add_element(arg.second);
+    for (const Gate::ConstArg<Gate>& arg : node.args<Gate>()) {
+      assert(arg.first > 0 && "Complements must be pushed down to variables.");
+      if (arg.second.module()) {
+        add_element(arg.second);
+        modules->emplace(arg.first, &arg.second);
+      } else if (num_parents[arg.first]++ == 0) {
+        if (!self(arg.second, self))
+          return false;
+      }
+    }
+    if (elements.size() > kMaxDenseVariables)
+      return false;
+    gates.push_back(&node);
+    return true;
+  };
+  if (!gather(gate, gather))
+    return false;
+
+  boost::sort(elements, [](const Node* lhs, const Node* rhs) {
+    return lhs->order() < rhs->order();
+  });
+  for (int i = 0; i < elements.size(); ++i)
+    positions[elements[i]->index()] = i;
+  const int kNumWords = (elements.size() + BitsetFamily::kWordBits - 1) /
+                        BitsetFamily::kWordBits;
+  const int kLimitOrder = settings.limit_order();
+  assert(kLimitOrder > 0 && "Modules with empty cut sets only are expected.");
+
+  std::unordered_map<int, BitsetFamily> families;
+  for (const Gate* node : gates) {
+    std::vector<BitsetFamily> args;
+    auto add_singleton = [&args, &positions, kNumWords](const Node& arg) {
+      args.emplace_back(kNumWords);
+      args.back().AddSingleton(positions.find(arg.index())->second);
+    };
+    for (const Gate::ConstArg<Variable>& arg : node->args<Variable>())
+      add_singleton(arg.second);
+    for (const Gate::ConstArg<Gate>& arg : node->args<Gate>()) {
+      if (arg.second.module()) {
+        add_singleton(arg.second);
+        continue;
+      }
+      auto it = families.find(arg.first);
+      if (--num_parents.find(arg.first)->second) {
+        args.push_back(it->second);
+      } else {
+        args.push_back(std::move(it->second));
+        families.erase(it);
+      }
+    }
+    BitsetFamily family(kNumWords);
+    if (node->type() == kOr) {
+      for (const BitsetFamily& arg : args)
+        family.Append(arg);
+    } else {
+      boost::sort(args, [](const BitsetFamily& lhs, const BitsetFamily& rhs) {
+        return lhs.size() < rhs.size();
+      });
+      family.AddBase();
+      for (const BitsetFamily& arg : args) {
+        if (!family.Multiply(arg, kLimitOrder, kMaxDenseProducts))
+          return false;
+        family.Minimize();
+      }
+    }
+    family.Minimize();
+    if (family.size() > kMaxDenseProducts)
+      return false;
+    families.emplace(node->index(), std::move(family));
+  }
+
+  const BitsetFamily& result = families.find(gate.index())->second;
+  std::vector<std::vector<const Node*>> products(result.size());
+  for (int i = 0; i < result.size(); ++i) {
+    for (int bit = 0; bit < elements.size(); ++bit) {
+      if (result[i][bit / BitsetFamily::kWordBits] &
+          (BitsetFamily::Word(1) << (bit % BitsetFamily::kWordBits)))
+        products[i].push_back(elements[bit]);
+    }
+  }
+  LOG(DEBUG4) << "Dense module with " << elements.size() << " elements and "
+              << result.size() << " cut sets";
+  container->Merge(container->ConvertProducts(std::move(products)));
+  return true;
+}
+
 }  // namespace core
 }  // namespace scram
@@ -72,6 +72,27 @@ class Mocus : private boost::noncopyable {
   std::unique_ptr<zbdd::CutSetContainer>
   AnalyzeModule(const Gate& gate, const Settings& settings) noexcept;
 
+  /// Generates cut sets of a small coherent module
+  /// with packed bitsets over the module variables and sub-modules.
+  ///
+  /// @param[in] gate  The module gate.
+  /// @param[in] settings  Settings for analysis.
+  /// @param[in,out] container  The container to merge the cut sets into.
+  /// @param[out] modules  Sub-module gates found in the module.
+  ///
+  /// @returns false if the module is not suitable for the dense analysis
+  ///          or the number of cut sets grows beyond the dense limits.
+  ///
+  /// @post The container is unchanged if the analysis has failed.
+  bool AnalyzeDenseModule(const Gate& gate, const Settings& settings,
+                          zbdd::CutSetContainer* container,
+                          std::unordered_map<int, const Gate*>* modules);
+
+  /// The max number of module variables and sub-modules for bitset analysis.
+  static const int kMaxDenseVariables = 256;
+  /// The max number of cut sets per gate before falling back to ZBDD.
+  static const int kMaxDenseProducts = 1 << 12;
+
   const Pdag* graph_;  ///< The analysis PDAG.
   const Settings kSettings_;  ///< Analysis settings.
   std::unique_ptr<Zbdd> zbdd_;  ///< ZBDD as a result of analysis.
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2017 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file model_builder.cc
+/// Implementation of the programmatic construction of models.
+
+#include "model_builder.h"
+
+#include <cassert>
+
+#include "error.h"
+#include "initializer.h"
+#include "logger.h"
+
+namespace scram {
+namespace mef {
+
+namespace {
+
+/// Validates a formula with its nested formulas.
+///
+/// @param[in] formula  The formula with all its arguments.
+///
+/// @throws ValidationError  The number of arguments is invalid.
+void ValidateFormula(const Formula& formula) {
+  for (const FormulaPtr& arg : formula.formula_args())
+    ValidateFormula(*arg);
+  formula.Validate();
+}
+
+}  // namespace
+
+ModelBuilder::ModelBuilder(std::string name)
+    : model_(std::make_shared<Model>(std::move(name))) {}
+
+Parameter* ModelBuilder::AddParameter(std::string name,
+                                      Expression* expression) {
+  auto parameter = std::make_unique<Parameter>(std::move(name));
+  auto* ret_ptr = parameter.get();
+  parameter->expression(expression);
+  model_->Add(std::move(parameter));
+  return ret_ptr;
+}
+
+HouseEvent* ModelBuilder::AddHouseEvent(std::string name, bool state) {
+  auto house_event = std::make_unique<HouseEvent>(std::move(name));
+  auto* ret_ptr = house_event.get();
+  house_event->state(state);
+  model_->Add(std::move(house_event));
+  return ret_ptr;
+}
+
+BasicEvent* ModelBuilder::AddBasicEvent(std::string name,
+                                        Expression* expression) {
+  auto basic_event = std::make_unique<BasicEvent>(std::move(name));
+  auto* ret_ptr = basic_event.get();
+  if (expression) {
+    basic_event->expression(expression);
+    basic_event->Validate();
+  }
+  model_->Add(std::move(basic_event));
+  return ret_ptr;
+}
+
+FaultTree* ModelBuilder::AddFaultTree(std::string name) {
+  auto fault_tree = std::make_unique<FaultTree>(std::move(name));
+  auto* ret_ptr = fault_tree.get();
+  model_->Add(std::move(fault_tree));
+  return ret_ptr;
+}
+
+Gate* ModelBuilder::AddGate(std::string name, FaultTree* fault_tree) {
+  auto gate = std::make_unique<Gate>(std::move(name));
+  auto* ret_ptr = gate.get();
+  model_->Add(std::move(gate));
+  fault_tree->Add(ret_ptr);
+  return ret_ptr;
+}
+
+void ModelBuilder::DefineGate(Gate* gate, FormulaPtr formula) {
+  assert(!gate->HasFormula() && "Resetting gate formula");
+  try {
+    ValidateFormula(*formula);
+    gate->formula(std::move(formula));
+    gate->Validate();
+  } catch (ValidationError& err) {
+    err.msg("In gate " + gate->name() + ", " + err.msg());
+    throw;
+  }
+}
+
+void ModelBuilder::DefineCcfGroup(CcfGroup* ccf_group,
+                                  const std::vector<std::string>& members,
+                                  Expression* distribution,
+                                  const std::vector<Expression*>& factors) {
+  for (const std::string& name : members) {
+    auto basic_event = std::make_unique<BasicEvent>(name);
+    ccf_group->AddMember(basic_event.get());
+    model_->Add(std::move(basic_event));
+  }
+  ccf_group->AddDistribution(distribution);
+  for (Expression* factor : factors)
+    ccf_group->AddFactor(factor);
+  ccf_group->Validate();
+}
+
+void ModelBuilder::Validate(Expression* expression) {
+  try {
+    expression->Validate();
+  } catch (InvalidArgument& err) {
+    throw ValidationError(err.msg());
+  }
+}
+
+std::shared_ptr<Model> ModelBuilder::Build(const core::Settings& settings) {
+  TIMER(DEBUG1, "Building the model");
+  for (const GatePtr& gate : model_->gates()) {
+    if (!gate->HasFormula())
+      throw ValidationError("Gate " + gate->name() + " is not defined.");
+  }
+  std::shared_ptr<Model> model = std::move(model_);
+  model_ = std::make_shared<Model>();
+  return Initializer(std::move(model), settings).model();
+}
+
+}  // namespace mef
+}  // namespace scram
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2017 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file model_builder.h
+/// Programmatic construction of analysis models without input files.
+
+#ifndef SCRAM_SRC_MODEL_BUILDER_H_
+#define SCRAM_SRC_MODEL_BUILDER_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "ccf_group.h"
+#include "event.h"
+#include "expression.h"
+#include "fault_tree.h"
+#include "model.h"
+#include "parameter.h"
+#include "settings.h"
+
+namespace scram {
+namespace mef {
+
+/// Builder of models in memory
+/// for tools that generate fault trees programmatically.
+/// The constructs are validated as they are added,
+/// and the finished model gets the same semantic validation and setup
+/// as the models initialized from input files.
+///
+/// The expressions and parameters can only reference
+/// the previously added expressions;
+/// however, gates can be defined in any order after their registration.
+class ModelBuilder : private boost::noncopyable {
+ public:
+  /// @param[in] name  The optional name of the model.
+  explicit ModelBuilder(std::string name = "");
+
+  /// @returns The mission time expression of the model
+  ///          for the time-dependent expressions.
+  ///          Its value is set from the analysis settings upon the build.
+  MissionTime* mission_time() { return &model_->mission_time(); }
+
+  /// Creates and validates an expression owned by the model.
+  ///
+  /// @tparam T  The expression type.
+  /// @tparam Ts  The argument types of the expression constructor.
+  ///
+  /// @param[in] args  The arguments of the expression constructor.
+  ///
+  /// @returns The new expression.
+  ///
+  /// @throws ValidationError  The expression arguments are invalid.
+  template <class T, typename... Ts>
+  Expression* AddExpression(Ts&&... args) {
+    auto expression = std::make_unique<T>(std::forward<Ts>(args)...);
+    auto* ret_ptr = expression.get();
+    model_->Add(std::move(expression));
+    Validate(ret_ptr);
+    return ret_ptr;
+  }
+
+  /// Adds a public model parameter.
+  ///
+  /// @param[in] name  The unique name of the parameter.
+  /// @param[in] expression  The defined expression of the parameter.
+  ///
+  /// @returns The new parameter.
+  ///
+  /// @throws InvalidArgument  The name is malformed.
+  /// @throws ValidationError  The name is already in the model.
+  Parameter* AddParameter(std::string name, Expression* expression);
+
+  /// Adds a public house event.
+  ///
+  /// @param[in] name  The unique name of the event.
+  /// @param[in] state  The Boolean state of the event.
+  ///
+  /// @returns The new house event.
+  ///
+  /// @throws InvalidArgument  The name is malformed.
+  /// @throws ValidationError  The name is already in the model.
+  HouseEvent* AddHouseEvent(std::string name, bool state = false);
+
+  /// Adds a public basic event.
+  ///
+  /// @param[in] name  The unique name of the event.
+  /// @param[in] expression  The optional probability expression.
+  ///
+  /// @returns The new basic event.
+  ///
+  /// @throws InvalidArgument  The name is malformed.
+  /// @throws ValidationError  The name is already in the model,
+  ///                          or the probability expression is invalid.
+  BasicEvent* AddBasicEvent(std::string name,
+                            Expression* expression = nullptr);
+
+  /// Adds a fault tree as a container of gates.
+  ///
+  /// @param[in] name  The unique name of the fault tree.
+  ///
+  /// @returns The new fault tree.
+  ///
+  /// @throws InvalidArgument  The name is malformed.
+  /// @throws ValidationError  The name is already in the model.
+  FaultTree* AddFaultTree(std::string name);
+
+  /// Registers a public gate in a fault tree
+  /// for the definition of its formula later.
+  ///
+  /// @param[in] name  The unique name of the gate.
+  /// @param[in,out] fault_tree  The fault tree of the gate.
+  ///
+  /// @returns The new gate without a formula.
+  ///
+  /// @throws InvalidArgument  The name is malformed.
+  /// @throws ValidationError  The name is already in the model.
+  Gate* AddGate(std::string name, FaultTree* fault_tree);
+
+  /// Defines the Boolean formula of a registered gate.
+  ///
+  /// @param[in,out] gate  The gate without a formula.
+  /// @param[in] formula  The formula over the registered events.
+  ///
+  /// @throws ValidationError  The formula is invalid for its operator.
+  void DefineGate(Gate* gate, FormulaPtr formula);
+
+  /// Adds a common-cause failure group with new basic event members.
+  ///
+  /// @tparam T  The CCF model type, e.g., BetaFactorModel.
+  ///
+  /// @param[in] name  The unique name of the group.
+  /// @param[in] members  The unique names of the new member basic events.
+  /// @param[in] distribution  The probability distribution of the members.
+  /// @param[in] factors  The model factors in the order of levels.
+  ///
+  /// @returns The new CCF group.
+  ///
+  /// @throws InvalidArgument  The names are malformed.
+  /// @throws ValidationError  The names are already in the model,
+  ///                          or the group setup is invalid.
+  template <class T>
+  CcfGroup* AddCcfGroup(std::string name,
+                        const std::vector<std::string>& members,
+                        Expression* distribution,
+                        const std::vector<Expression*>& factors) {
+    auto ccf_group = std::make_unique<T>(std::move(name));
+    auto* ret_ptr = ccf_group.get();
+    model_->Add(std::move(ccf_group));
+    DefineCcfGroup(ret_ptr, members, distribution, factors);
+    return ret_ptr;
+  }
+
+  /// Finishes the model with the final validation and setup for analysis.
+  /// The builder is empty after this call.
+  ///
+  /// @param[in] settings  The analysis settings.
+  ///
+  /// @returns The model ready for analysis.
+  ///
+  /// @throws CycleError  The gates contain cycles.
+  /// @throws ValidationError  Some gates are not defined,
+  ///                          or the model is invalid for the analysis.
+  std::shared_ptr<Model> Build(const core::Settings& settings);
+
+ private:
+  /// Validates the arguments of a new expression.
+  ///
+  /// @param[in] expression  The expression with all its arguments defined.
+  ///
+  /// @throws ValidationError  The expression arguments are invalid.
+  void Validate(Expression* expression);
+
+  /// Adds members, the distribution, and factors into a new CCF group.
+  ///
+  /// @param[in,out] ccf_group  The new CCF group registered in the model.
+  /// @param[in] members  The unique names of the new member basic events.
+  /// @param[in] distribution  The probability distribution of the members.
+  /// @param[in] factors  The model factors in the order of levels.
+  ///
+  /// @throws InvalidArgument  The member names are malformed.
+  /// @throws ValidationError  The group setup is invalid.
+  void DefineCcfGroup(CcfGroup* ccf_group,
+                      const std::vector<std::string>& members,
+                      Expression* distribution,
+                      const std::vector<Expression*>& factors);
+
+  std::shared_ptr<Model> model_;  ///< The model under construction.
+};
+
+}  // namespace mef
+}  // namespace scram
+
+#endif  // SCRAM_SRC_MODEL_BUILDER_H_
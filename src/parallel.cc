@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2017 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file parallel.cc
+/// Implementation of the worker thread budget and task scheduling.
+
+#include "parallel.h"
+
+#include <cassert>
+
+#include <thread>
+
+namespace scram {
+namespace core {
+
+std::atomic<int> Workers::num_workers_(0);
+
+bool Workers::Acquire(int max_workers) noexcept {
+  int busy = num_workers_.load();
+  while (busy < max_workers) {
+    if (num_workers_.compare_exchange_weak(busy, busy + 1))
+      return true;
+  }
+  return false;
+}
+
+thread_local TaskScheduler::Queue* TaskScheduler::queue_ = nullptr;
+
+TaskScheduler::TaskScheduler(int num_threads)
+    : kNumThreads_(num_threads), done_(false) {
+  for (int i = 0; i < kNumThreads_; ++i)
+    queues_.push_back(std::make_unique<Queue>());
+}
+
+void TaskScheduler::Launch(Task* root) noexcept {
+  done_ = false;
+  std::vector<std::future<void>> helpers;
+  for (int i = 1; i < kNumThreads_; ++i)
+    helpers.push_back(Workers::Spawn(kNumThreads_, [this, i] { Help(i); }));
+  Queue* caller_queue = queue_;
+  queue_ = queues_.front().get();
+  root->Run();
+  queue_ = caller_queue;
+  done_.store(true, std::memory_order_release);
+  for (std::future<void>& helper : helpers)
+    helper.get();  // The deferred helpers return immediately.
+}
+
+void TaskScheduler::Help(int worker) noexcept {
+  Queue* caller_queue = queue_;
+  queue_ = queues_[worker].get();
+  while (!done_.load(std::memory_order_acquire)) {
+    if (!Steal())
+      std::this_thread::yield();
+  }
+  queue_ = caller_queue;
+}
+
+void TaskScheduler::Spawn(Task* task) noexcept {
+  assert(queue_ && "Spawning outside of the scheduler.");
+  std::lock_guard<std::mutex> lock(queue_->mutex);
+  queue_->tasks.push_back(task);
+}
+
+void TaskScheduler::Join(Task* task) noexcept {
+  bool stolen = true;
+  {
+    std::lock_guard<std::mutex> lock(queue_->mutex);
+    if (!queue_->tasks.empty() && queue_->tasks.back() == task) {
+      queue_->tasks.pop_back();
+      stolen = false;
+    }
+  }
+  if (!stolen) {
+    task->Run();
+    return;
+  }
+  while (!task->done()) {
+    if (!Steal())
+      std::this_thread::yield();
+  }
+}
+
+bool TaskScheduler::Steal() noexcept {
+  for (const std::unique_ptr<Queue>& victim : queues_) {
+    if (victim.get() == queue_)
+      continue;
+    Task* task = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(victim->mutex);
+      if (victim->tasks.empty())
+        continue;
+      task = victim->tasks.front();
+      victim->tasks.pop_front();
+    }
+    task->Run();
+    return true;
+  }
+  return false;
+}
+
+}  // namespace core
+}  // namespace scram
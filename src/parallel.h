@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2017 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file parallel.h
+/// Fork-join helpers for concurrent analysis of independent sub-problems.
+
+#ifndef SCRAM_SRC_PARALLEL_H_
+#define SCRAM_SRC_PARALLEL_H_
+
+#include <atomic>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+namespace scram {
+namespace core {
+
+/// Process-wide budget of worker threads.
+/// Tasks are launched on a new thread only if the budget allows;
+/// otherwise, the tasks are deferred to run in the joining thread.
+/// The budget is shared by all (nested) spawning sites,
+/// so recursive analyses never exceed the requested number of threads.
+/// The threads are joined with their futures,
+/// so no thread outlives the analysis that spawns it.
+///
+/// @warning The spawned tasks must not share mutable state.
+class Workers {
+ public:
+  /// Launches a task for concurrent evaluation if possible.
+  ///
+  /// @tparam F  The type of the copyable nullary callable task.
+  ///
+  /// @param[in] num_threads  The total number of threads allowed for analysis
+  ///                         including the main thread.
+  /// @param[in] task  The task to run.
+  ///
+  /// @returns The future result of the task.
+  ///          The result must be retrieved to run the deferred tasks.
+  template <class F>
+  static auto Spawn(int num_threads, F&& task) {
+    if (num_threads > 1 && Acquire(num_threads - 1)) {
+      try {
+        return std::async(std::launch::async, [task]() mutable {
+          Release guard;
+          return task();
+        });
+      } catch (const std::system_error&) {  // No resources for a new thread.
+        --num_workers_;
+      }
+    }
+    return std::async(std::launch::deferred, std::forward<F>(task));
+  }
+
+  /// @returns true if no task is running on a worker thread.
+  static bool idle() noexcept { return num_workers_ == 0; }
+
+ private:
+  /// Returns the worker back into the budget upon the task completion.
+  struct Release {
+    ~Release() { --num_workers_; }
+  };
+
+  /// Tries to take a worker from the budget.
+  ///
+  /// @param[in] max_workers  The max number of concurrent workers.
+  ///
+  /// @returns true if the worker is acquired.
+  static bool Acquire(int max_workers) noexcept;
+
+  static std::atomic<int> num_workers_;  ///< The number of busy workers.
+};
+
+
+/// Fork-join scheduler of a recursive computation with work stealing.
+/// The computation starts in the calling thread,
+/// and helper threads are taken from the worker budget for its duration.
+/// Every thread keeps a queue of the tasks it has spawned.
+/// The spawner runs its latest task in place upon joining
+/// unless the task has been stolen from the front of the queue
+/// by an idle thread.
+/// A thread waiting for a stolen task runs other tasks meanwhile.
+///
+/// @warning The tasks must be joined in the reverse order of spawning.
+///          The tasks may run concurrently,
+///          so any shared mutable state must be synchronized by the tasks.
+class TaskScheduler : private boost::noncopyable {
+ public:
+  /// Computation to be run by the scheduler.
+  /// Tasks live on the stack of their spawners until joined.
+  class Task : private boost::noncopyable {
+   public:
+    virtual ~Task() = default;
+
+    /// @returns true if the task has been run.
+    bool done() const { return done_.load(std::memory_order_acquire); }
+
+   protected:
+    Task() : done_(false) {}
+
+   private:
+    friend class TaskScheduler;
+
+    /// Performs the computation of the task.
+    virtual void Execute() noexcept = 0;
+
+    /// Executes the task and publishes the results.
+    void Run() noexcept {
+      Execute();
+      done_.store(true, std::memory_order_release);
+    }
+
+    std::atomic<bool> done_;  ///< The indicator of the complete computation.
+  };
+
+  /// Task with a result value.
+  ///
+  /// @tparam F  The type of the nullary callable
+  ///            returning a default-constructible value.
+  template <class F>
+  class Job : public Task {
+   public:
+    /// @param[in] function  The computation of the result.
+    explicit Job(F function) : function_(std::move(function)) {}
+
+    /// @returns The result of the joined task.
+    const auto& result() const { return result_; }
+
+   private:
+    void Execute() noexcept override { result_ = function_(); }
+
+    F function_;  ///< The computation.
+    std::decay_t<decltype(std::declval<F&>()())> result_;  ///< The result.
+  };
+
+  /// @param[in] num_threads  The total number of threads allowed
+  ///                         including the calling thread.
+  explicit TaskScheduler(int num_threads);
+
+  /// Runs a computation to completion.
+  ///
+  /// @tparam F  The type of the nullary callable.
+  ///
+  /// @param[in] function  The root computation that may spawn tasks.
+  ///
+  /// @returns The result of the computation.
+  template <class F>
+  auto Run(F function) {
+    Job<F> root(std::move(function));
+    Launch(&root);
+    return root.result();
+  }
+
+  /// Makes a task available for other threads.
+  ///
+  /// @param[in] task  The task to be joined by the caller.
+  ///
+  /// @pre The caller runs a task of this scheduler.
+  void Spawn(Task* task) noexcept;
+
+  /// Waits for the completion of a task
+  /// or runs the task in place if no other thread has taken it.
+  ///
+  /// @param[in] task  The latest spawned and not joined task of the caller.
+  ///
+  /// @post The task is done.
+  void Join(Task* task) noexcept;
+
+ private:
+  /// Spawned tasks of a thread.
+  struct Queue {
+    std::mutex mutex;  ///< Guard of the task queue.
+    std::deque<Task*> tasks;  ///< Tasks in the order of spawning.
+  };
+
+  /// Runs the root task with helper threads.
+  ///
+  /// @param[in] root  The computation to start in the calling thread.
+  void Launch(Task* root) noexcept;
+
+  /// Runs tasks of other threads until the root task is complete.
+  ///
+  /// @param[in] worker  The index of the queue of the helper thread.
+  void Help(int worker) noexcept;
+
+  /// Takes the oldest task of another thread and runs it.
+  ///
+  /// @returns false if no task is available for stealing.
+  bool Steal() noexcept;
+
+  const int kNumThreads_;  ///< The max number of threads.
+  std::vector<std::unique_ptr<Queue>> queues_;  ///< The queues of threads.
+  std::atomic<bool> done_;  ///< The root task is complete.
+  static thread_local Queue* queue_;  ///< The queue of the current thread.
+};
+
+}  // namespace core
+}  // namespace scram
+
+#endif  // SCRAM_SRC_PARALLEL_H_
@@ -41,6 +41,7 @@ namespace core {
 void NodeParentManager::AddParent(const GatePtr& gate) {
   assert(!parents_.count(gate->index()) && "Adding an existing parent.");
   parents_.data().emplace_back(gate->index(), gate);
+  Pdag::RevisionTracker()(&gate->graph());
 }
 
 Node::Node(Pdag* graph) noexcept
@@ -70,6 +71,7 @@ void Gate::type(Operator type) {  // Don't use in Gate constructor!
   /// @todo Find the inefficient resets.
   /* assert(type_ != type && "Attribute reset: Operation with no effect."); */
   type_ = type;
+  Pdag::RevisionTracker()(&Node::graph());
   if (type_ == kNull)
     Pdag::NullGateRegistrar()(shared_from_this());
 }
@@ -446,6 +448,7 @@ void Gate::ProcessComplementArg(int index) noexcept {
 
 Pdag::Pdag() noexcept
     : node_index_(0),
+      revision_(0),
       complement_(false),
       coherent_(true),
       normal_(true),
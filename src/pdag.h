@@ -93,10 +93,7 @@ class NodeParentManager : private boost::noncopyable {
   /// @param[in] index  Positive index of the parent gate.
   ///
   /// @pre There is a parent with the given index.
-  void EraseParent(int index) {
-    assert(parents_.count(index) && "No parent with the given index exists.");
-    parents_.erase(index);
-  }
+  void EraseParent(int index);
 
   ParentMap parents_;  ///< All registered parents of this node.
 };
@@ -458,10 +455,7 @@ class Gate : public Node, public std::enable_shared_from_this<Gate> {
   /// @param[in] flag  true for modular gates.
   ///
   /// @pre The gate has already been marked with an opposite flag.
-  void module(bool flag) {
-    assert(module_ != flag);
-    module_ = flag;
-  }
+  void module(bool flag);
 
   /// Helper function to use the sign of the argument.
   ///
@@ -805,6 +799,16 @@ class Pdag : private boost::noncopyable {
     }
   };
 
+  /// Tracker of changes in the structure of the graph.
+  class RevisionTracker {
+    friend class NodeParentManager;  // Changes in the parents of nodes.
+    friend class Gate;  // Changes in the logic and modules of gates.
+    /// Registers a new revision of the graph structure.
+    ///
+    /// @param[in,out] graph  The host graph of the changed node.
+    void operator()(Pdag* graph) const { ++graph->revision_; }
+  };
+
   /// Various kinds of marks applied to the nodes.
   enum NodeMark {
     kGateMark,  ///< General graph traversal (dirty upon traversal end!).
@@ -878,8 +882,16 @@ class Pdag : private boost::noncopyable {
     assert(gate && "The graph cannot be made root-less.");
     assert(this == &gate->graph() && "The gate is from a different graph.");
     root_ = gate;
+    ++revision_;
   }
 
+  /// @returns The revision of the graph structure
+  ///          that changes upon any change in the arguments, logic, or modules
+  ///          of the gates or the root of the graph.
+  ///          Graph analyses can skip recalculations
+  ///          for the same revision of the graph.
+  int revision() const { return revision_; }
+
   /// @returns true if graph = ~root.
   /// @{
   bool complement() const { return complement_; }
@@ -1045,6 +1057,7 @@ class Pdag : private boost::noncopyable {
   void PropagateNullGate(const GatePtr& gate) noexcept;
 
   int node_index_;  ///< Automatic index of the new node.
+  int revision_;  ///< The counter of changes in the graph structure.
   bool complement_;  ///< The indication of a complement graph.
   bool coherent_;  ///< Indication that the graph does not contain negation.
   bool normal_;  ///< Indication for the graph containing only OR and AND gates.
@@ -1138,6 +1151,19 @@ inline void Pdag::Clear<Pdag::kGateMark>() noexcept {
   Clear<Pdag::kGateMark>(root_);
 }
 
+inline void NodeParentManager::EraseParent(int index) {
+  assert(parents_.count(index) && "No parent with the given index exists.");
+  parents_.erase(index);
+  // The parents are managed only by nodes in the same graph.
+  Pdag::RevisionTracker()(&static_cast<Node*>(this)->graph());
+}
+
+inline void Gate::module(bool flag) {
+  assert(module_ != flag);
+  module_ = flag;
+  Pdag::RevisionTracker()(&Node::graph());
+}
+
 /// Prints PDAG nodes in the Aralia format.
 /// @{
 std::ostream& operator<<(std::ostream& os, const Constant& constant);
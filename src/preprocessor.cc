@@ -72,6 +72,7 @@
 
 #include "preprocessor.h"
 
+#include <cstdint>
 #include <cstdlib>
 
 #include <algorithm>
@@ -85,6 +86,7 @@
 #include <boost/range/algorithm.hpp>
 #include <boost/range/algorithm_ext.hpp>
 
+#include "bdd.h"
 #include "ext/algorithm.h"
 #include "ext/find_iterator.h"
 #include "logger.h"
@@ -127,6 +129,189 @@ void TopologicalOrder(Pdag* graph) noexcept {
   topological_order(topological_order, graph->root().get(), 0);
 }
 
+namespace {
+
+/// Assigns the depth-first ordering to nodes of the PDAG.
+///
+/// @tparam F  The strict weak ordering type for gates.
+///
+/// @param[in,out] graph  The graph to be processed.
+/// @param[in] variables_first  Placement of gate variables before sub-gates.
+/// @param[in] comp  The order of visiting sub-gates.
+template <class F>
+void DepthFirstOrder(Pdag* graph, bool variables_first, F comp) noexcept {
+  auto depth_first_order = [variables_first, &comp](auto& self, Gate* root,
+                                                    int order) {
+    if (root->order())
+      return order;
+    auto place_variables = [root, &order] {
+      for (Variable* arg : OrderArguments<Variable>(root)) {
+        if (!arg->order())
+          arg->order(++order);
+      }
+    };
+    if (variables_first)
+      place_variables();
+    std::vector<Gate*> gates = OrderArguments<Gate>(root);
+    std::stable_sort(gates.begin(), gates.end(), comp);
+    for (Gate* arg : gates)
+      order = self(self, arg, order);
+    if (!variables_first)
+      place_variables();
+    assert(!root->constant());
+    root->order(++order);
+    return order;
+  };
+
+  graph->Clear<Pdag::kOrder>();
+  depth_first_order(depth_first_order, graph->root().get(), 0);
+}
+
+}  // namespace
+
+void WeightedDfsOrder(Pdag* graph) noexcept {
+  std::unordered_map<int, double> weights;  // Gate indices and weights.
+  auto weigh = [&weights](auto& self, Gate* gate) -> double {
+    if (auto it = ext::find(weights, gate->index()))
+      return it->second;
+    double weight = 1 + gate->args<Variable>().size();
+    for (const Gate::Arg<Gate>& arg : gate->args<Gate>())
+      weight += self(self, arg.second.get());
+    weights.emplace(gate->index(), weight);
+    return weight;
+  };
+  weigh(weigh, graph->root().get());
+  DepthFirstOrder(graph, /*variables_first=*/false,
+                  [&weights](Gate* lhs, Gate* rhs) {
+                    return weights.find(lhs->index())->second >
+                           weights.find(rhs->index())->second;
+                  });
+}
+
+void FanOutOrder(Pdag* graph) noexcept {
+  // The arguments are already ordered by fan-out.
+  DepthFirstOrder(graph, /*variables_first=*/true,
+                  [](Gate*, Gate*) { return false; });
+}
+
+void ForceOrder(Pdag* graph) noexcept {
+  const int kMaxIterations = 20;  // FORCE usually converges in log(n) steps.
+  TopologicalOrder(graph);  // The initial placement.
+  std::vector<Node*> nodes(graph->root()->order());  // In the initial order.
+  std::vector<std::vector<int>> edges;  // Gates with their arguments.
+  graph->Clear<Pdag::kGateMark>();
+  TraverseGates(graph->root(), [&nodes, &edges](const GatePtr& gate) {
+    std::vector<int> edge = {gate->order() - 1};
+    nodes[edge.front()] = gate.get();
+    for (const Gate::Arg<Gate>& arg : gate->args<Gate>())
+      edge.push_back(arg.second->order() - 1);
+    for (const Gate::Arg<Variable>& arg : gate->args<Variable>()) {
+      edge.push_back(arg.second->order() - 1);
+      nodes[edge.back()] = arg.second.get();
+    }
+    edges.push_back(std::move(edge));
+  });
+  graph->Clear<Pdag::kGateMark>();
+
+  std::vector<int> positions(nodes.size());
+  boost::iota(positions, 0);
+  auto get_span = [&positions, &edges] {
+    std::int64_t span = 0;
+    for (const std::vector<int>& edge : edges) {
+      auto it_range = std::minmax_element(
+          edge.begin(), edge.end(), [&positions](int lhs, int rhs) {
+            return positions[lhs] < positions[rhs];
+          });
+      span += positions[*it_range.second] - positions[*it_range.first];
+    }
+    return span;
+  };
+  std::vector<int> best_positions = positions;
+  std::int64_t best_span = get_span();
+  std::vector<double> forces(nodes.size());
+  std::vector<int> degrees(nodes.size());
+  std::vector<int> ranking(nodes.size());
+  for (int i = 0; i < kMaxIterations; ++i) {
+    boost::fill(forces, 0);
+    boost::fill(degrees, 0);
+    for (const std::vector<int>& edge : edges) {
+      double center = 0;
+      for (int node : edge)
+        center += positions[node];
+      center /= edge.size();
+      for (int node : edge) {
+        forces[node] += center;
+        ++degrees[node];
+      }
+    }
+    for (int node = 0; node < nodes.size(); ++node)
+      forces[node] /= degrees[node];  // Every node belongs to a gate.
+    boost::iota(ranking, 0);
+    boost::sort(ranking, [&forces, &positions](int lhs, int rhs) {
+      if (forces[lhs] != forces[rhs])
+        return forces[lhs] < forces[rhs];
+      return positions[lhs] < positions[rhs];
+    });
+    for (int rank = 0; rank < ranking.size(); ++rank)
+      positions[ranking[rank]] = rank;
+    std::int64_t span = get_span();
+    if (span >= best_span)
+      break;
+    best_span = span;
+    best_positions = positions;
+  }
+  for (int node = 0; node < nodes.size(); ++node)
+    nodes[node]->order(best_positions[node] + 1);
+}
+
+void AssignOrder(Pdag* graph, const Settings& settings) noexcept {
+  auto assign = [graph](VariableOrder heuristic) {
+    switch (heuristic) {
+      case VariableOrder::kTopological:
+        TopologicalOrder(graph);
+        break;
+      case VariableOrder::kForce:
+        ForceOrder(graph);
+        break;
+      case VariableOrder::kWeightedDfs:
+        WeightedDfsOrder(graph);
+        break;
+      case VariableOrder::kFanOut:
+        FanOutOrder(graph);
+        break;
+      case VariableOrder::kBest:
+        assert(false && "The best ordering is not a heuristic.");
+    }
+  };
+  if (settings.variable_order() != VariableOrder::kBest) {
+    assign(settings.variable_order());
+    return;
+  }
+  TIMER(DEBUG3, "Choosing the variable ordering");
+  // The estimates beyond the budget are cut short;
+  // the topological ordering is kept if no heuristic fits the budget.
+  const int kMaxEstimate = 1 << 20;  // Vertices.
+  VariableOrder best = VariableOrder::kTopological;
+  int best_size = kMaxEstimate;
+  for (VariableOrder heuristic :
+       {VariableOrder::kTopological, VariableOrder::kForce,
+        VariableOrder::kWeightedDfs, VariableOrder::kFanOut}) {
+    assign(heuristic);
+    int size = Bdd::EstimateSize(graph, settings, best_size);
+    LOG(DEBUG4) << "BDD size estimate with the "
+                << kVariableOrderToString[static_cast<int>(heuristic)]
+                << " ordering: " << size;
+    if (size < best_size) {
+      best_size = size;
+      best = heuristic;
+    }
+  }
+  LOG(DEBUG3) << "The best variable ordering: "
+              << kVariableOrderToString[static_cast<int>(best)];
+  if (best != VariableOrder::kFanOut)  // Otherwise, already assigned.
+    assign(best);
+}
+
 void MarkCoherence(Pdag* graph) noexcept {
   auto mark_coherence = [](auto& self, const GatePtr& gate) {
     if (gate->mark())
@@ -168,7 +353,8 @@ void MarkCoherence(Pdag* graph) noexcept {
 
 }  // namespace pdag
 
-Preprocessor::Preprocessor(Pdag* graph) noexcept : graph_(graph) {}
+Preprocessor::Preprocessor(Pdag* graph, const Settings& settings) noexcept
+    : graph_(graph), kSettings_(settings) {}
 
 void Preprocessor::operator()() noexcept {
   TIMER(DEBUG2, "Preprocessing");
@@ -339,19 +525,39 @@ void Preprocessor::RunPhaseTwo() noexcept {
   graph_->Log();
   pdag::Transform(graph_,
                   [this](Pdag*) {
-                    while (ProcessMultipleDefinitions())
-                      continue;
+                    RunPass(PreprocessingPass::kMultipleDefinitions,
+                            [this] { return ProcessMultipleDefinitions(); },
+                            /*repeat=*/true);
                   },
                   [this](Pdag*) { DetectModules(); },
                   [this](Pdag*) {
                     while (CoalesceGates(/*common=*/false))
                       continue;
                   },
-                  [this](Pdag*) { MergeCommonArgs(); },
-                  [this](Pdag*) { DetectDistributivity(); },
+                  [this](Pdag*) {
+                    RunPass(PreprocessingPass::kCommonArgs,
+                            [this] { return MergeCommonArgs(); },
+                            /*repeat=*/false);
+                  },
+                  [this](Pdag*) {
+                    RunPass(PreprocessingPass::kDistributivity,
+                            [this] { return DetectDistributivity(); },
+                            /*repeat=*/false);
+                  },
                   [this](Pdag*) { DetectModules(); },
-                  [this](Pdag*) { BooleanOptimization(); },
-                  [this](Pdag*) { DecomposeCommonNodes(); },
+                  [this](Pdag*) {
+                    RunPass(PreprocessingPass::kBooleanOptimization,
+                            [this] {
+                              BooleanOptimization();
+                              return false;
+                            },
+                            /*repeat=*/false);
+                  },
+                  [this](Pdag*) {
+                    RunPass(PreprocessingPass::kDecomposition,
+                            [this] { return DecomposeCommonNodes(); },
+                            /*repeat=*/false);
+                  },
                   [this](Pdag*) { DetectModules(); },
                   [this](Pdag*) {
                     while (CoalesceGates(/*common=*/false))
@@ -426,6 +632,59 @@ void Preprocessor::RunPhaseFive() noexcept {
 
 #undef SANITY_ASSERT
 
+namespace {
+
+/// @returns The number of gates and gate arguments in the graph.
+///
+/// @post Gate marks are clear.
+std::pair<int, int> CountGraph(Pdag* graph) noexcept {
+  std::pair<int, int> size = {0, 0};
+  graph->Clear<Pdag::kGateMark>();
+  TraverseGates(graph->root(), [&size](const GatePtr& gate) {
+    ++size.first;
+    size.second += gate->args().size();
+  });
+  graph->Clear<Pdag::kGateMark>();
+  return size;
+}
+
+}  // namespace
+
+void Preprocessor::RunPass(PreprocessingPass pass,
+                           const std::function<bool()>& step,
+                           bool repeat) noexcept {
+  const char* name = kPreprocessingPassToString[static_cast<int>(pass)];
+  if (!kSettings_.preprocessing_pass(pass)) {
+    LOG(DEBUG3) << "Skipping the disabled pass: " << name;
+    return;
+  }
+  bool log = DEBUG3 <= scram::Logger::report_level();
+  std::pair<int, int> size_before;
+  if (log)
+    size_before = CountGraph(graph_);
+  CLOCK(pass_time);
+  if (kSettings_.pass_budget()) {
+    pass_deadline_ = std::chrono::steady_clock::now() +
+                     std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::duration<double>(
+                             kSettings_.pass_budget()));
+  }
+  int iteration = 0;
+  while (step() && repeat && !Expired() &&
+         ++iteration != kSettings_.pass_iterations()) {
+    continue;
+  }
+  bool expired = Expired();
+  pass_deadline_ = std::chrono::steady_clock::time_point::max();
+  if (!log)
+    return;
+  BLOG(DEBUG3, expired) << "The pass is over its time budget: " << name;
+  std::pair<int, int> size_after = CountGraph(graph_);
+  LOG(DEBUG3) << "Pass " << name << ": gates " << size_before.first << " -> "
+              << size_after.first << ", args " << size_before.second << " -> "
+              << size_after.second << " in " << DUR(pass_time);
+}
+
 namespace {  // Helper functions for all preprocessing algorithms.
 
 /// Detects overlap in ranges.
@@ -801,8 +1060,12 @@ void Preprocessor::DetectMultipleDefinitions(
 }
 
 void Preprocessor::DetectModules() noexcept {
-  TIMER(DEBUG3, "Module detection");
   assert(!graph_->HasNullGates());
+  if (graph_->revision() == module_revision_) {
+    LOG(DEBUG3) << "Module detection is up-to-date with the graph.";
+    return;  // No transformations since the last detection.
+  }
+  TIMER(DEBUG3, "Module detection");
   const GatePtr& root_gate = graph_->root();  // No change in this algorithm.
   // First stage, traverse the graph depth-first for gates
   // and indicate visit time for each node.
@@ -817,6 +1080,7 @@ void Preprocessor::DetectModules() noexcept {
   assert(!root_gate->Revisited());  // Sanity checks.
   assert(root_gate->min_time() == 1);
   assert(root_gate->max_time() == root_gate->ExitTime());
+  module_revision_ = graph_->revision();
 }
 
 int Preprocessor::AssignTiming(int time, const GatePtr& gate) noexcept {
@@ -1127,6 +1391,8 @@ bool Preprocessor::MergeCommonArgs(Operator op) noexcept {
   LOG(DEBUG4) << "Working with " << modules.size() << " modules...";
   bool changed = false;
   for (const auto& module : modules) {
+    if (Expired())
+      break;
     if (module.expired())
       continue;
     GatePtr root = module.lock();
@@ -1528,7 +1794,7 @@ bool Preprocessor::DetectDistributivity() noexcept {
 }
 
 bool Preprocessor::DetectDistributivity(const GatePtr& gate) noexcept {
-  if (gate->mark())
+  if (gate->mark() || Expired())
     return false;
   gate->mark(true);
   assert(!gate->constant());
@@ -1794,10 +2060,16 @@ void Preprocessor::BooleanOptimization() noexcept {
   std::vector<GateWeakPtr> common_gates;
   std::vector<std::weak_ptr<Variable>> common_variables;
   GatherCommonNodes(&common_gates, &common_variables);
-  for (const auto& gate : common_gates)
+  for (const auto& gate : common_gates) {
+    if (Expired())
+      return;
     ProcessCommonNode(gate);
-  for (const auto& var : common_variables)
+  }
+  for (const auto& var : common_variables) {
+    if (Expired())
+      return;
     ProcessCommonNode(var);
+  }
 }
 
 void Preprocessor::GatherCommonNodes(
@@ -2124,15 +2396,16 @@ bool Preprocessor::DecomposeCommonNodes() noexcept {
   // The processing is done deepest-layer-first.
   // The deepest-first processing avoids generating extra parents
   // for the nodes that are deep in the graph.
-  for (auto it = common_gates.rbegin(); it != common_gates.rend(); ++it) {
+  for (auto it = common_gates.rbegin();
+       it != common_gates.rend() && !Expired(); ++it) {
     changed |= DecompositionProcessor()(*it, this);
   }
 
   // Variables are processed after gates
   // because, if parent gates are removed,
   // there may be no need to process these variables.
-  for (auto it = common_variables.rbegin(); it != common_variables.rend();
-       ++it) {
+  for (auto it = common_variables.rbegin();
+       it != common_variables.rend() && !Expired(); ++it) {
     changed |= DecompositionProcessor()(*it, this);
   }
   return changed;
@@ -2383,7 +2656,9 @@ void Preprocessor::GatherNodes(const GatePtr& gate,
 
 void CustomPreprocessor<Bdd>::Run() noexcept {
   Preprocessor::Run();
-  pdag::Transform(graph_, &pdag::MarkCoherence, &pdag::TopologicalOrder);
+  pdag::Transform(graph_, &pdag::MarkCoherence, [this](Pdag* graph) {
+    pdag::AssignOrder(graph, kSettings_);
+  });
 }
 
 void CustomPreprocessor<Zbdd>::Run() noexcept {
@@ -2395,7 +2670,9 @@ void CustomPreprocessor<Zbdd>::Run() noexcept {
                   },
                   [this](Pdag*) { RunPhaseFive(); },
                   &pdag::MarkCoherence,
-                  &pdag::TopologicalOrder);
+                  [this](Pdag* graph) {
+                    pdag::AssignOrder(graph, kSettings_);
+                  });
 }
 
 void CustomPreprocessor<Mocus>::Run() noexcept {
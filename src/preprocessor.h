@@ -22,6 +22,8 @@
 #ifndef SCRAM_SRC_PREPROCESSOR_H_
 #define SCRAM_SRC_PREPROCESSOR_H_
 
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <set>
 #include <unordered_map>
@@ -32,6 +34,7 @@
 #include <boost/unordered_map.hpp>
 
 #include "pdag.h"
+#include "settings.h"
 
 namespace scram {
 namespace core {
@@ -75,6 +78,51 @@ std::vector<T*> OrderArguments(Gate* gate) noexcept;
 /// @post The root and descendant node order marks contain the ordering.
 void TopologicalOrder(Pdag* graph) noexcept;
 
+/// Assigns the ordering to nodes of the PDAG
+/// by the depth-first traversal
+/// that visits heavier sub-graphs
+/// (by the number of nodes counted per path) first.
+///
+/// @param[in,out] graph  The graph to be processed.
+///
+/// @post The root and descendant node order marks contain the ordering.
+void WeightedDfsOrder(Pdag* graph) noexcept;
+
+/// Assigns the ordering to nodes of the PDAG
+/// by the depth-first traversal
+/// that places the variables of a gate before its sub-gates.
+/// Arguments with higher fan-out are placed first.
+///
+/// @param[in,out] graph  The graph to be processed.
+///
+/// @post The root and descendant node order marks contain the ordering.
+void FanOutOrder(Pdag* graph) noexcept;
+
+/// Assigns the ordering to nodes of the PDAG
+/// with the FORCE heuristic.
+/// Starting from the topological ordering,
+/// nodes are iteratively moved to the average center of gravity
+/// of the gates they belong to
+/// as long as the total span of gates decreases.
+///
+/// @param[in,out] graph  The graph to be processed.
+///
+/// @post The root and descendant node order marks contain the ordering.
+void ForceOrder(Pdag* graph) noexcept;
+
+/// Assigns the ordering to nodes of the PDAG
+/// with the heuristic from the analysis settings.
+/// The best ordering is chosen by the size of bounded BDD builds
+/// within a fixed budget of vertices.
+///
+/// @param[in,out] graph  The graph to be processed.
+/// @param[in] settings  The analysis settings.
+///
+/// @pre The graph is normal and marked for coherence.
+///
+/// @post The root and descendant node order marks contain the ordering.
+void AssignOrder(Pdag* graph, const Settings& settings) noexcept;
+
 /// Marks coherence of the whole graph.
 ///
 /// @param[in,out] graph  The graph to be processed.
@@ -94,6 +142,7 @@ class Preprocessor : private boost::noncopyable {
   /// representing a fault tree.
   ///
   /// @param[in] graph  The PDAG to be preprocessed.
+  /// @param[in] settings  The analysis settings with the preprocessing passes.
   ///
   /// @warning There should not be another shared pointer to the root gate
   ///          outside of the passed PDAG.
@@ -103,7 +152,7 @@ class Preprocessor : private boost::noncopyable {
   ///          the destructor will not be called
   ///          as expected by the preprocessing algorithms,
   ///          which will mess the new structure of the PDAG.
-  explicit Preprocessor(Pdag* graph) noexcept;
+  Preprocessor(Pdag* graph, const Settings& settings) noexcept;
 
   virtual ~Preprocessor() = default;
 
@@ -171,6 +220,28 @@ class Preprocessor : private boost::noncopyable {
   /// alternating AND/OR gate layers.
   void RunPhaseFive() noexcept;
 
+  /// Runs an optional preprocessing pass
+  /// within the limits of the analysis settings.
+  /// The reduction of the graph and the time of the pass are logged
+  /// to assess the benefit of the pass.
+  ///
+  /// @param[in] pass  The kind of the pass.
+  /// @param[in] step  One iteration of the pass
+  ///                  returning true if the graph has changed.
+  /// @param[in] repeat  Repetition of the step until the graph stops changing
+  ///                    or the pass reaches the iteration or time limit.
+  void RunPass(PreprocessingPass pass, const std::function<bool()>& step,
+               bool repeat) noexcept;
+
+  /// @returns true if the time budget of the running pass is exhausted.
+  ///
+  /// @note The passes check the budget only between self-contained steps
+  ///       to stop with the graph in a consistent state.
+  bool Expired() const noexcept {
+    return pass_deadline_ != std::chrono::steady_clock::time_point::max() &&
+           std::chrono::steady_clock::now() > pass_deadline_;
+  }
+
   /// Normalizes the gates of the whole PDAG
   /// into OR, AND gates.
   ///
@@ -333,6 +404,8 @@ class Preprocessor : private boost::noncopyable {
   /// Traverses the PDAG to detect modules.
   /// Modules are independent sub-graphs
   /// without common nodes with the rest of the graph.
+  /// The traversal is skipped
+  /// if the graph has not changed since the last detection.
   void DetectModules() noexcept;
 
   /// Traverses the given gate
@@ -999,6 +1072,12 @@ class Preprocessor : private boost::noncopyable {
 
   /// @todo Eliminate the protected data.
   Pdag* graph_;  ///< The PDAG to preprocess.
+  const Settings kSettings_;  ///< The analysis settings.
+  /// The revision of the graph with the last module detection.
+  int module_revision_ = -1;
+  /// The time limit of the running pass.
+  std::chrono::steady_clock::time_point pass_deadline_ =
+      std::chrono::steady_clock::time_point::max();
 };
 
 /// Undefined template class for specialization of Preprocessor
@@ -1014,7 +1093,10 @@ class Bdd;
 template <>
 class CustomPreprocessor<Bdd> : public Preprocessor {
  public:
-  using Preprocessor::Preprocessor;
+  /// @param[in] graph  The PDAG to be preprocessed.
+  /// @param[in] settings  The analysis settings with the ordering heuristic.
+  CustomPreprocessor(Pdag* graph, const Settings& settings) noexcept
+      : Preprocessor(graph, settings) {}
 
  private:
   /// Performs preprocessing for analyses with Binary Decision Diagrams.
@@ -1028,7 +1110,10 @@ class Zbdd;
 template <>
 class CustomPreprocessor<Zbdd> : public Preprocessor {
  public:
-  using Preprocessor::Preprocessor;
+  /// @param[in] graph  The PDAG to be preprocessed.
+  /// @param[in] settings  The analysis settings with the ordering heuristic.
+  CustomPreprocessor(Pdag* graph, const Settings& settings) noexcept
+      : Preprocessor(graph, settings) {}
 
  protected:
   /// Performs preprocessing for analyses
@@ -1044,7 +1129,15 @@ class Mocus;
 template <>
 class CustomPreprocessor<Mocus> : public CustomPreprocessor<Zbdd> {
  public:
-  using CustomPreprocessor<Zbdd>::CustomPreprocessor;
+  /// MOCUS relies on the topological ordering of gates;
+  /// therefore, the variable ordering heuristic of the settings is ignored.
+  ///
+  /// @param[in] graph  The PDAG to be preprocessed.
+  /// @param[in] settings  The analysis settings.
+  CustomPreprocessor(Pdag* graph, const Settings& settings) noexcept
+      : CustomPreprocessor<Zbdd>(
+            graph,
+            Settings(settings).variable_order(VariableOrder::kTopological)) {}
 
  private:
   /// Performs processing of a fault tree
@@ -21,9 +21,12 @@
 
 #include "probability_analysis.h"
 
-#include <boost/range/algorithm/find_if.hpp>
+#include <unordered_map>
+
+#include <boost/range/algorithm.hpp>
 
 #include "event.h"
+#include "ext/find_iterator.h"
 #include "logger.h"
 #include "parameter.h"
 #include "settings.h"
@@ -36,6 +39,7 @@ ProbabilityAnalysis::ProbabilityAnalysis(const FaultTreeAnalysis* fta,
                                          mef::MissionTime* mission_time)
     : Analysis(fta->settings()),
       p_total_(0),
+      p_lower_(0),
       mission_time_(mission_time) {}
 
 void ProbabilityAnalysis::Analyze() noexcept {
@@ -48,6 +52,8 @@ void ProbabilityAnalysis::Analyze() noexcept {
       Analysis::settings().approximation() != Approximation::kNone) {
     Analysis::AddWarning("Probability may have been adjusted to 1.");
   }
+  p_lower_ = this->CalculateLowerBound();
+  assert(p_lower_ >= 0 && p_lower_ <= p_total_ && "Invalid lower bound.");
 
   p_time_ = this->CalculateProbabilityOverTime();
   if (Analysis::settings().safety_integrity_levels())
@@ -190,6 +196,154 @@ double McubCalculator::Calculate(
   return 1 - m;
 }
 
+double InclusionExclusionCalculator::Calculate(
+    const Zbdd& cut_sets,
+    const Pdag::IndexMap<double>& p_vars) noexcept {
+  if (cut_sets_ != &cut_sets)
+    BuildSetGraph(cut_sets);
+  std::unordered_map<int, double> max_results;
+  double lower = CalculateMax(root_, p_vars, &max_results);
+  double upper = 1;
+  double partial_sum = 0;
+  SumTable sums;
+  int max_depth = std::min(kDepth_, num_products_);
+  for (int depth = 1; depth <= max_depth; ++depth) {
+    double term = CalculateSum({{root_, depth}}, p_vars, &sums);
+    if (term == 0) {  // All the deeper intersections are empty as well.
+      lower = upper = std::min(std::max(partial_sum, lower), upper);
+      break;
+    }
+    if (depth % 2) {
+      partial_sum += term;
+      upper = std::min(upper, partial_sum);
+    } else {
+      partial_sum -= term;
+      lower = std::max(lower, partial_sum);
+    }
+  }
+  if (max_depth == num_products_)  // The expansion is complete.
+    lower = upper = std::min(std::max(partial_sum, lower), upper);
+  lower_bound_ = std::min(lower, upper);  // Guard against round-off errors.
+  return upper;
+}
+
+void InclusionExclusionCalculator::BuildSetGraph(
+    const Zbdd& cut_sets) noexcept {
+  std::vector<std::vector<int>> sets;
+  for (const std::vector<int>& cut_set : cut_sets) {
+    sets.push_back(cut_set);
+    boost::sort(sets.back());
+  }
+  boost::sort(sets);
+  nodes_.assign(2, {0, kEmpty, kEmpty});  // The terminals.
+  UniqueTable unique_table;
+  root_ = BuildSetGraph(sets.begin(), sets.end(), 0, &unique_table);
+  num_products_ = sets.size();
+  cut_sets_ = &cut_sets;
+  LOG(DEBUG5) << "The set graph of " << sets.size()
+              << " products has " << nodes_.size() << " nodes";
+}
+
+int InclusionExclusionCalculator::BuildSetGraph(
+    std::vector<std::vector<int>>::const_iterator first,
+    std::vector<std::vector<int>>::const_iterator last,
+    int pos, UniqueTable* unique_table) noexcept {
+  if (first == last)
+    return kEmpty;
+  int result = kEmpty;
+  if (first->size() == pos) {  // The prefix itself is in the family.
+    result = kBase;
+    ++first;
+  }
+  // The sets are grouped by the next variable in the sorted order.
+  std::vector<decltype(first)> bounds;
+  for (auto it = first; it != last; ++it) {
+    if (it == first || (*it)[pos] != (*std::prev(it))[pos])
+      bounds.push_back(it);
+  }
+  bounds.push_back(last);
+  for (int i = bounds.size() - 2; i >= 0; --i) {
+    int index = (*bounds[i])[pos];
+    assert(index > 0 && "Complements in a cut set.");
+    int high = BuildSetGraph(bounds[i], bounds[i + 1], pos + 1, unique_table);
+    int& node = (*unique_table)[{index, high, result}];
+    if (node == kEmpty) {
+      nodes_.push_back({index, high, result});
+      node = nodes_.size() - 1;
+    }
+    result = node;
+  }
+  return result;
+}
+
+double InclusionExclusionCalculator::CalculateSum(
+    std::vector<Group> groups,
+    const Pdag::IndexMap<double>& p_vars,
+    SumTable* sums) noexcept {
+  // Canonical form of the selection.
+  auto it_end = std::remove_if(groups.begin(), groups.end(), [](auto& group) {
+    return group.second == 0 || (group.first == kBase && group.second == 1);
+  });
+  groups.erase(it_end, groups.end());
+  if (groups.empty())
+    return 1;
+  for (const Group& group : groups) {
+    if (group.first == kEmpty || group.first == kBase)
+      return 0;  // Not enough distinct sets to select.
+  }
+  boost::sort(groups);
+  if (auto it = ext::find(*sums, groups))
+    return it->second;
+
+  int index = nodes_[groups.front().first].index;
+  for (const Group& group : groups)
+    index = std::min(index, nodes_[group.first].index);
+  // Selections are split between the sets with and without the variable.
+  double sum = 0;
+  std::vector<Group> next;
+  auto split = [&](int i, bool high, const auto& self) -> void {
+    if (i == groups.size()) {
+      double p = CalculateSum(next, p_vars, sums);
+      sum += high ? p_vars[index] * p : p;
+      return;
+    }
+    const Group& group = groups[i];
+    const SetNode& node = nodes_[group.first];
+    if (node.index != index) {
+      next.push_back(group);
+      self(i + 1, high, self);
+      next.pop_back();
+      return;
+    }
+    for (int num_high = 0; num_high <= group.second; ++num_high) {
+      next.emplace_back(node.high, num_high);
+      next.emplace_back(node.low, group.second - num_high);
+      self(i + 1, high || num_high, self);
+      next.resize(next.size() - 2);
+    }
+  };
+  split(0, false, split);
+  sums->emplace(std::move(groups), sum);
+  return sum;
+}
+
+double InclusionExclusionCalculator::CalculateMax(
+    int node,
+    const Pdag::IndexMap<double>& p_vars,
+    std::unordered_map<int, double>* results) noexcept {
+  if (node == kEmpty || node == kBase)
+    return node == kBase;
+  if (auto it = ext::find(*results, node))
+    return it->second;
+  const SetNode& set_node = nodes_[node];
+  double result =
+      std::max(p_vars[set_node.index] *
+                   CalculateMax(set_node.high, p_vars, results),
+               CalculateMax(set_node.low, p_vars, results));
+  results->emplace(node, result);
+  return result;
+}
+
 void ProbabilityAnalyzerBase::ExtractVariableProbabilities() {
   p_vars_.reserve(graph_->basic_events().size());
   for (const mef::BasicEvent* event : graph_->basic_events())
@@ -227,8 +381,9 @@ ProbabilityAnalyzer<Bdd>::ProbabilityAnalyzer(FaultTreeAnalyzer<Bdd>* fta,
       owner_(false) {
   LOG(DEBUG2) << "Re-using BDD from FaultTreeAnalyzer for ProbabilityAnalyzer";
   bdd_graph_ = fta->algorithm();
-  const Bdd::VertexPtr& root = bdd_graph_->root().vertex;
-  current_mark_ = root->terminal() ? false : Ite::Ref(root).mark();
+  Bdd::Vertex root = bdd_graph_->root().vertex();
+  current_mark_ = Bdd::terminal(root) ? false : bdd_graph_->ite(root).mark();
+  p_vertices_.resize(bdd_graph_->store_size());
 }
 
 ProbabilityAnalyzer<Bdd>::~ProbabilityAnalyzer() noexcept {
@@ -242,8 +397,8 @@ double ProbabilityAnalyzer<Bdd>::CalculateTotalProbability(
   LOG(DEBUG4) << "Calculating probability with BDD...";
   current_mark_ = !current_mark_;
   double prob =
-      CalculateProbability(bdd_graph_->root().vertex, current_mark_, p_vars);
-  if (bdd_graph_->root().complement)
+      CalculateProbability(bdd_graph_->root().vertex(), current_mark_, p_vars);
+  if (bdd_graph_->root().complement())
     prob = 1 - prob;
   LOG(DEBUG4) << "Calculated probability " << prob << " in " << DUR(calc_time);
   return prob;
@@ -259,32 +414,67 @@ void ProbabilityAnalyzer<Bdd>::CreateBdd(
 
   CLOCK(prep_time);  // Overall preprocessing time.
   LOG(DEBUG2) << "Preprocessing...";
-  CustomPreprocessor<Bdd>{&graph}();
+  CustomPreprocessor<Bdd>{&graph, Analysis::settings()}();
   LOG(DEBUG2) << "Finished preprocessing in " << DUR(prep_time);
 
   CLOCK(bdd_time);  // BDD based calculation time.
   LOG(DEBUG2) << "Creating BDD for Probability Analysis...";
-  bdd_graph_ = new Bdd(&graph, Analysis::settings());
+  if (Analysis::settings().approximation() == Approximation::kBounds) {
+    bdd_graph_ = new Bdd(&graph, Analysis::settings(),
+                         ProbabilityAnalyzerBase::p_vars());
+  } else {
+    bdd_graph_ = new Bdd(&graph, Analysis::settings());
+  }
+  p_vertices_.resize(bdd_graph_->store_size());
   LOG(DEBUG2) << "BDD is created in " << DUR(bdd_time);
 
   Analysis::AddAnalysisTime(DUR(total_time));
 }
 
+double ProbabilityAnalyzer<Bdd>::CalculateLowerBound() noexcept {
+  const Bdd::Function& lower = bdd_graph_->lower_root();
+  const Bdd::Function& upper = bdd_graph_->root();
+  if (lower.edge() == upper.edge())
+    return ProbabilityAnalysis::p_total();
+  // The marks of vertices exclusive to the lower bound function
+  // are not kept in sync with the root function traversals.
+  std::unordered_map<Bdd::Vertex, double> probs;
+  auto calculate = [this, &probs](Bdd::Vertex vertex,
+                                  const auto& self) -> double {
+    if (Bdd::terminal(vertex))
+      return 1;
+    if (auto it = ext::find(probs, vertex))
+      return it->second;
+    Bdd::Ite ite = bdd_graph_->ite(vertex);
+    assert(!ite.module() && "Unexpected module in approximate BDD.");
+    double p_var = ProbabilityAnalyzerBase::p_vars()[ite.index()];
+    double high = self(ite.high(), self);
+    double low = self(ite.low(), self);
+    if (ite.complement_edge())
+      low = 1 - low;
+    double p = p_var * high + (1 - p_var) * low;
+    probs.emplace(vertex, p);
+    return p;
+  };
+  double prob = calculate(lower.vertex(), calculate);
+  return lower.complement() ? 1 - prob : prob;
+}
+
 double ProbabilityAnalyzer<Bdd>::CalculateProbability(
-    const Bdd::VertexPtr& vertex,
+    Bdd::Vertex vertex,
     bool mark,
     const Pdag::IndexMap<double>& p_vars) noexcept {
-  if (vertex->terminal())
+  if (Bdd::terminal(vertex))
     return 1;
-  Ite& ite = Ite::Ref(vertex);
+  Bdd::Ite ite = bdd_graph_->ite(vertex);
   if (ite.mark() == mark)
-    return ite.p();
+    return p_vertices_[vertex];
   ite.mark(mark);
   double p_var = 0;
   if (ite.module()) {
     const Bdd::Function& res = bdd_graph_->modules().find(ite.index())->second;
-    p_var = CalculateProbability(res.vertex, mark, p_vars);
-    if (res.complement)
+    p_var = CalculateProbability(res.vertex(), mark, p_vars);
+    if (res.complement())
       p_var = 1 - p_var;
   } else {
     p_var = p_vars[ite.index()];
@@ -293,8 +483,8 @@ double ProbabilityAnalyzer<Bdd>::CalculateProbability(
   double low = CalculateProbability(ite.low(), mark, p_vars);
   if (ite.complement_edge())
     low = 1 - low;
-  ite.p(p_var * high + (1 - p_var) * low);
-  return ite.p();
+  p_vertices_[vertex] = p_var * high + (1 - p_var) * low;
+  return p_vertices_[vertex];
 }
 
 }  // namespace core
@@ -21,9 +21,12 @@
 #ifndef SCRAM_SRC_PROBABILITY_ANALYSIS_H_
 #define SCRAM_SRC_PROBABILITY_ANALYSIS_H_
 
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <boost/functional/hash.hpp>
+
 #include "analysis.h"
 #include "bdd.h"
 #include "fault_tree_analysis.h"
@@ -84,6 +87,13 @@ class ProbabilityAnalysis : public Analysis {
   /// @pre The analysis is done.
   double p_total() const { return p_total_; }
 
+  /// @returns The lower bound of the total probability.
+  ///          The bound is the total probability itself
+  ///          unless the bounds approximation is requested.
+  ///
+  /// @pre The analysis is done.
+  double p_lower() const { return p_lower_; }
+
   /// @returns The probability values over the mission time in time steps.
   ///          The empty container implies no calculation has been done.
   ///
@@ -100,7 +110,6 @@ class ProbabilityAnalysis : public Analysis {
     return *sil_;
   }
 
- protected:
   /// @returns The mission time expression of the model.
   mef::MissionTime& mission_time() { return *mission_time_; }
 
@@ -110,6 +119,14 @@ class ProbabilityAnalysis : public Analysis {
   /// @returns The total probability of the graph or products.
   virtual double CalculateTotalProbability() noexcept = 0;
 
+  /// Calculates the lower bound of the total probability.
+  ///
+  /// @returns The lower bound if the calculator provides it,
+  ///          or the total probability otherwise.
+  ///
+  /// @pre The total probability is calculated.
+  virtual double CalculateLowerBound() noexcept { return p_total_; }
+
   /// Calculates the probability evolution through the mission time.
   ///
   /// @returns The probabilities at time steps.
@@ -120,6 +137,7 @@ class ProbabilityAnalysis : public Analysis {
   void ComputeSil() noexcept;
 
   double p_total_;  ///< Total probability of the top event.
+  double p_lower_;  ///< The lower bound of the total probability.
   mef::MissionTime* mission_time_;  ///< The mission time expression.
   std::vector<std::pair<double, double>> p_time_;  ///< {probability, time}.
   std::unique_ptr<Sil> sil_;  ///< The Safety Integrity Level results.
@@ -182,6 +200,113 @@ class McubCalculator : private CutSetProbabilityCalculator {
                    const Pdag::IndexMap<double>& p_vars) noexcept;
 };
 
+/// Quantitative calculator of probability values
+/// with the truncated inclusion-exclusion (Sylvester-Poincare) expansion.
+/// The partial sums of the expansion alternate around the exact value
+/// and provide the Bonferroni bounds.
+///
+/// The intersection terms are computed over a reduced set graph
+/// of the products with shared sub-families (a ZBDD)
+/// with simultaneous recursion into several branches of the graph
+/// instead of enumeration of all the combinations of products.
+/// The recursion states are selections of graph nodes,
+/// so the work is polynomial in the number of graph nodes
+/// with the degree of the depth.
+/// Families with compact graphs avoid the O(n^k) cost
+/// in the number of products,
+/// but the worst case of unshared graphs is not improved.
+class InclusionExclusionCalculator {
+ public:
+  /// @param[in] depth  The max number of products in intersection terms.
+  explicit InclusionExclusionCalculator(int depth) : kDepth_(depth) {}
+
+  /// Calculates the bounds of the total probability
+  /// with the inclusion-exclusion expansion truncated at the depth.
+  ///
+  /// @param[in] cut_sets  A collection of sets of indices of basic events.
+  /// @param[in] p_vars  Probabilities of events mapped by the variable indices.
+  ///
+  /// @returns The upper bound of the total probability.
+  ///
+  /// @pre The products do not contain complements.
+  /// @pre The collection of products does not change between calls.
+  double Calculate(const Zbdd& cut_sets,
+                   const Pdag::IndexMap<double>& p_vars) noexcept;
+
+  /// @returns The lower bound of the total probability
+  ///          from the last calculation.
+  double lower_bound() const { return lower_bound_; }
+
+ private:
+  /// Node of the set graph with the zero-suppressed semantics.
+  struct SetNode {
+    int index;  ///< The index of the variable.
+    int high;  ///< The sets with the variable.
+    int low;  ///< The sets without the variable.
+  };
+
+  /// Selection of a number of distinct sets from a set graph node.
+  using Group = std::pair<int, int>;
+
+  /// Memoization of the sums of selections by canonical group lists.
+  using SumTable =
+      std::unordered_map<std::vector<Group>, double,
+                         boost::hash<std::vector<Group>>>;
+
+  /// Unique table of the set graph nodes by {index, high, low}.
+  using UniqueTable = std::unordered_map<Triplet, int, boost::hash<Triplet>>;
+
+  /// Builds the shared set graph of the products.
+  ///
+  /// @param[in] cut_sets  A collection of sets of indices of basic events.
+  void BuildSetGraph(const Zbdd& cut_sets) noexcept;
+
+  /// Builds a sub-graph for the sets with a common prefix.
+  /// Equal sub-families of different prefixes share nodes.
+  ///
+  /// @param[in] first  The beginning of the sorted range of sets.
+  /// @param[in] last  The end of the sorted range of sets.
+  /// @param[in] pos  The size of the common prefix.
+  /// @param[in,out] unique_table  The existing nodes of the graph.
+  ///
+  /// @returns The node of the sub-graph.
+  int BuildSetGraph(std::vector<std::vector<int>>::const_iterator first,
+                    std::vector<std::vector<int>>::const_iterator last,
+                    int pos, UniqueTable* unique_table) noexcept;
+
+  /// Calculates the sum of probabilities of the unions of the sets
+  /// over all the selections of distinct sets in groups.
+  ///
+  /// @param[in] groups  The nodes and numbers of sets to select.
+  /// @param[in] p_vars  Probabilities of events mapped by the variable indices.
+  /// @param[in,out] sums  The memoization table.
+  ///
+  /// @returns The sum of the intersection term probabilities.
+  double CalculateSum(std::vector<Group> groups,
+                      const Pdag::IndexMap<double>& p_vars,
+                      SumTable* sums) noexcept;
+
+  /// Calculates the largest probability of a single set.
+  ///
+  /// @param[in] node  The node of the set graph.
+  /// @param[in] p_vars  Probabilities of events mapped by the variable indices.
+  /// @param[in,out] results  The memoization table.
+  ///
+  /// @returns The max probability of the sets in the node.
+  double CalculateMax(int node, const Pdag::IndexMap<double>& p_vars,
+                      std::unordered_map<int, double>* results) noexcept;
+
+  static const int kEmpty = 0;  ///< The node for the empty family.
+  static const int kBase = 1;  ///< The node for the family of the empty set.
+
+  const int kDepth_;  ///< The max number of products in intersections.
+  const Zbdd* cut_sets_ = nullptr;  ///< The source of the set graph.
+  std::vector<SetNode> nodes_;  ///< The set graph with terminals first.
+  int root_ = kEmpty;  ///< The root node of the set graph.
+  int num_products_ = 0;  ///< The number of sets in the graph.
+  double lower_bound_ = 0;  ///< The lower bound from the last calculation.
+};
+
 /// Base class for Probability analyzers.
 class ProbabilityAnalyzerBase : public ProbabilityAnalysis {
  public:
@@ -264,6 +389,31 @@ class ProbabilityAnalyzer : public ProbabilityAnalyzerBase {
   Calculator calc_;  ///< Provider of the calculation logic.
 };
 
+/// Specialization of probability analyzer
+/// with the truncated inclusion-exclusion expansion
+/// configured by the analysis settings.
+template <>
+class ProbabilityAnalyzer<InclusionExclusionCalculator>
+    : public ProbabilityAnalyzerBase {
+ public:
+  /// @copydoc ProbabilityAnalyzerBase::ProbabilityAnalyzerBase
+  template <class Algorithm>
+  ProbabilityAnalyzer(const FaultTreeAnalyzer<Algorithm>* fta,
+                      mef::MissionTime* mission_time)
+      : ProbabilityAnalyzerBase(fta, mission_time),
+        calc_(fta->settings().inclusion_exclusion_depth()) {}
+
+  double CalculateTotalProbability(
+      const Pdag::IndexMap<double>& p_vars) noexcept final {
+    return calc_.Calculate(ProbabilityAnalyzerBase::products(), p_vars);
+  }
+
+ private:
+  double CalculateLowerBound() noexcept final { return calc_.lower_bound(); }
+
+  InclusionExclusionCalculator calc_;  ///< Provider of the calculation logic.
+};
+
 /// Specialization of probability analyzer with Binary Decision Diagrams.
 /// The quantitative analysis is done with BDD.
 template <>
@@ -285,6 +435,7 @@ class ProbabilityAnalyzer<Bdd> : public ProbabilityAnalyzerBase {
   }
 
   /// Reuses BDD structures from Fault tree analyzer.
+  /// The bounded-width approximation BDD is reused as well.
   ///
   /// @copydetails ProbabilityAnalysis::ProbabilityAnalysis
   ///
@@ -302,6 +453,14 @@ class ProbabilityAnalyzer<Bdd> : public ProbabilityAnalyzerBase {
   /// @returns Binary decision diagram used for calculations.
   Bdd* bdd_graph() { return bdd_graph_; }
 
+  /// @param[in] vertex  A vertex of the BDD function graphs.
+  ///
+  /// @returns The probability of the vertex function graph
+  ///          saved by the last calculation of the total probability.
+  double p_vertex(Bdd::Vertex vertex) const {
+    return Bdd::terminal(vertex) ? 1 : p_vertices_[vertex];
+  }
+
   double CalculateTotalProbability(
       const Pdag::IndexMap<double>& p_vars) noexcept final;
 
@@ -313,6 +472,11 @@ class ProbabilityAnalyzer<Bdd> : public ProbabilityAnalyzerBase {
   /// @pre The function is called in the constructor only once.
   void CreateBdd(const FaultTreeAnalysis& fta) noexcept;
 
+  /// Calculates the probability of the lower bound function of the BDD.
+  ///
+  /// @returns The lower bound of the total probability.
+  double CalculateLowerBound() noexcept final;
+
   /// Calculates exact probability
   /// of a function graph represented by its root BDD vertex.
   ///
@@ -325,10 +489,11 @@ class ProbabilityAnalyzer<Bdd> : public ProbabilityAnalyzerBase {
   ///
   /// @warning If a vertex is already marked with the input mark,
   ///          it will not be traversed and updated with a probability value.
-  double CalculateProbability(const Bdd::VertexPtr& vertex, bool mark,
+  double CalculateProbability(Bdd::Vertex vertex, bool mark,
                               const Pdag::IndexMap<double>& p_vars) noexcept;
 
   Bdd* bdd_graph_;  ///< The main BDD graph for analysis.
+  std::vector<double> p_vertices_;  ///< Probabilities of the BDD vertices.
   bool current_mark_;  ///< To keep track of BDD current mark.
   bool owner_;  ///< Indication that pointers are handles.
 };
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2017 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file product_store.cc
+/// Implementation of the out-of-core product storage.
+
+#include "product_store.h"
+
+#include <cassert>
+#include <cstdint>
+
+#include <fstream>
+#include <queue>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/range/algorithm.hpp>
+
+#include "error.h"
+#include "logger.h"
+
+namespace fs = boost::filesystem;
+
+namespace scram {
+namespace core {
+
+namespace {
+
+/// Writes a signed integer in the zigzag variable-length encoding.
+///
+/// @param[in] value  The integer to encode.
+/// @param[in,out] out  The destination binary stream.
+void WriteVarint(int value, std::ostream* out) {
+  std::uint32_t code = (static_cast<std::uint32_t>(value) << 1) ^
+                       static_cast<std::uint32_t>(value >> 31);
+  for (; code >= 0x80; code >>= 7)
+    out->put(static_cast<char>(code | 0x80));
+  out->put(static_cast<char>(code));
+}
+
+/// Reads a signed integer in the zigzag variable-length encoding.
+///
+/// @param[in,out] in  The source binary stream.
+/// @param[out] value  The decoded integer.
+///
+/// @returns false if the stream is exhausted.
+bool ReadVarint(std::istream* in, int* value) {
+  std::uint32_t code = 0;
+  for (int shift = 0;; shift += 7) {
+    int byte = in->get();
+    if (byte == std::char_traits<char>::eof())
+      return false;
+    code |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      break;
+  }
+  *value = static_cast<int>(code >> 1) ^ -static_cast<int>(code & 1);
+  return true;
+}
+
+/// Writes a product entry with the delta-encoded literal indices.
+///
+/// @param[in] product  The literal indices of the product.
+/// @param[in] p  The probability of the product.
+/// @param[in,out] out  The destination binary stream.
+void WriteEntry(const std::vector<int>& product, double p, std::ostream* out) {
+  out->write(reinterpret_cast<const char*>(&p), sizeof(p));
+  WriteVarint(product.size(), out);
+  int prev = 0;
+  for (int index : product) {
+    WriteVarint(index - prev, out);
+    prev = index;
+  }
+}
+
+/// Reads a product entry written with WriteEntry.
+///
+/// @param[in,out] in  The source binary stream.
+/// @param[out] product  The literal indices of the product.
+/// @param[out] p  The probability of the product.
+///
+/// @returns false if the stream is exhausted.
+///
+/// @throws IOError  The entry is truncated.
+bool ReadEntry(std::istream* in, std::vector<int>* product, double* p) {
+  if (!in->read(reinterpret_cast<char*>(p), sizeof(*p)))
+    return false;
+  int size = 0;
+  if (!ReadVarint(in, &size))
+    throw IOError("Truncated product block.");
+  product->resize(size);
+  int prev = 0;
+  for (int& index : *product) {
+    if (!ReadVarint(in, &index))
+      throw IOError("Truncated product block.");
+    index += prev;
+    prev = index;
+  }
+  return true;
+}
+
+}  // namespace
+
+ProductStore::ProductStore(int buffer_size) : kBufferSize_(buffer_size) {
+  assert(kBufferSize_ > 0 && "The store needs some memory.");
+}
+
+ProductStore::~ProductStore() noexcept {
+  if (directory_.empty())
+    return;
+  boost::system::error_code ec;
+  fs::remove_all(directory_, ec);
+  if (ec)
+    LOG(WARNING) << "Failed to remove " << directory_ << ": " << ec.message();
+}
+
+void ProductStore::Add(const std::vector<int>& product, double p) {
+  if (buffer_.size() == kBufferSize_)
+    Spill();
+  buffer_.push_back({p, product});
+  ++size_;
+}
+
+void ProductStore::Spill() {
+  TIMER(DEBUG5, "Spilling a block of products");
+  boost::sort(buffer_);
+  try {
+    if (directory_.empty()) {
+      directory_ =
+          fs::temp_directory_path() / fs::unique_path("scram-%%%%-%%%%-%%%%");
+      fs::create_directories(directory_);
+    }
+  } catch (const fs::filesystem_error& err) {
+    throw IOError(std::string("Cannot create a directory for products: ") +
+                  err.what());
+  }
+  WriteBlock([this](const Visitor& visitor) {
+    for (const Entry& entry : buffer_)
+      visitor(entry.product, entry.p);
+  });
+  buffer_.clear();
+  if (blocks_.size() < kMaxBlocks_)
+    return;
+  // Compaction of the blocks into one to limit the number of open files.
+  std::vector<fs::path> blocks;
+  blocks.swap(blocks_);
+  WriteBlock([this, &blocks](const Visitor& visitor) {
+    Merge(blocks, /*with_buffer=*/false, visitor);
+  });
+  for (const fs::path& block : blocks)
+    fs::remove(block);
+}
+
+void ProductStore::WriteBlock(
+    const std::function<void(const Visitor&)>& generator) {
+  fs::path block = directory_ / ("block-" + std::to_string(num_files_++));
+  std::ofstream out(block.string(), std::ios::binary);
+  generator([&out](const std::vector<int>& product, double p) {
+    WriteEntry(product, p, &out);
+  });
+  out.close();
+  if (!out.good())
+    throw IOError(block.string() + " : Cannot write the product block.");
+  blocks_.push_back(std::move(block));
+}
+
+void ProductStore::Visit(const Visitor& visitor) {
+  boost::sort(buffer_);
+  Merge(blocks_, /*with_buffer=*/true, visitor);
+}
+
+void ProductStore::Merge(const std::vector<fs::path>& blocks, bool with_buffer,
+                         const Visitor& visitor) {
+  // The current entries of the sources with the buffer as the last source.
+  std::vector<Entry> heads(blocks.size() + with_buffer);
+  std::vector<std::ifstream> streams;
+  int buffer_pos = 0;
+  auto next = [&](int source) {
+    Entry* head = &heads[source];
+    if (source == streams.size()) {
+      if (buffer_pos == buffer_.size())
+        return false;
+      *head = buffer_[buffer_pos++];
+      return true;
+    }
+    return ReadEntry(&streams[source], &head->product, &head->p);
+  };
+  auto later = [&heads](int lhs, int rhs) { return heads[rhs] < heads[lhs]; };
+  std::priority_queue<int, std::vector<int>, decltype(later)> queue(later);
+
+  for (const fs::path& block : blocks) {
+    streams.emplace_back(block.string(), std::ios::binary);
+    if (!streams.back().good())
+      throw IOError(block.string() + " : Cannot read the product block.");
+  }
+  for (int i = 0; i < heads.size(); ++i) {
+    if (next(i))
+      queue.push(i);
+  }
+  while (!queue.empty()) {
+    int source = queue.top();
+    queue.pop();
+    visitor(heads[source].product, heads[source].p);
+    if (next(source))
+      queue.push(source);
+  }
+}
+
+}  // namespace core
+}  // namespace scram
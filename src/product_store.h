@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2017 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file product_store.h
+/// Out-of-core storage of products ordered by probability.
+
+#ifndef SCRAM_SRC_PRODUCT_STORE_H_
+#define SCRAM_SRC_PRODUCT_STORE_H_
+
+#include <functional>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+
+namespace scram {
+namespace core {
+
+/// Storage of products for traversal in the descending order of probability
+/// with the memory use bounded by the buffer size.
+/// Upon overflow, the buffer is sorted
+/// and spilled as a block into a temporary file
+/// with delta-encoded variable-length product indices.
+/// The blocks are merged back on the fly during the traversal.
+class ProductStore {
+ public:
+  /// The visitor of products with their probabilities.
+  using Visitor = std::function<void(const std::vector<int>&, double)>;
+
+  /// @param[in] buffer_size  The max number of products kept in memory.
+  explicit ProductStore(int buffer_size);
+
+  ProductStore(const ProductStore&) = delete;
+  ProductStore& operator=(const ProductStore&) = delete;
+
+  /// Removes the temporary files of the spilled blocks.
+  ~ProductStore() noexcept;
+
+  /// @returns The number of products in the store.
+  int size() const { return size_; }
+
+  /// @returns The number of blocks spilled to disk.
+  int num_blocks() const { return blocks_.size(); }
+
+  /// Puts a product into the store.
+  ///
+  /// @param[in] product  The indices of the product literals.
+  /// @param[in] p  The probability of the product.
+  ///
+  /// @throws IOError  The temporary block cannot be written.
+  void Add(const std::vector<int>& product, double p);
+
+  /// Visits all the products in the descending order of probability.
+  /// Equally probable products are visited in the lexicographical order.
+  ///
+  /// @param[in] visitor  The visitor of products.
+  ///
+  /// @throws IOError  The temporary blocks cannot be read.
+  void Visit(const Visitor& visitor);
+
+ private:
+  /// A product with its probability.
+  struct Entry {
+    /// @returns true if this entry must be visited before the other.
+    bool operator<(const Entry& other) const {
+      return p > other.p || (p == other.p && product < other.product);
+    }
+
+    double p;  ///< The probability of the product.
+    std::vector<int> product;  ///< The literal indices.
+  };
+
+  /// Sorts and writes the buffer into a new temporary block.
+  /// The blocks are compacted into one upon reaching the max number.
+  ///
+  /// @throws IOError  The block cannot be written.
+  void Spill();
+
+  /// Writes a new temporary block.
+  ///
+  /// @param[in] generator  The provider of sorted entries to a visitor.
+  ///
+  /// @throws IOError  The block cannot be written.
+  void WriteBlock(const std::function<void(const Visitor&)>& generator);
+
+  /// Merges sorted sources of entries.
+  ///
+  /// @param[in] blocks  The sorted blocks on disk.
+  /// @param[in] with_buffer  Inclusion of the sorted buffer into the merge.
+  /// @param[in] visitor  The receiver of the merged entries.
+  ///
+  /// @throws IOError  The blocks cannot be read.
+  void Merge(const std::vector<boost::filesystem::path>& blocks,
+             bool with_buffer, const Visitor& visitor);
+
+  static const int kMaxBlocks_ = 64;  ///< The max number of files to merge.
+
+  const int kBufferSize_;  ///< The max number of entries in memory.
+  int size_ = 0;  ///< The total number of products.
+  int num_files_ = 0;  ///< The number of created block files.
+  std::vector<Entry> buffer_;  ///< The entries not yet spilled.
+  boost::filesystem::path directory_;  ///< The directory for blocks.
+  std::vector<boost::filesystem::path> blocks_;  ///< The spilled blocks.
+};
+
+}  // namespace core
+}  // namespace scram
+
+#endif  // SCRAM_SRC_PRODUCT_STORE_H_
@@ -22,6 +22,6 @@
 
 namespace scram {
 
-std::mt19937 Random::rng_;
+thread_local std::mt19937 Random::rng_;
 
 }  // namespace scram
@@ -247,7 +247,9 @@ class Random {
   }
 
  private:
-  static std::mt19937 rng_;  ///< The random number generator.
+  /// The random number generator of the analysis thread.
+  /// Concurrent analyses in the same process have independent streams.
+  static thread_local std::mt19937 rng_;
 };
 
 }  // namespace scram
@@ -20,8 +20,15 @@
 
 #include "reporter.h"
 
+#include <cassert>
+
 #include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
 #include <ostream>
+#include <set>
+#include <sstream>
 #include <utility>
 #include <vector>
 
@@ -31,11 +38,14 @@
 #include <boost/range/adaptor/transformed.hpp>
 
 #include "ccf_group.h"
+#include "checkpoint.h"
 #include "element.h"
+#include "env.h"
 #include "error.h"
 #include "logger.h"
 #include "parameter.h"
 #include "version.h"
+#include "xml.h"
 
 namespace scram {
 
@@ -57,6 +67,83 @@ void PutId(const core::RiskAnalysis::Result::Id& id, XmlStreamElement* report) {
   boost::apply_visitor(extractor, id);
 }
 
+/// Escapes the XML markup characters in text for streaming.
+std::string EscapeXml(const std::string& text) {
+  std::string escaped;
+  escaped.reserve(text.size());
+  for (char c : text) {
+    switch (c) {
+      case '&':
+        escaped += "&amp;";
+        break;
+      case '<':
+        escaped += "&lt;";
+        break;
+      case '>':
+        escaped += "&gt;";
+        break;
+      case '"':
+        escaped += "&quot;";
+        break;
+      default:
+        escaped += c;
+    }
+  }
+  return escaped;
+}
+
+/// Streams the DOM element data into the XML stream element.
+/// The names are kept in a pool to outlive the streaming.
+class DomStreamer {
+ public:
+  /// Puts the attributes, text, and children of the DOM element.
+  ///
+  /// @param[in] element  The source DOM element.
+  /// @param[in,out] streamer  The destination for the same element.
+  void Stream(const xmlpp::Element* element, XmlStreamElement* streamer) {
+    for (const xmlpp::Attribute* attribute : element->get_attributes())
+      streamer->SetAttribute(Intern(attribute->get_name()),
+                             EscapeXml(attribute->get_value()));
+    StreamContent(element, streamer);
+  }
+
+  /// Puts the text and children of the DOM element.
+  ///
+  /// @param[in] element  The source DOM element.
+  /// @param[in,out] streamer  The destination for the same element.
+  void StreamContent(const xmlpp::Element* element,
+                     XmlStreamElement* streamer) {
+    auto children = element->find("./*");
+    if (children.empty()) {
+      if (const xmlpp::TextNode* text = element->get_child_text()) {
+        std::string content = GetContent(text);
+        if (!content.empty())
+          streamer->AddText(EscapeXml(content));
+      }
+      return;
+    }
+    for (const xmlpp::Node* node : children)
+      StreamChild(XmlElement(node), streamer);
+  }
+
+  /// Puts the DOM element as a child.
+  ///
+  /// @param[in] element  The source DOM element.
+  /// @param[in,out] parent  The destination for the parent element.
+  void StreamChild(const xmlpp::Element* element, XmlStreamElement* parent) {
+    XmlStreamElement child = parent->AddChild(Intern(element->get_name()));
+    Stream(element, &child);
+  }
+
+  /// @returns The stable C string for a name.
+  const char* Intern(const std::string& name) {
+    return names_.insert(name).first->c_str();
+  }
+
+ private:
+  std::set<std::string> names_;  ///< The pool of element and attribute names.
+};
+
 }  // namespace
 
 void Reporter::Report(const core::RiskAnalysis& risk_an, std::ostream& out) {
@@ -75,29 +162,157 @@ void Reporter::Report(const core::RiskAnalysis& risk_an, std::ostream& out) {
     }
   }
 
-  for (const core::RiskAnalysis::Result& result : risk_an.results()) {
-    if (result.fault_tree_analysis)
-      ReportResults(result.id, *result.fault_tree_analysis,
-                    result.probability_analysis.get(), &results);
+  for (const core::RiskAnalysis::Result& result : risk_an.results())
+    ReportResults(result, &results);
+}
 
-    if (result.probability_analysis)
-      ReportResults(result.id, *result.probability_analysis, &results);
+void Reporter::Report(const core::RiskAnalysis& risk_an,
+                      const std::string& file) {
+  std::ofstream of(file.c_str());
+  if (!of.good())
+    throw IOError(file + " : Cannot write the output file.");
 
-    if (result.importance_analysis)
-      ReportResults(result.id, *result.importance_analysis, &results);
+  Report(risk_an, of);
+}
 
-    if (result.uncertainty_analysis)
-      ReportResults(result.id, *result.uncertainty_analysis, &results);
+void Reporter::ReportTarget(const core::RiskAnalysis::Result& result,
+                            XmlStreamElement* target) {
+  assert(!result.restored && "Only analyzed targets are reported.");
+  scram::PutId(result.id, target);
+  if (!result.warning.empty())
+    target->SetAttribute("warning", EscapeXml(result.warning));
+  if (result.probability_analysis) {
+    // The probability is restored into the analysis without loss.
+    std::ostringstream probability;
+    probability.precision(std::numeric_limits<double>::max_digits10);
+    probability << result.probability_analysis->p_total();
+    target->SetAttribute("probability", probability.str());
   }
+  ReportCalculationTime(result, target);
+  ReportResults(result, target);
 }
 
-void Reporter::Report(const core::RiskAnalysis& risk_an,
-                      const std::string& file) {
+void Reporter::Merge(const std::vector<std::string>& shard_reports,
+                     std::ostream& out) {
+  static xmlpp::RelaxNGValidator validator(Env::report_schema());
+
+  // The parsers of the shard reports ordered by the shard index.
+  std::map<int, std::unique_ptr<xmlpp::DomParser>> shards;
+  int num_shards = 0;
+  for (const std::string& file : shard_reports) {
+    std::unique_ptr<xmlpp::DomParser> parser = ConstructDomParser(file);
+    ValidateDocument(parser->get_document(), &validator, "Report XML");
+    auto shard =
+        parser->get_document()->get_root_node()->find("./information/shard");
+    if (shard.empty())
+      throw ValidationError(file + " : The report is not of a shard.");
+    const xmlpp::Element* element = XmlElement(shard.front());
+    int index = CastAttributeValue<int>(element, "index");
+    int count = CastAttributeValue<int>(element, "count");
+    if (num_shards && count != num_shards)
+      throw ValidationError(file + " : Inconsistent number of shards.");
+    num_shards = count;
+    if (!shards.emplace(index, std::move(parser)).second)
+      throw ValidationError(file + " : Duplicate shard " +
+                            std::to_string(index) + ".");
+  }
+  if (shards.empty() || static_cast<int>(shards.size()) != num_shards ||
+      shards.begin()->first != 1 || shards.rbegin()->first != num_shards) {
+    throw ValidationError("Missing shard reports: " +
+                          std::to_string(shards.size()) + " of " +
+                          std::to_string(num_shards) + " are given.");
+  }
+  std::vector<const xmlpp::Element*> roots;
+  for (const auto& shard : shards)
+    roots.push_back(shard.second->get_document()->get_root_node());
+
+  TIMER(DEBUG1, "Merging shard reports");
+  DomStreamer streamer;
+  out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+  XmlStreamElement report("report", out);
+  {
+    // The model information is common for all the shards.
+    XmlStreamElement information = report.AddChild("information");
+    for (const xmlpp::Node* node : roots.front()->find("./information/*")) {
+      const xmlpp::Element* element = XmlElement(node);
+      std::string name = element->get_name();
+      if (name == "shard" || name == "performance" || name == "warning")
+        continue;
+      streamer.StreamChild(element, &information);
+      if (name != "time")
+        continue;
+      std::vector<const xmlpp::Node*> times;
+      for (const xmlpp::Element* root : roots) {
+        for (const xmlpp::Node* time :
+             root->find("./information/performance/calculation-time"))
+          times.push_back(time);
+      }
+      if (times.empty())
+        continue;
+      XmlStreamElement performance = information.AddChild("performance");
+      for (const xmlpp::Node* time : times)
+        streamer.StreamChild(XmlElement(time), &performance);
+    }
+    // The warnings about the targets are only in the shards of the targets.
+    std::set<std::string> warnings;  // The model warnings are in every shard.
+    for (const xmlpp::Element* root : roots) {
+      for (const xmlpp::Node* node : root->find("./information/warning")) {
+        const xmlpp::Element* warning = XmlElement(node);
+        if (warnings.insert(GetContent(warning->get_child_text())).second)
+          streamer.StreamChild(warning, &information);
+      }
+    }
+  }
+  // The initiating events are merged by the name
+  // because their sequences may be split between the shards.
+  std::vector<std::string> initiating_events;
+  std::map<std::string, std::vector<const xmlpp::Node*>> sequences;
+  std::map<std::string, std::vector<const xmlpp::Node*>> end_states;
+  std::vector<const xmlpp::Node*> results;
+  for (const xmlpp::Element* root : roots) {
+    for (const xmlpp::Node* node : root->find("./results/*")) {
+      const xmlpp::Element* element = XmlElement(node);
+      if (element->get_name() != "initiating-event") {
+        results.push_back(node);
+        continue;
+      }
+      std::string name = GetAttributeValue(element, "name");
+      auto it = sequences.find(name);
+      if (it == sequences.end()) {
+        initiating_events.push_back(name);
+        it = sequences.emplace(name, std::vector<const xmlpp::Node*>()).first;
+      }
+      for (const xmlpp::Node* sequence : element->find("./sequence"))
+        it->second.push_back(sequence);
+      for (const xmlpp::Node* end_state : element->find("./end-state"))
+        end_states[name].push_back(end_state);
+    }
+  }
+  if (initiating_events.empty() && results.empty())
+    return;
+  XmlStreamElement results_element = report.AddChild("results");
+  for (const std::string& name : initiating_events) {
+    const std::vector<const xmlpp::Node*>& event_sequences = sequences[name];
+    XmlStreamElement initiating_event =
+        results_element.AddChild("initiating-event");
+    initiating_event.SetAttribute("name", name)
+        .SetAttribute("sequences", event_sequences.size());
+    for (const xmlpp::Node* sequence : event_sequences)
+      streamer.StreamChild(XmlElement(sequence), &initiating_event);
+    for (const xmlpp::Node* end_state : end_states[name])
+      streamer.StreamChild(XmlElement(end_state), &initiating_event);
+  }
+  for (const xmlpp::Node* node : results)
+    streamer.StreamChild(XmlElement(node), &results_element);
+}
+
+void Reporter::Merge(const std::vector<std::string>& shard_reports,
+                     const std::string& file) {
   std::ofstream of(file.c_str());
   if (!of.good())
     throw IOError(file + " : Cannot write the output file.");
 
-  Report(risk_an, of);
+  Merge(shard_reports, of);
 }
 
 /// Describes the fault tree analysis and techniques.
@@ -159,6 +374,12 @@ void Reporter::ReportCalculatedQuantity<core::ProbabilityAnalysis>(
       break;
     case core::Approximation::kMcub:
       methods.SetAttribute("name", "MCUB Approximation");
+      break;
+    case core::Approximation::kBounds:
+      methods.SetAttribute("name", "Bounded-Width Binary Decision Diagram");
+      break;
+    case core::Approximation::kInclusionExclusion:
+      methods.SetAttribute("name", "Truncated Inclusion-Exclusion");
   }
   XmlStreamElement limits = methods.AddChild("limits");
   limits.AddChild("mission-time").AddText(settings.mission_time());
@@ -224,6 +445,11 @@ void Reporter::ReportInformation(const core::RiskAnalysis& risk_an,
                                  XmlStreamElement* report) {
   XmlStreamElement information = report->AddChild("information");
   ReportSoftwareInformation(&information);
+  if (risk_an.settings().num_shards() > 1) {
+    information.AddChild("shard")
+        .SetAttribute("index", risk_an.settings().shard_index())
+        .SetAttribute("count", risk_an.settings().num_shards());
+  }
   ReportPerformance(risk_an, &information);
   ReportCalculatedQuantity(risk_an.settings(), &information);
   ReportModelFeatures(risk_an.model(), &information);
@@ -248,6 +474,10 @@ void Reporter::ReportInformation(const core::RiskAnalysis& risk_an,
     ReportUnusedElements(event_tree->functional_events(),
                          header + "unused functional events: ", &information);
   }
+  for (const core::RiskAnalysis::Result& result : risk_an.results()) {
+    if (!result.warning.empty())
+      information.AddChild("warning").AddText(result.warning);
+  }
 }
 
 void Reporter::ReportSoftwareInformation(XmlStreamElement* information) {
@@ -295,25 +525,66 @@ void Reporter::ReportPerformance(const core::RiskAnalysis& risk_an,
     return;
   // Setup for performance information.
   XmlStreamElement performance = information->AddChild("performance");
-  for (const core::RiskAnalysis::Result& result : risk_an.results()) {
-    XmlStreamElement calc_time = performance.AddChild("calculation-time");
-    scram::PutId(result.id, &calc_time);
-    if (result.fault_tree_analysis)
-      calc_time.AddChild("products")
-          .AddText(result.fault_tree_analysis->analysis_time());
-
-    if (result.probability_analysis)
-      calc_time.AddChild("probability")
-          .AddText(result.probability_analysis->analysis_time());
+  for (const core::RiskAnalysis::Result& result : risk_an.results())
+    ReportCalculationTime(result, &performance);
+}
 
-    if (result.importance_analysis)
-      calc_time.AddChild("importance")
-          .AddText(result.importance_analysis->analysis_time());
+void Reporter::ReportCalculationTime(const core::RiskAnalysis::Result& result,
+                                     XmlStreamElement* performance) {
+  if (result.restored) {
+    assert(checkpoint_ && "Restored results without the checkpoint.");
+    const xmlpp::Element* target = checkpoint_->Find(result.id);
+    assert(target && "Missing restored target.");
+    DomStreamer streamer;
+    for (const xmlpp::Node* node : target->find("./calculation-time"))
+      streamer.StreamChild(XmlElement(node), performance);
+    return;
+  }
+  XmlStreamElement calc_time = performance->AddChild("calculation-time");
+  scram::PutId(result.id, &calc_time);
+  if (result.fault_tree_analysis)
+    calc_time.AddChild("products")
+        .AddText(result.fault_tree_analysis->analysis_time());
+
+  if (result.probability_analysis)
+    calc_time.AddChild("probability")
+        .AddText(result.probability_analysis->analysis_time());
+
+  if (result.importance_analysis)
+    calc_time.AddChild("importance")
+        .AddText(result.importance_analysis->analysis_time());
+
+  if (result.uncertainty_analysis)
+    calc_time.AddChild("uncertainty")
+        .AddText(result.uncertainty_analysis->analysis_time());
+}
 
-    if (result.uncertainty_analysis)
-      calc_time.AddChild("uncertainty")
-          .AddText(result.uncertainty_analysis->analysis_time());
+void Reporter::ReportResults(const core::RiskAnalysis::Result& result,
+                             XmlStreamElement* results) {
+  if (result.restored) {
+    assert(checkpoint_ && "Restored results without the checkpoint.");
+    const xmlpp::Element* target = checkpoint_->Find(result.id);
+    assert(target && "Missing restored target.");
+    DomStreamer streamer;
+    for (const xmlpp::Node* node : target->find("./*")) {
+      const xmlpp::Element* element = XmlElement(node);
+      if (element->get_name() != "calculation-time")
+        streamer.StreamChild(element, results);
+    }
+    return;
   }
+  if (result.fault_tree_analysis)
+    ReportResults(result.id, *result.fault_tree_analysis,
+                  result.probability_analysis.get(), results);
+
+  if (result.probability_analysis)
+    ReportResults(result.id, *result.probability_analysis, results);
+
+  if (result.importance_analysis)
+    ReportResults(result.id, *result.importance_analysis, results);
+
+  if (result.uncertainty_analysis)
+    ReportResults(result.id, *result.uncertainty_analysis, results);
 }
 
 template <class T>
@@ -342,6 +613,12 @@ void Reporter::ReportResults(const core::EventTreeAnalysis& eta,
         .SetAttribute("name", result_sequence.sequence.name())
         .SetAttribute("value", result_sequence.p_sequence);
   }
+  for (const core::EventTreeAnalysis::Result& result_end_state :
+       eta.end_states()) {
+    initiating_event.AddChild("end-state")
+        .SetAttribute("name", result_end_state.sequence.name())
+        .SetAttribute("value", result_end_state.p_sequence);
+  }
 }
 
 void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
@@ -362,8 +639,16 @@ void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
       .SetAttribute("basic-events", fta.products().product_events().size())
       .SetAttribute("products", fta.products().size());
 
-  if (prob_analysis)
+  if (prob_analysis) {
     sum_of_products.SetAttribute("probability", prob_analysis->p_total());
+    core::Approximation approximation =
+        prob_analysis->settings().approximation();
+    if (approximation == core::Approximation::kBounds ||
+        approximation == core::Approximation::kInclusionExclusion) {
+      sum_of_products.SetAttribute("probability-lower-bound",
+                                   prob_analysis->p_lower());
+    }
+  }
 
   if (fta.products().empty() == false) {
     sum_of_products.SetAttribute(
@@ -374,12 +659,9 @@ void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
                     " "));
   }
 
-  double sum = 0;  // Sum of probabilities for contribution calculations.
-  if (prob_analysis) {
-    for (const core::Product& product_set : fta.products())
-      sum += product_set.p();
-  }
-  for (const core::Product& product_set : fta.products()) {
+  // Sum of probabilities for contribution calculations.
+  double sum = prob_analysis ? fta.products().SumProbabilities() : 0;
+  auto report_product = [&](const core::Product& product_set) {
     XmlStreamElement product = sum_of_products.AddChild("product");
     product.SetAttribute("order", product_set.order());
     if (prob_analysis) {
@@ -391,6 +673,13 @@ void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
     for (const core::Literal& literal : product_set) {
       ReportLiteral(literal, &product);
     }
+  };
+  if (prob_analysis && fta.settings().sort_products()) {
+    fta.products().VisitByProbability(fta.settings().product_buffer(),
+                                      report_product);
+  } else {
+    for (const core::Product& product_set : fta.products())
+      report_product(product_set);
   }
 }
 
@@ -440,33 +729,80 @@ void Reporter::ReportResults(
     const core::RiskAnalysis::Result::Id& id,
     const core::ImportanceAnalysis& importance_analysis,
     XmlStreamElement* results) {
-  XmlStreamElement importance = results->AddChild("importance");
-  scram::PutId(id, &importance);
-  if (!importance_analysis.warnings().empty()) {
-    importance.SetAttribute("warning", importance_analysis.warnings());
-  }
-  importance.SetAttribute("basic-events",
-                          importance_analysis.importance().size());
-
-  for (const core::ImportanceRecord& entry : importance_analysis.importance()) {
-    const core::ImportanceFactors& factors = entry.factors;
-    const mef::BasicEvent& event = entry.event;
-    auto add_data = [&event, &factors](XmlStreamElement* element) {
-      element->SetAttribute("occurrence", factors.occurrence)
-          .SetAttribute("probability", event.p())
-          .SetAttribute("MIF", factors.mif)
-          .SetAttribute("CIF", factors.cif)
-          .SetAttribute("DIF", factors.dif)
-          .SetAttribute("RAW", factors.raw)
-          .SetAttribute("RRW", factors.rrw);
-    };
-    ReportBasicEvent(event, &importance, add_data);
+  const std::vector<core::ImportanceRecord>& records =
+      importance_analysis.importance();
+  // The time point is null for the results at the final mission time.
+  auto report_importance = [this, &id, &importance_analysis, &records,
+                            results](const core::ImportanceTimePoint* point) {
+    XmlStreamElement importance = results->AddChild("importance");
+    scram::PutId(id, &importance);
+    if (!point && !importance_analysis.warnings().empty()) {
+      importance.SetAttribute("warning", importance_analysis.warnings());
+    }
+    if (point)
+      importance.SetAttribute("mission-time", point->time);
+    importance.SetAttribute("basic-events", records.size());
+
+    for (int i = 0; i < records.size(); ++i) {
+      const core::ImportanceFactors& factors =
+          point ? point->factors[i] : records[i].factors;
+      const mef::BasicEvent& event = records[i].event;
+      double p_var = point ? point->probabilities[i] : event.p();
+      auto add_data = [&factors, p_var](XmlStreamElement* element) {
+        element->SetAttribute("occurrence", factors.occurrence)
+            .SetAttribute("probability", p_var)
+            .SetAttribute("MIF", factors.mif)
+            .SetAttribute("CIF", factors.cif)
+            .SetAttribute("DIF", factors.dif)
+            .SetAttribute("RAW", factors.raw)
+            .SetAttribute("RRW", factors.rrw);
+      };
+      ReportBasicEvent(event, &importance, add_data);
+    }
+  };
+
+  report_importance(nullptr);
+  for (const core::ImportanceTimePoint& point :
+       importance_analysis.importance_time()) {
+    report_importance(&point);
   }
 }
 
 void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
                              const core::UncertaintyAnalysis& uncert_analysis,
                              XmlStreamElement* results) {
+  if (!uncert_analysis.p_time().empty()) {
+    {
+      XmlStreamElement curve = results->AddChild("curve");
+      scram::PutId(id, &curve);
+      curve.SetAttribute("description", "Mean probability over time")
+          .SetAttribute("X-title", "Mission time")
+          .SetAttribute("Y-title", "Mean probability")
+          .SetAttribute("X-unit", "hours");
+      for (const auto& point : uncert_analysis.p_time()) {
+        curve.AddChild("point")
+            .SetAttribute("X", point.time)
+            .SetAttribute("Y", point.mean);
+      }
+    }
+    XmlStreamElement curve = results->AddChild("curve");
+    scram::PutId(id, &curve);
+    curve.SetAttribute("description", "Probability quantiles over time")
+        .SetAttribute("X-title", "Mission time")
+        .SetAttribute("Y-title", "Probability")
+        .SetAttribute("Z-title", "Quantile")
+        .SetAttribute("X-unit", "hours");
+    for (const auto& point : uncert_analysis.p_time()) {
+      double delta = 1.0 / point.quantiles.size();
+      for (int i = 0; i < point.quantiles.size(); ++i) {
+        curve.AddChild("point")
+            .SetAttribute("X", point.time)
+            .SetAttribute("Y", point.quantiles[i])
+            .SetAttribute("Z", delta * (i + 1));
+      }
+    }
+  }
+
   XmlStreamElement measure = results->AddChild("measure");
   scram::PutId(id, &measure);
   if (!uncert_analysis.warnings().empty()) {
@@ -23,6 +23,7 @@
 
 #include <iosfwd>
 #include <string>
+#include <vector>
 
 #include "event.h"
 #include "fault_tree_analysis.h"
@@ -36,9 +37,16 @@
 
 namespace scram {
 
+class Checkpoint;  // Restored results of analysis targets.
+
 /// Facilities to report analysis results.
 class Reporter {
  public:
+  Reporter() = default;
+
+  /// @param[in] checkpoint  The source of the restored target results.
+  explicit Reporter(const Checkpoint* checkpoint) : checkpoint_(checkpoint) {}
+
   /// Reports the results of risk analysis on a model.
   /// The XML report is formed as a single document.
   ///
@@ -58,6 +66,35 @@ class Reporter {
   /// @throws IOError  The output file is not accessible.
   void Report(const core::RiskAnalysis& risk_an, const std::string& file);
 
+  /// Reports the calculation time and results of a single analysis target
+  /// as a standalone XML fragment to be restored later.
+  ///
+  /// @param[in] result  The completed analysis of the target.
+  /// @param[in,out] target  The root element of the fragment.
+  void ReportTarget(const core::RiskAnalysis::Result& result,
+                    XmlStreamElement* target);
+
+  /// Merges the partial reports of all the shards of analysis targets
+  /// into a single report
+  /// with the same order of results as the report of the full analysis.
+  ///
+  /// @param[in] shard_reports  The report files of the shards in any order.
+  /// @param[out] out  The report destination stream.
+  ///
+  /// @throws ValidationError  The reports are invalid or incomplete.
+  void Merge(const std::vector<std::string>& shard_reports, std::ostream& out);
+
+  /// A convenience function to merge the reports into a file.
+  /// This function overwrites the file.
+  ///
+  /// @param[in] shard_reports  The report files of the shards in any order.
+  /// @param[out] file  The output destination.
+  ///
+  /// @throws ValidationError  The reports are invalid or incomplete.
+  /// @throws IOError  The output file is not accessible.
+  void Merge(const std::vector<std::string>& shard_reports,
+             const std::string& file);
+
  private:
   /// This function populates information
   /// about the software, settings, time, methods, model, etc.
@@ -98,6 +135,20 @@ class Reporter {
   void ReportPerformance(const core::RiskAnalysis& risk_an,
                          XmlStreamElement* information);
 
+  /// Reports the performance metrics of the analysis of a single target.
+  ///
+  /// @param[in] result  The analysis of the target.
+  /// @param[in,out] performance  The XML element to append the results.
+  void ReportCalculationTime(const core::RiskAnalysis::Result& result,
+                             XmlStreamElement* performance);
+
+  /// Reports the results of a single analysis target.
+  ///
+  /// @param[in] result  The analysis of the target.
+  /// @param[in,out] results  XML element to for all results.
+  void ReportResults(const core::RiskAnalysis::Result& result,
+                     XmlStreamElement* results);
+
   /// Reports unused elements
   /// as warnings of the top information level.
   ///
@@ -183,6 +234,8 @@ class Reporter {
   template <class T>
   void ReportBasicEvent(const mef::BasicEvent& basic_event,
                         XmlStreamElement* parent, const T& add_data);
+
+  const Checkpoint* checkpoint_ = nullptr;  ///< Optional restored targets.
 };
 
 }  // namespace scram
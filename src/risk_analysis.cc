@@ -20,20 +20,62 @@
 
 #include "risk_analysis.h"
 
+#include <cstdint>
+
+#include <deque>
+#include <string>
+
+#include <boost/predef.h>
+
+#if !BOOST_OS_WINDOWS
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #include "bdd.h"
 #include "fault_tree.h"
 #include "logger.h"
 #include "mocus.h"
+#include "parallel.h"
 #include "random.h"
 #include "zbdd.h"
 
 namespace scram {
 namespace core {
 
+namespace {
+
+#if !BOOST_OS_WINDOWS
+/// Derives the cheaper settings to retry the analysis of a failed target.
+/// ZBDD with the rare-event approximation
+/// avoids the construction of the whole BDD of the target.
+///
+/// @param[in] settings  The original analysis settings.
+/// @param[out] fallback  The cheaper settings.
+///
+/// @returns false if the original analysis is already as cheap.
+bool MakeFallback(const Settings& settings, Settings* fallback) {
+  if (settings.algorithm() != Algorithm::kBdd &&
+      (settings.approximation() == Approximation::kRareEvent ||
+       settings.approximation() == Approximation::kMcub)) {
+    return false;
+  }
+  *fallback = settings;
+  fallback->prime_implicants(false)
+      .algorithm(Algorithm::kZbdd)
+      .approximation(Approximation::kRareEvent);
+  return true;
+}
+#endif
+
+}  // namespace
+
 RiskAnalysis::RiskAnalysis(mef::Model* model, const Settings& settings)
     : Analysis(settings), model_(model) {}
 
-void RiskAnalysis::Analyze() noexcept {
+void RiskAnalysis::Analyze(Checkpoint* checkpoint) noexcept {
   assert(results_.empty() && "Rerunning the analysis.");
   // Set the seed for the pseudo-random number generator if given explicitly.
   // Otherwise it defaults to the implementation dependent value.
@@ -48,38 +90,250 @@ void RiskAnalysis::Analyze() noexcept {
                                                      Analysis::settings(),
                                                      model_->context());
       eta->Analyze();
-      for (EventTreeAnalysis::Result& result : eta->sequences()) {
+      event_tree_results_.push_back(std::move(eta));
+      LOG(INFO) << "Finished event tree analysis: " << initiating_event->name();
+    }
+  }
+  std::vector<const mef::Gate*> gate_targets;
+  for (const mef::FaultTreePtr& ft : model_->fault_trees()) {
+    for (const mef::Gate* target : ft->top_events())
+      gate_targets.push_back(target);
+  }
+  if (Analysis::settings().num_shards() > 1)
+    SelectShard(&gate_targets);
+
+  std::vector<Target> targets;  // The targets to analyze.
+  for (const std::unique_ptr<EventTreeAnalysis>& eta : event_tree_results_) {
+    // The end states are analyzed as sequences after their constituents.
+    for (auto* sequences : {&eta->sequences(), &eta->end_states()}) {
+      for (EventTreeAnalysis::Result& result : *sequences) {
         const mef::Sequence& sequence = result.sequence;
-        LOG(INFO) << "Running analysis for sequence: " << sequence.name();
         results_.push_back(
             {std::pair<const mef::InitiatingEvent&, const mef::Sequence&>{
-                *initiating_event, sequence}});
-        RunAnalysis(*result.gate, &results_.back());
-        if (result.is_expression_only) {
-          results_.back().fault_tree_analysis = nullptr;
-          results_.back().importance_analysis = nullptr;
+                eta->initiating_event(), sequence}});
+        Result& target = results_.back();
+        if (checkpoint && checkpoint->Restore(target.id, *result.gate,
+                                              &result.p_sequence,
+                                              &target.warning)) {
+          target.restored = true;
+          LOG(INFO) << "Restored analysis for sequence: " << sequence.name();
+          continue;
         }
-        if (Analysis::settings().probability_analysis())
-          result.p_sequence = results_.back().probability_analysis->p_total();
-        LOG(INFO) << "Finished analysis for sequence: " << sequence.name();
+        targets.push_back({results_.size() - 1, result.gate.get(), &result});
       }
-      event_tree_results_.push_back(std::move(eta));
-      LOG(INFO) << "Finished event tree analysis: " << initiating_event->name();
     }
   }
 
-  for (const mef::FaultTreePtr& ft : model_->fault_trees()) {
-    for (const mef::Gate* target : ft->top_events()) {
-      LOG(INFO) << "Running analysis for gate: " << target->id();
-      results_.push_back({target});
-      RunAnalysis(*target, &results_.back());
-      LOG(INFO) << "Finished analysis for gate: " << target->id();
+  for (const mef::Gate* target : gate_targets) {
+    results_.push_back({target});
+    double p_total = 0;
+    if (checkpoint && checkpoint->Restore(results_.back().id, *target,
+                                          &p_total, &results_.back().warning)) {
+      results_.back().restored = true;
+      LOG(INFO) << "Restored analysis for gate: " << target->id();
+      continue;
     }
+    targets.push_back({results_.size() - 1, target, nullptr});
+  }
+
+  if (Analysis::settings().num_workers() && !targets.empty()) {
+    if (checkpoint)
+      return RunIsolated(targets, checkpoint);
+    LOG(WARNING) << "Isolated analysis requires the checkpoint"
+                 << " to collect the results of worker processes.";
+  }
+  for (const Target& target : targets) {
+    LOG(INFO) << "Running analysis for " << target.name();
+    RunTarget(target, &results_[target.index], checkpoint);
+    LOG(INFO) << "Finished analysis for " << target.name();
   }
 }
 
+void RiskAnalysis::RunTarget(const Target& target, Result* result,
+                             Checkpoint* checkpoint) noexcept {
+  // The sampling of each target is reproducible
+  // regardless of the order of targets and worker processes.
+  if (Analysis::settings().seed() >= 0)
+    Random::seed(Analysis::settings().seed() + target.index);
+  RunAnalysis(*target.gate, result);
+  if (target.sequence) {
+    if (target.sequence->is_expression_only) {
+      result->fault_tree_analysis = nullptr;
+      result->importance_analysis = nullptr;
+    }
+    if (Analysis::settings().probability_analysis())
+      target.sequence->p_sequence = result->probability_analysis->p_total();
+  }
+  if (checkpoint)
+    checkpoint->Save(*result, *target.gate);
+}
+
+void RiskAnalysis::RunIsolated(const std::vector<Target>& targets,
+                               Checkpoint* checkpoint) noexcept {
+#if BOOST_OS_WINDOWS
+  LOG(WARNING) << "Worker processes are not supported on this platform.";
+  for (const Target& target : targets)
+    RunTarget(target, &results_[target.index], checkpoint);
+#else
+  Settings fallback_settings;
+  bool has_fallback = Analysis::settings().fallback() &&
+                      MakeFallback(Analysis::settings(), &fallback_settings);
+  /// The running analysis of a target in a worker process.
+  struct Worker {
+    pid_t pid;  ///< The worker process.
+    int pipe;  ///< The read end of the completion status pipe.
+    const Target* target;  ///< The target under analysis.
+    bool fallback;  ///< The retry with the cheaper analysis.
+  };
+  std::deque<std::pair<const Target*, bool>> queue;  // With the fallback flag.
+  for (const Target& target : targets)
+    queue.emplace_back(&target, false);
+  std::vector<Worker> workers;
+  std::size_t max_workers = Analysis::settings().num_workers();
+
+  while (!queue.empty() || !workers.empty()) {
+    while (!queue.empty() && workers.size() < max_workers) {
+      const Target& target = *queue.front().first;
+      bool fallback = queue.front().second;
+      queue.pop_front();
+      LOG(INFO) << "Running analysis in a worker process for " << target.name();
+      // Only the forking thread is duplicated into the worker process.
+      assert(Workers::idle() && "Forking with running analysis threads.");
+      int fds[2] = {-1, -1};
+      pid_t pid = ::pipe(fds) ? -1 : ::fork();
+      if (pid == 0) {  // The worker process.
+        ::close(fds[0]);
+        const Settings& settings =
+            fallback ? fallback_settings : Analysis::settings();
+        if (settings.memory_limit()) {
+          rlimit limit;
+          limit.rlim_cur = limit.rlim_max =
+              static_cast<rlim_t>(settings.memory_limit()) << 20;
+          ::setrlimit(RLIMIT_AS, &limit);
+        }
+        // The warning is saved with the results for restoration.
+        if (fallback)
+          results_[target.index].warning =
+              "The analysis for " + target.name() +
+              " is retried with ZBDD and the rare-event"
+              " approximation after the failure.";
+        RiskAnalysis(model_, settings)
+            .RunTarget(target, &results_[target.index], checkpoint);
+        char done = 1;
+        ::_exit(::write(fds[1], &done, 1) == 1 ? 0 : 1);
+      }
+      if (pid < 0) {
+        if (fds[0] >= 0) {
+          ::close(fds[0]);
+          ::close(fds[1]);
+        }
+        LOG(WARNING) << "Cannot start a worker process for " << target.name()
+                     << "; analyzing in the main process.";
+        RunTarget(target, &results_[target.index], checkpoint);
+        continue;
+      }
+      ::close(fds[1]);
+      workers.push_back({pid, fds[0], &target, fallback});
+    }
+
+    std::vector<pollfd> pipes;
+    for (const Worker& worker : workers)
+      pipes.push_back({worker.pipe, POLLIN, 0});
+    if (::poll(pipes.data(), pipes.size(), -1) < 0)
+      continue;  // Interrupted by a signal.
+    for (int i = pipes.size() - 1; i >= 0; --i) {
+      if (!pipes[i].revents)
+        continue;
+      Worker worker = workers[i];
+      workers.erase(workers.begin() + i);
+      char done = 0;
+      bool finished = ::read(worker.pipe, &done, 1) == 1 && done;
+      ::close(worker.pipe);
+      int status = 0;
+      ::waitpid(worker.pid, &status, 0);
+
+      const Target& target = *worker.target;
+      Result& result = results_[target.index];
+      double p_total = 0;
+      if (finished && checkpoint->Collect(result.id, *target.gate, &p_total,
+                                          &result.warning)) {
+        result.restored = true;
+        if (target.sequence)
+          target.sequence->p_sequence = p_total;
+        LOG(INFO) << "Finished analysis for " << target.name();
+        continue;
+      }
+      std::string failure =
+          finished ? "the results are not saved"
+                   : WIFSIGNALED(status)
+                         ? "the worker is terminated by signal " +
+                               std::to_string(WTERMSIG(status))
+                         : "the worker exited with status " +
+                               std::to_string(WEXITSTATUS(status));
+      if (has_fallback && !worker.fallback) {
+        LOG(WARNING) << "Retrying with the cheaper analysis for " << target.name()
+                     << " because " << failure;
+        queue.emplace_back(&target, true);
+        continue;
+      }
+      result.warning =
+          "The analysis for " + target.name() + " failed: " + failure + ".";
+      LOG(ERROR) << result.warning;
+    }
+  }
+#endif
+}
+
+void RiskAnalysis::SelectShard(
+    std::vector<const mef::Gate*>* gate_targets) noexcept {
+  int num_targets = gate_targets->size();
+  for (const std::unique_ptr<EventTreeAnalysis>& eta : event_tree_results_)
+    num_targets += eta->sequences().size() + eta->end_states().size();
+  const Settings& settings = Analysis::settings();
+  int first = static_cast<std::int64_t>(settings.shard_index() - 1) *
+              num_targets / settings.num_shards();
+  int last = static_cast<std::int64_t>(settings.shard_index()) * num_targets /
+             settings.num_shards();
+  LOG(INFO) << "Selecting targets [" << first << ", " << last << ") of "
+            << num_targets << " for shard " << settings.shard_index() << "/"
+            << settings.num_shards();
+  int index = 0;  // The running index of targets in the full analysis order.
+  auto in_shard = [&index, first, last] {
+    int i = index++;
+    return i >= first && i < last;
+  };
+  std::vector<std::unique_ptr<EventTreeAnalysis>> event_tree_results;
+  for (std::unique_ptr<EventTreeAnalysis>& eta : event_tree_results_) {
+    bool in_eta = false;
+    for (auto* results : {&eta->sequences(), &eta->end_states()}) {
+      // The sequences are not assignable due to the references.
+      std::vector<EventTreeAnalysis::Result> sequences;
+      for (EventTreeAnalysis::Result& result : *results) {
+        if (in_shard())
+          sequences.push_back(std::move(result));
+      }
+      in_eta |= !sequences.empty();
+      results->swap(sequences);
+    }
+    if (in_eta)
+      event_tree_results.push_back(std::move(eta));
+  }
+  event_tree_results_ = std::move(event_tree_results);
+  std::vector<const mef::Gate*> shard_gates;
+  for (const mef::Gate* target : *gate_targets) {
+    if (in_shard())
+      shard_gates.push_back(target);
+  }
+  gate_targets->swap(shard_gates);
+}
+
 void RiskAnalysis::RunAnalysis(const mef::Gate& target,
                                Result* result) noexcept {
+  // The bounded-width BDD replaces the exact qualitative analysis.
+  if (Analysis::settings().approximation() == Approximation::kBounds &&
+      Analysis::settings().probability_analysis()) {
+    return RunAnalysis<Bdd>(target, result);
+  }
   switch (Analysis::settings().algorithm()) {
     case Algorithm::kBdd:
       return RunAnalysis<Bdd>(target, result);
@@ -99,6 +353,7 @@ void RiskAnalysis::RunAnalysis(const mef::Gate& target,
   if (Analysis::settings().probability_analysis()) {
     switch (Analysis::settings().approximation()) {
       case Approximation::kNone:
+      case Approximation::kBounds:
         RunAnalysis<Algorithm, Bdd>(fta.get(), result);
         break;
       case Approximation::kRareEvent:
@@ -106,6 +361,10 @@ void RiskAnalysis::RunAnalysis(const mef::Gate& target,
         break;
       case Approximation::kMcub:
         RunAnalysis<Algorithm, McubCalculator>(fta.get(), result);
+        break;
+      case Approximation::kInclusionExclusion:
+        RunAnalysis<Algorithm, InclusionExclusionCalculator>(fta.get(),
+                                                             result);
     }
   }
   result->fault_tree_analysis = std::move(fta);
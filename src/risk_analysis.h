@@ -22,6 +22,7 @@
 #define SCRAM_SRC_RISK_ANALYSIS_H_
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -58,6 +59,51 @@ class RiskAnalysis : public Analysis {
     std::unique_ptr<const ImportanceAnalysis> importance_analysis;
     std::unique_ptr<const UncertaintyAnalysis> uncertainty_analysis;
     /// @}
+
+    /// Indication that the results are restored from a checkpoint
+    /// instead of the analysis.
+    bool restored = false;
+
+    /// The problems with the isolated analysis of the target,
+    /// e.g., the crash of its worker process.
+    std::string warning;
+  };
+
+  /// Durable storage of the results of completed analysis targets
+  /// to resume interrupted analyses
+  /// and to reuse the results of unchanged targets between model revisions.
+  class Checkpoint {
+   public:
+    virtual ~Checkpoint() = default;
+
+    /// Restores the results of a target completed in a previous run.
+    ///
+    /// @param[in] id  The analysis target.
+    /// @param[in] gate  The top gate of the target with all its dependencies.
+    /// @param[out] p_total  The total probability of the target if available.
+    /// @param[out] warning  The warning about the results if any.
+    ///
+    /// @returns true if the target is completed and unchanged since.
+    virtual bool Restore(const Result::Id& id, const mef::Gate& gate,
+                         double* p_total, std::string* warning) noexcept = 0;
+
+    /// Saves the results of a completed analysis target.
+    ///
+    /// @param[in] result  The completed analysis of the target.
+    /// @param[in] gate  The top gate of the target with all its dependencies.
+    virtual void Save(const Result& result, const mef::Gate& gate) noexcept = 0;
+
+    /// Collects the results of a target
+    /// saved by an isolated worker process in the current analysis.
+    ///
+    /// @param[in] id  The analysis target.
+    /// @param[in] gate  The top gate of the target with all its dependencies.
+    /// @param[out] p_total  The total probability of the target if available.
+    /// @param[out] warning  The warning about the results if any.
+    ///
+    /// @returns true if the saved results of the target are available.
+    virtual bool Collect(const Result::Id& id, const mef::Gate& gate,
+                         double* p_total, std::string* warning) noexcept = 0;
   };
 
   /// @param[in] model  An analysis model with fault trees, events, etc.
@@ -80,8 +126,11 @@ class RiskAnalysis : public Analysis {
   ///       only after full initialization of the model
   ///       with or without its probabilities.
   ///
+  /// @param[in,out] checkpoint  Optional storage of completed targets
+  ///                            to skip and to save.
+  ///
   /// @pre The analysis is performed only once.
-  void Analyze() noexcept;
+  void Analyze(Checkpoint* checkpoint = nullptr) noexcept;
 
   /// @returns The results of the analysis.
   const std::vector<Result>& results() const { return results_; }
@@ -93,6 +142,45 @@ class RiskAnalysis : public Analysis {
   }
 
  private:
+  /// The analysis target not restored from the checkpoint.
+  struct Target {
+    /// @returns The description of the target for messages.
+    std::string name() const {
+      return sequence ? "sequence " + sequence->sequence.name()
+                      : "gate " + gate->id();
+    }
+
+    std::size_t index;  ///< The index of the target result.
+    const mef::Gate* gate;  ///< The top gate of the target.
+    EventTreeAnalysis::Result* sequence;  ///< The event tree sequence if any.
+  };
+
+  /// Restricts the event tree sequences and gates to analyze
+  /// to the shard of targets requested in the settings.
+  ///
+  /// @param[in,out] gate_targets  The top gates of fault trees to analyze.
+  ///
+  /// @pre The event trees are analyzed.
+  void SelectShard(std::vector<const mef::Gate*>* gate_targets) noexcept;
+
+  /// Analyzes a target and saves its results into the checkpoint.
+  ///
+  /// @param[in] target  The analysis target.
+  /// @param[in,out] result  The result container element.
+  /// @param[in,out] checkpoint  Optional storage of completed targets.
+  void RunTarget(const Target& target, Result* result,
+                 Checkpoint* checkpoint) noexcept;
+
+  /// Analyzes targets concurrently in isolated worker processes
+  /// with optional memory limits.
+  /// The results are passed back with the checkpoint,
+  /// and the failed targets are reported without their results.
+  ///
+  /// @param[in] targets  The targets to analyze.
+  /// @param[in,out] checkpoint  The storage to save and collect the results.
+  void RunIsolated(const std::vector<Target>& targets,
+                   Checkpoint* checkpoint) noexcept;
+
   /// Runs all possible analysis on a given target.
   /// Analysis types are deduced from the settings.
   ///
@@ -18,14 +18,21 @@
 /// @file scram.cc
 /// Main entrance.
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include <boost/exception/all.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
+#include <libxml/parser.h>
 
+#include "checkpoint.h"
 #include "config.h"
 #include "error.h"
 #include "initializer.h"
@@ -37,6 +44,7 @@
 #include "version.h"
 
 namespace po = boost::program_options;
+namespace fs = boost::filesystem;
 
 namespace {
 
@@ -53,10 +61,21 @@ po::options_description ConstructOptions() {
       ("version", "Display version information")
       ("config-file", OPT_VALUE(path), "XML file with analysis configurations")
       ("validate", "Validate input files without analysis")
+      ("batch", "Run the configuration files given as input files"
+                " as independent jobs in one process")
+      ("batch-jobs", OPT_VALUE(int),
+       "Max number of batch jobs running concurrently")
+      ("shard", po::value<std::string>()->value_name("I/N"),
+       "Analyze only the I-th of N partitions of the analysis targets")
+      ("merge", "Merge the shard reports given as input files")
+      ("checkpoint", OPT_VALUE(path),
+       "Directory to save the results of completed analysis targets")
+      ("resume", "Reuse the unchanged targets in the checkpoint directory")
       ("bdd", "Perform qualitative analysis with BDD")
       ("zbdd", "Perform qualitative analysis with ZBDD")
       ("mocus", "Perform qualitative analysis with MOCUS")
       ("prime-implicants", "Calculate prime implicants")
+      ("sort-products", "Report products in the order of probability")
       ("probability", OPT_VALUE(bool), "Perform probability analysis")
       ("importance", OPT_VALUE(bool), "Perform importance analysis")
       ("uncertainty", OPT_VALUE(bool), "Perform uncertainty analysis")
@@ -64,6 +83,20 @@ po::options_description ConstructOptions() {
       ("sil", OPT_VALUE(bool), "Compute the Safety Integrity Level metrics")
       ("rare-event", "Use the rare event approximation")
       ("mcub", "Use the MCUB approximation")
+      ("bounds", "Use probability bounds with bounded-width BDD")
+      ("inclusion-exclusion",
+       "Use the truncated inclusion-exclusion with Bonferroni bounds")
+      ("variable-order", po::value<std::string>()->value_name("heuristic"),
+       "BDD variable ordering: topological|force|weighted-dfs|fan-out|best")
+      ("combination", po::value<std::string>()->value_name("order"),
+       "Order of combining BDD gate arguments: order|balanced|size|queue")
+      ("skip-pass", po::value<std::vector<std::string>>()->value_name("pass"),
+       "Disable a preprocessing pass: multiple-definitions|common-arguments|"
+       "distributivity|boolean-optimization|decomposition")
+      ("pass-iterations", OPT_VALUE(int),
+       "Limit on repetitions of a preprocessing pass")
+      ("pass-budget", OPT_VALUE(double),
+       "Time limit in seconds for each preprocessing pass")
       ("limit-order,l", OPT_VALUE(int), "Upper limit for the product order")
       ("cut-off", OPT_VALUE(double), "Cut-off probability for products")
       ("mission-time", OPT_VALUE(double), "System mission time in hours")
@@ -75,6 +108,23 @@ po::options_description ConstructOptions() {
        "Number of quantiles for distributions")
       ("num-bins", OPT_VALUE(int), "Number of bins for histograms")
       ("seed", OPT_VALUE(int), "Seed for the pseudo-random number generator")
+      ("cache-size", OPT_VALUE(int),
+       "Limit on the number of entries in BDD/ZBDD computation caches")
+      ("cache-retention", OPT_VALUE(int),
+       "Limit on BDD/ZBDD computation cache entries kept between gates")
+      ("bdd-width", OPT_VALUE(int),
+       "Limit on vertices per level of BDD with probability bounds")
+      ("inclusion-exclusion-depth", OPT_VALUE(int),
+       "Max number of products in inclusion-exclusion terms")
+      ("product-buffer", OPT_VALUE(int),
+       "Limit on products sorted in memory before spilling to disk")
+      ("num-threads", OPT_VALUE(int),
+       "Max number of threads for concurrent analysis")
+      ("num-workers", OPT_VALUE(int),
+       "Max number of worker processes to analyze targets in isolation")
+      ("memory-limit", OPT_VALUE(int),
+       "Limit on the memory of each worker process in MiB")
+      ("fallback", "Retry targets failed in workers with cheaper analysis")
       ("output-path,o", OPT_VALUE(path), "Output path for reports")
       ("verbosity", OPT_VALUE(int), "Set log verbosity");
 #ifndef NDEBUG
@@ -139,15 +189,38 @@ int ParseArguments(int argc, char* argv[], po::variables_map* vm) {
     std::cerr << usage << "\n\n" << desc << std::endl;
     return 1;
   }
+  if (vm->count("merge") && vm->count("shard")) {
+    std::cerr << "Merging of shard reports cannot be sharded.\n\n"
+              << usage << "\n\n" << desc << std::endl;
+    return 1;
+  }
+  if (vm->count("batch") &&
+      (!vm->count("input-files") || vm->count("config-file") ||
+       vm->count("output-path") || vm->count("merge") ||
+       vm->count("checkpoint"))) {
+    std::cerr << "Batch mode requires job configuration files as input files"
+              << " and\ncannot be combined with a configuration file,"
+              << " an output path, merging, or checkpoints.\n\n"
+              << usage << "\n\n" << desc << std::endl;
+    return 1;
+  }
+  if (vm->count("resume") && !vm->count("checkpoint")) {
+    std::cerr << "Resumption requires the checkpoint directory.\n\n"
+              << usage << "\n\n" << desc << std::endl;
+    return 1;
+  }
   if ((vm->count("bdd") + vm->count("zbdd") + vm->count("mocus")) > 1) {
     std::cerr << "Mutually exclusive qualitative analysis algorithms.\n"
               << "(MOCUS/BDD/ZBDD) cannot be applied at the same time.\n\n"
               << usage << "\n\n" << desc << std::endl;
     return 1;
   }
-  if (vm->count("rare-event") && vm->count("mcub")) {
-    std::cerr << "The rare event and MCUB approximations cannot be "
-              << "applied at the same time.\n\n"
+  if ((vm->count("rare-event") + vm->count("mcub") + vm->count("bounds") +
+       vm->count("inclusion-exclusion")) > 1) {
+    std::cerr << "Mutually exclusive probability approximations.\n"
+              << "(Rare-Event/MCUB/Bounds/Inclusion-Exclusion)"
+              << " cannot be applied"
+              << " at the same time.\n\n"
               << usage << "\n\n" << desc << std::endl;
     return 1;
   }
@@ -178,13 +251,39 @@ void ConstructSettings(const po::variables_map& vm,
     settings->algorithm("mocus");
   }
   settings->prime_implicants(vm.count("prime-implicants"));
+  settings->sort_products(vm.count("sort-products"));
+  if (vm.count("fallback"))
+    settings->fallback(true);
   // Determine if the probability approximation is requested.
   if (vm.count("rare-event")) {
-    assert(!vm.count("mcub"));
     settings->approximation("rare-event");
   } else if (vm.count("mcub")) {
     settings->approximation("mcub");
+  } else if (vm.count("bounds")) {
+    settings->approximation("bounds");
+  } else if (vm.count("inclusion-exclusion")) {
+    settings->approximation("inclusion-exclusion");
+  }
+  if (vm.count("shard")) {
+    std::istringstream shard(vm["shard"].as<std::string>());
+    int index = 0;
+    int num_shards = 0;
+    char separator = '\0';
+    shard >> index >> separator >> num_shards >> std::ws;
+    if (shard.fail() || separator != '/' || !shard.eof())
+      throw scram::InvalidArgument("The shard must be given as I/N.");
+    settings->shard(index, num_shards);
   }
+  SET("variable-order", std::string, variable_order);
+  SET("combination", std::string, combination);
+  if (vm.count("skip-pass")) {
+    for (const std::string& pass :
+         vm["skip-pass"].as<std::vector<std::string>>()) {
+      settings->preprocessing_pass(pass, false);
+    }
+  }
+  SET("pass-iterations", int, pass_iterations);
+  SET("pass-budget", double, pass_budget);
   SET("time-step", double, time_step);
   SET("sil", bool, safety_integrity_levels);
 
@@ -199,6 +298,14 @@ void ConstructSettings(const po::variables_map& vm,
   SET("num-trials", int, num_trials);
   SET("num-quantiles", int, num_quantiles);
   SET("num-bins", int, num_bins);
+  SET("cache-size", int, cache_size);
+  SET("cache-retention", int, cache_retention);
+  SET("bdd-width", int, bdd_width);
+  SET("inclusion-exclusion-depth", int, inclusion_exclusion_depth);
+  SET("product-buffer", int, product_buffer);
+  SET("num-threads", int, num_threads);
+  SET("num-workers", int, num_workers);
+  SET("memory-limit", int, memory_limit);
 #ifndef NDEBUG
   settings->preprocessor = vm.count("preprocessor");
   settings->print = vm.count("print");
@@ -206,17 +313,139 @@ void ConstructSettings(const po::variables_map& vm,
 }
 #undef SET
 
+/// Analyzes the model from input files and reports the results.
+///
+/// @param[in] vm  Variables map of program options.
+/// @param[in] settings  The analysis settings.
+/// @param[in] input_files  The XML input files with the model.
+/// @param[in] output_path  The report destination.
+///                         If empty, the standard output is used.
+///
+/// @throws Error  Exceptions specific to SCRAM.
+/// @throws std::exception  All other problems.
+void RunAnalysis(const po::variables_map& vm,
+                 const scram::core::Settings& settings,
+                 const std::vector<std::string>& input_files,
+                 const std::string& output_path) {
+  // Process input files
+  // into valid analysis containers and constructs.
+  // Throws if anything is invalid.
+  std::shared_ptr<scram::mef::Model> model =
+      scram::mef::Initializer(input_files, settings).model();
+#ifndef NDEBUG
+  if (vm.count("serialize"))
+    return Serialize(*model, std::cout);
+#endif
+  if (vm.count("validate"))
+    return;  // Stop if only validation is requested.
+
+  // Initiate risk analysis with the given information.
+  std::unique_ptr<scram::Checkpoint> checkpoint;
+  std::string temp_checkpoint;  // Only to pass the results of workers.
+  if (vm.count("checkpoint")) {
+    checkpoint = std::make_unique<scram::Checkpoint>(
+        vm["checkpoint"].as<std::string>(), settings, vm.count("resume"));
+  } else if (settings.num_workers()) {
+    temp_checkpoint = (fs::temp_directory_path() /
+                       fs::unique_path("scram-%%%%-%%%%-%%%%-%%%%"))
+                          .string();
+    checkpoint =
+        std::make_unique<scram::Checkpoint>(temp_checkpoint, settings, false);
+  }
+  // Removes the temporary checkpoint upon the exit.
+  struct Cleanup {
+    ~Cleanup() {
+      boost::system::error_code ec;
+      if (!path.empty())
+        fs::remove_all(path, ec);
+    }
+    const std::string& path;
+  } cleanup{temp_checkpoint};
+  scram::core::RiskAnalysis analysis(model.get(), settings);
+  analysis.Analyze(checkpoint.get());
+#ifndef NDEBUG
+  if (vm.count("no-report") || vm.count("preprocessor") || vm.count("print"))
+    return;
+#endif
+  scram::Reporter reporter(checkpoint.get());
+  if (output_path.empty()) {
+    reporter.Report(analysis, std::cout);
+  } else {
+    reporter.Report(analysis, output_path);
+  }
+}
+
+/// Runs the configuration files as independent analysis jobs
+/// in one process.
+/// The jobs share the loaded schemas and the budget of worker threads.
+/// The command-line settings overwrite the settings of every job.
+///
+/// The failure of a job is logged
+/// without interrupting the other jobs.
+///
+/// @param[in] vm  Variables map of program options.
+///
+/// @returns The number of failed jobs.
+///
+/// @throws InvalidArgument  The number of concurrent jobs is not positive.
+int RunBatch(const po::variables_map& vm) {
+  const auto& jobs = vm["input-files"].as<std::vector<std::string>>();
+  int max_jobs = vm.count("batch-jobs") ? vm["batch-jobs"].as<int>() : 1;
+  if (max_jobs < 1)
+    throw scram::InvalidArgument("The number of batch jobs must be positive.");
+
+  std::atomic<std::size_t> next_job(0);
+  std::atomic<int> num_failures(0);
+  auto run_jobs = [&vm, &jobs, max_jobs, &next_job, &num_failures] {
+    for (std::size_t i = next_job++; i < jobs.size(); i = next_job++) {
+      try {
+        CLOCK(job_time);
+        scram::Config config(jobs[i]);
+        scram::core::Settings settings = config.settings();
+        ConstructSettings(vm, &settings);
+        if (max_jobs > 1 && settings.num_workers())
+          throw scram::InvalidArgument(
+              "Worker processes cannot be forked from concurrent batch jobs.");
+        if (config.output_path().empty())
+          throw scram::ValidationError("The batch job has no output path.");
+        RunAnalysis(vm, settings, config.input_files(), config.output_path());
+        LOG(scram::INFO) << "Finished the batch job " << jobs[i] << " in "
+                         << DUR(job_time);
+      } catch (const std::exception& err) {
+        ++num_failures;
+        LOG(scram::ERROR) << "Failed the batch job " << jobs[i] << ": "
+                          << err.what();
+      }
+    }
+  };
+  xmlInitParser();  // Must precede concurrent parsing.
+  std::vector<std::future<void>> runners;
+  for (std::size_t i = 1; i < std::min<std::size_t>(max_jobs, jobs.size());
+       ++i) {
+    runners.push_back(std::async(std::launch::async, run_jobs));
+  }
+  run_jobs();
+  for (auto& runner : runners)
+    runner.get();
+  return num_failures;
+}
+
 /// Main body of command-line entrance to run the program.
 ///
 /// @param[in] vm  Variables map of program options.
 ///
+/// @returns 0 for success.
+/// @returns 1 for failed batch jobs.
+///
 /// @throws Error  Exceptions specific to SCRAM.
 /// @throws boost::exception  Boost errors with the variables map.
 /// @throws std::exception  All other problems.
-void RunScram(const po::variables_map& vm) {
+int RunScram(const po::variables_map& vm) {
   if (vm.count("verbosity")) {
     scram::Logger::SetVerbosity(vm["verbosity"].as<int>());
   }
+  if (vm.count("batch"))
+    return RunBatch(vm) ? 1 : 0;
   scram::core::Settings settings;  // Analysis settings.
   std::vector<std::string> input_files;
   std::string output_path;
@@ -239,31 +468,17 @@ void RunScram(const po::variables_map& vm) {
   if (vm.count("output-path")) {
     output_path = vm["output-path"].as<std::string>();
   }
-  // Process input files
-  // into valid analysis containers and constructs.
-  // Throws if anything is invalid.
-  std::shared_ptr<scram::mef::Model> model =
-      scram::mef::Initializer(input_files, settings).model();
-#ifndef NDEBUG
-  if (vm.count("serialize"))
-    return Serialize(*model, std::cout);
-#endif
-  if (vm.count("validate"))
-    return;  // Stop if only validation is requested.
-
-  // Initiate risk analysis with the given information.
-  scram::core::RiskAnalysis analysis(model.get(), settings);
-  analysis.Analyze();
-#ifndef NDEBUG
-  if (vm.count("no-report") || vm.count("preprocessor") || vm.count("print"))
-    return;
-#endif
-  scram::Reporter reporter;
-  if (output_path.empty()) {
-    reporter.Report(analysis, std::cout);
-  } else {
-    reporter.Report(analysis, output_path);
+  if (vm.count("merge")) {  // The input files are shard reports.
+    scram::Reporter reporter;
+    if (output_path.empty()) {
+      reporter.Merge(input_files, std::cout);
+    } else {
+      reporter.Merge(input_files, output_path);
+    }
+    return 0;
   }
+  RunAnalysis(vm, settings, input_files, output_path);
+  return 0;
 }
 
 }  // namespace
@@ -295,7 +510,7 @@ int main(int argc, char* argv[]) {
     if (ret == 1)
       return 1;
     if (ret == 0)
-      RunScram(vm);
+      return RunScram(vm);
 
 #ifdef NDEBUG
   }
@@ -20,6 +20,8 @@
 
 #include "settings.h"
 
+#include <string>
+
 #include <boost/range/algorithm.hpp>
 
 #include "error.h"
@@ -68,6 +70,68 @@ Settings& Settings::approximation(const std::string& value) {
       static_cast<Approximation>(std::distance(kApproximationToString, it)));
 }
 
+Settings& Settings::variable_order(VariableOrder value) noexcept {
+  variable_order_ = value;
+  return *this;
+}
+
+Settings& Settings::variable_order(const std::string& value) {
+  auto it = boost::find(kVariableOrderToString, value);
+  if (it == std::end(kVariableOrderToString))
+    throw InvalidArgument("The variable ordering heuristic '" + value +
+                          "' is not recognized.");
+  return variable_order(
+      static_cast<VariableOrder>(std::distance(kVariableOrderToString, it)));
+}
+
+Settings& Settings::combination(Combination value) noexcept {
+  combination_ = value;
+  return *this;
+}
+
+Settings& Settings::combination(const std::string& value) {
+  auto it = boost::find(kCombinationToString, value);
+  if (it == std::end(kCombinationToString))
+    throw InvalidArgument("The argument combination order '" + value +
+                          "' is not recognized.");
+  return combination(
+      static_cast<Combination>(std::distance(kCombinationToString, it)));
+}
+
+Settings& Settings::preprocessing_pass(PreprocessingPass pass,
+                                       bool flag) noexcept {
+  int bit = 1 << static_cast<int>(pass);
+  disabled_passes_ = flag ? disabled_passes_ & ~bit : disabled_passes_ | bit;
+  return *this;
+}
+
+Settings& Settings::preprocessing_pass(const std::string& pass, bool flag) {
+  auto it = boost::find(kPreprocessingPassToString, pass);
+  if (it == std::end(kPreprocessingPassToString))
+    throw InvalidArgument("The preprocessing pass '" + pass +
+                          "' is not recognized.");
+  return preprocessing_pass(
+      static_cast<PreprocessingPass>(
+          std::distance(kPreprocessingPassToString, it)),
+      flag);
+}
+
+Settings& Settings::pass_iterations(int n) {
+  if (n < 0)
+    throw InvalidArgument(
+        "The number of preprocessing pass iterations cannot be negative.");
+  pass_iterations_ = n;
+  return *this;
+}
+
+Settings& Settings::pass_budget(double seconds) {
+  if (seconds < 0)
+    throw InvalidArgument(
+        "The time budget of preprocessing passes cannot be negative.");
+  pass_budget_ = seconds;
+  return *this;
+}
+
 Settings& Settings::prime_implicants(bool flag) {
   if (flag && algorithm_ != Algorithm::kBdd)
     throw InvalidArgument("Prime implicants can only be calculated with BDD");
@@ -94,6 +158,85 @@ Settings& Settings::cut_off(double prob) {
   return *this;
 }
 
+Settings& Settings::cache_size(int n) {
+  if (n < 1)
+    throw InvalidArgument(
+        "The size of computation caches cannot be less than 1.");
+
+  cache_size_ = n;
+  return *this;
+}
+
+Settings& Settings::cache_retention(int n) {
+  if (n < 0)
+    throw InvalidArgument(
+        "The number of retained cache entries cannot be negative.");
+
+  cache_retention_ = n;
+  return *this;
+}
+
+Settings& Settings::bdd_width(int n) {
+  if (n < 1)
+    throw InvalidArgument("The BDD width cannot be less than 1.");
+
+  bdd_width_ = n;
+  return *this;
+}
+
+Settings& Settings::inclusion_exclusion_depth(int depth) {
+  if (depth < 1)
+    throw InvalidArgument(
+        "The inclusion-exclusion depth cannot be less than 1.");
+
+  inclusion_exclusion_depth_ = depth;
+  return *this;
+}
+
+Settings& Settings::product_buffer(int n) {
+  if (n < 1)
+    throw InvalidArgument("The product buffer size cannot be less than 1.");
+
+  product_buffer_ = n;
+  return *this;
+}
+
+Settings& Settings::shard(int index, int num_shards) {
+  if (num_shards < 1)
+    throw InvalidArgument("The number of shards cannot be less than 1.");
+  if (index < 1 || index > num_shards)
+    throw InvalidArgument("The shard index must be in [1, " +
+                          std::to_string(num_shards) + "].");
+
+  shard_index_ = index;
+  num_shards_ = num_shards;
+  return *this;
+}
+
+Settings& Settings::num_threads(int n) {
+  if (n < 1)
+    throw InvalidArgument("The number of threads cannot be less than 1.");
+
+  num_threads_ = n;
+  return *this;
+}
+
+Settings& Settings::num_workers(int n) {
+  if (n < 0)
+    throw InvalidArgument("The number of workers cannot be negative.");
+
+  num_workers_ = n;
+  return *this;
+}
+
+Settings& Settings::memory_limit(int mebibytes) {
+  if (mebibytes < 0)
+    throw InvalidArgument("The memory limit cannot be negative.");
+
+  memory_limit_ = mebibytes;
+  return *this;
+}
+
 Settings& Settings::num_trials(int n) {
   if (n < 1)
     throw InvalidArgument("The number of trials cannot be less than 1.");
@@ -42,11 +42,53 @@ const char* const kAlgorithmToString[] = {"bdd", "zbdd", "mocus"};
 enum class Approximation : std::uint8_t {
   kNone = 0,
   kRareEvent,
-  kMcub
+  kMcub,
+  kBounds,  ///< Lower and upper bounds with a bounded-width BDD.
+  kInclusionExclusion  ///< Bonferroni bounds of truncated expansion.
 };
 
 /// String representations for approximations.
-const char* const kApproximationToString[] = {"none", "rare-event", "mcub"};
+const char* const kApproximationToString[] = {
+    "none", "rare-event", "mcub", "bounds", "inclusion-exclusion"};
+
+/// Static variable ordering heuristics for BDD-based analyses.
+enum class VariableOrder : std::uint8_t {
+  kTopological = 0,  ///< Depth-first traversal with shared nodes first.
+  kForce,  ///< Iterative placement at the center of gravity of gates.
+  kWeightedDfs,  ///< Depth-first traversal with heavier sub-graphs first.
+  kFanOut,  ///< Depth-first placement of high fan-out variables first.
+  kBest  ///< The smallest of bounded BDD builds with the other heuristics.
+};
+
+/// String representations for variable ordering heuristics.
+const char* const kVariableOrderToString[] = {
+    "topological", "force", "weighted-dfs", "fan-out", "best"};
+
+/// Orders of combining gate argument functions in BDD construction.
+enum class Combination : std::uint8_t {
+  kOrder = 0,  ///< Left fold in the variable order of the arguments.
+  kBalanced,  ///< Pairwise reduction in a balanced binary tree.
+  kSize,  ///< Left fold from the smallest argument by the number of vertices.
+  kQueue  ///< Repeated combination of the two smallest functions.
+};
+
+/// String representations for argument combination orders.
+const char* const kCombinationToString[] = {"order", "balanced", "size",
+                                            "queue"};
+
+/// Optional preprocessing passes over the PDAG.
+enum class PreprocessingPass : std::uint8_t {
+  kMultipleDefinitions = 0,  ///< Merging of semantically equal gates.
+  kCommonArgs,  ///< Merging of common arguments of gates into new gates.
+  kDistributivity,  ///< Factoring of distributive arguments.
+  kBooleanOptimization,  ///< Removal of redundant parents of common nodes.
+  kDecomposition  ///< Decomposition of common nodes by state propagation.
+};
+
+/// String representations for preprocessing passes.
+const char* const kPreprocessingPassToString[] = {
+    "multiple-definitions", "common-arguments", "distributivity",
+    "boolean-optimization", "decomposition"};
 
 /// Builder for analysis settings.
 /// Analysis facilities are guaranteed not to throw or fail
@@ -141,6 +183,268 @@ class Settings {
   /// @throws InvalidArgument  The probability is not in the [0, 1] range.
   Settings& cut_off(double prob);
 
+  /// @returns The limit on the number of entries
+  ///          in each computation cache of BDD-based algorithms.
+  int cache_size() const { return cache_size_; }
+
+  /// Sets the limit on the number of entries
+  /// in each memoization table of BDD-based algorithms.
+  /// The tables become lossy caches upon reaching the limit.
+  ///
+  /// @param[in] n  A natural number for the number of entries.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws InvalidArgument  The number is less than 1.
+  Settings& cache_size(int n);
+
+  /// @returns The variable ordering heuristic for BDD-based analyses.
+  VariableOrder variable_order() const { return variable_order_; }
+
+  /// Sets the static variable ordering heuristic
+  /// for BDD and ZBDD construction.
+  /// MOCUS always uses the topological ordering.
+  ///
+  /// @param[in] value  The ordering heuristic.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws InvalidArgument  The heuristic is not recognized.
+  /// @{
+  Settings& variable_order(VariableOrder value) noexcept;
+  Settings& variable_order(const std::string& value);
+  /// @}
+
+  /// @returns The order of combining gate arguments in BDD construction.
+  Combination combination() const { return combination_; }
+
+  /// Sets the order of combining gate argument functions
+  /// in BDD construction.
+  /// The order does not change the final BDD
+  /// but may reduce the size of intermediate functions.
+  ///
+  /// @param[in] value  The combination order.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws InvalidArgument  The combination order is not recognized.
+  /// @{
+  Settings& combination(Combination value) noexcept;
+  Settings& combination(const std::string& value);
+  /// @}
+
+  /// @returns The max number of computation cache entries
+  ///          retained between conversions of gates into BDD or ZBDD.
+  int cache_retention() const { return cache_retention_; }
+
+  /// Sets the max number of BDD or ZBDD computation cache entries
+  /// retained after conversion of a gate
+  /// for reuse by the conversion of the following gates.
+  /// The caches are cleared if they grow beyond the limit.
+  ///
+  /// @param[in] n  A non-negative number of entries.
+  ///               0 clears the caches after every gate.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws InvalidArgument  The number is negative.
+  Settings& cache_retention(int n);
+
+  /// @returns The max number of vertices per variable level
+  ///          in bounded-width approximate BDD.
+  int bdd_width() const { return bdd_width_; }
+
+  /// Sets the max number of vertices per variable level
+  /// for the bounds approximation with BDD.
+  /// The least probable vertices beyond the width
+  /// are replaced with the terminal 1 for the upper bound
+  /// and the terminal 0 for the lower bound.
+  /// The products, importance, and uncertainty analyses
+  /// use the upper bound function.
+  ///
+  /// @param[in] n  A positive number of vertices.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws InvalidArgument  The number is less than 1.
+  Settings& bdd_width(int n);
+
+  /// @returns The max number of cut sets in the intersection terms
+  ///          of the truncated inclusion-exclusion expansion.
+  int inclusion_exclusion_depth() const { return inclusion_exclusion_depth_; }
+
+  /// Sets the truncation depth of the inclusion-exclusion expansion
+  /// over the products.
+  /// The odd depths give upper bounds,
+  /// and the even depths give lower bounds of the total probability.
+  ///
+  /// @param[in] depth  A positive number of terms.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws InvalidArgument  The depth is less than 1.
+  Settings& inclusion_exclusion_depth(int depth);
+
+  /// @returns true if products are reported
+  ///               in the descending order of probability.
+  bool sort_products() const { return sort_products_; }
+
+  /// Sets the flag to report products in the order of probability.
+  /// The order applies only with probability analysis.
+  ///
+  /// @param[in] flag  True for the request.
+  ///
+  /// @returns Reference to this object.
+  Settings& sort_products(bool flag) {
+    sort_products_ = flag;
+    return *this;
+  }
+
+  /// @returns The max number of products kept in memory for sorting.
+  int product_buffer() const { return product_buffer_; }
+
+  /// Sets the limit on the number of products sorted in memory.
+  /// The products beyond the limit are sorted in blocks on disk.
+  ///
+  /// @param[in] n  A natural number for the number of products.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws InvalidArgument  The number is less than 1.
+  Settings& product_buffer(int n);
+
+  /// @returns true if the optional preprocessing pass is enabled.
+  bool preprocessing_pass(PreprocessingPass pass) const {
+    return !(disabled_passes_ & (1 << static_cast<int>(pass)));
+  }
+
+  /// Enables or disables an optional preprocessing pass.
+  /// The preprocessing results are equivalent without the pass,
+  /// but the graph may be less simplified for analysis.
+  ///
+  /// @param[in] pass  The preprocessing pass.
+  /// @param[in] flag  True to enable the pass.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws InvalidArgument  The pass is not recognized.
+  /// @{
+  Settings& preprocessing_pass(PreprocessingPass pass, bool flag) noexcept;
+  Settings& preprocessing_pass(const std::string& pass, bool flag);
+  /// @}
+
+  /// @returns The max number of repetitions of a preprocessing pass.
+  ///          0 if the number is not limited.
+  int pass_iterations() const { return pass_iterations_; }
+
+  /// Sets the limit on the number of consecutive repetitions
+  /// of a preprocessing pass until the graph stops changing.
+  ///
+  /// @param[in] n  A non-negative number of iterations.
+  ///               0 for no limit.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws InvalidArgument  The number is negative.
+  Settings& pass_iterations(int n);
+
+  /// @returns The wall-clock time limit in seconds for a preprocessing pass.
+  ///          0 if the time is not limited.
+  double pass_budget() const { return pass_budget_; }
+
+  /// Sets the wall-clock time limit for each optional preprocessing pass.
+  /// The pass over its budget stops at the next consistent state of the graph
+  /// leaving the remaining simplifications undone.
+  ///
+  /// @param[in] seconds  A non-negative time limit.
+  ///                     0 for no limit.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws InvalidArgument  The time is negative.
+  Settings& pass_budget(double seconds);
+
+  /// @returns The 1-based index of the shard of analysis targets.
+  int shard_index() const { return shard_index_; }
+
+  /// @returns The total number of shards of analysis targets.
+  int num_shards() const { return num_shards_; }
+
+  /// Restricts the analysis to a shard of its targets.
+  /// The targets are partitioned deterministically into contiguous ranges
+  /// in the order of the full analysis.
+  ///
+  /// @param[in] index  The 1-based index of the shard to analyze.
+  /// @param[in] num_shards  The total number of shards.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws InvalidArgument  The number of shards is less than 1,
+  ///                          or the index is out of range.
+  Settings& shard(int index, int num_shards);
+
+  /// @returns The max number of threads for analysis.
+  int num_threads() const { return num_threads_; }
+
+  /// Sets the max number of threads for analysis.
+  /// Independent modules are analyzed concurrently
+  /// if more than one thread is allowed.
+  /// Large BDD Apply operations within a module
+  /// are computed with fork-join tasks on the threads.
+  ///
+  /// @param[in] n  A natural number for the number of threads.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws InvalidArgument  The number is less than 1.
+  Settings& num_threads(int n);
+
+  /// @returns The max number of worker processes for isolated analysis.
+  ///          0 if the targets are analyzed in the main process.
+  int num_workers() const { return num_workers_; }
+
+  /// Sets the max number of concurrent worker processes
+  /// to analyze targets in isolation.
+  /// A worker crash or memory exhaustion fails only its target
+  /// without losing the results of the other targets.
+  ///
+  /// @param[in] n  A non-negative number of workers.
+  ///               0 for the analysis within the main process.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws InvalidArgument  The number is negative.
+  Settings& num_workers(int n);
+
+  /// @returns The limit on the address space of a worker process in MiB.
+  ///          0 if the memory is not limited.
+  int memory_limit() const { return memory_limit_; }
+
+  /// Sets the limit on the memory of each isolated worker process.
+  ///
+  /// @param[in] mebibytes  A non-negative limit.
+  ///                       0 for no limit.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws InvalidArgument  The limit is negative.
+  Settings& memory_limit(int mebibytes);
+
+  /// @returns true if the targets failed in isolated workers
+  ///          are retried with cheaper analysis.
+  bool fallback() const { return fallback_; }
+
+  /// Sets the retry of the failed isolated targets
+  /// with the ZBDD algorithm and the rare-event approximation.
+  ///
+  /// @param[in] flag  True to retry the failed targets.
+  ///
+  /// @returns Reference to this object.
+  Settings& fallback(bool flag) {
+    fallback_ = flag;
+    return *this;
+  }
+
   /// @returns The number of trials for Monte-Carlo simulations.
   int num_trials() const { return num_trials_; }
 
@@ -309,11 +613,29 @@ class Settings {
   bool uncertainty_analysis_ = false;  ///< A flag for uncertainty analysis.
   bool ccf_analysis_ = false;  ///< A flag for common-cause analysis.
   bool prime_implicants_ = false;  ///< Calculation of prime implicants.
+  bool sort_products_ = false;  ///< Reporting products by probability.
+  bool fallback_ = false;  ///< Cheaper retry of failed isolated targets.
   /// Qualitative analysis algorithm.
   Algorithm algorithm_ = Algorithm::kBdd;
   /// The approximations for calculations.
   Approximation approximation_ = Approximation::kNone;
+  /// The variable ordering heuristic for BDD-based analyses.
+  VariableOrder variable_order_ = VariableOrder::kTopological;
+  /// The order of combining gate arguments in BDD construction.
+  Combination combination_ = Combination::kOrder;
   int limit_order_ = 20;  ///< Limit on the order of products.
+  int cache_size_ = 1 << 22;  ///< The limit on computation cache entries.
+  int cache_retention_ = 0;  ///< The limit on cache entries between gates.
+  int bdd_width_ = 1000;  ///< The limit on approximate BDD vertices per level.
+  int inclusion_exclusion_depth_ = 3;  ///< The inclusion-exclusion terms.
+  int product_buffer_ = 1 << 20;  ///< The limit on products in memory.
+  int disabled_passes_ = 0;  ///< The bit set of disabled preprocessing passes.
+  int pass_iterations_ = 0;  ///< The limit on repetitions of passes.
+  int shard_index_ = 1;  ///< The shard of targets to analyze.
+  int num_shards_ = 1;  ///< The number of target shards.
+  int num_threads_ = 1;  ///< The max number of threads for analysis.
+  int num_workers_ = 0;  ///< The max number of isolated worker processes.
+  int memory_limit_ = 0;  ///< The memory limit of worker processes in MiB.
   int seed_ = 0;  ///< The seed for the pseudo-random number generator.
   int num_trials_ = 1e3;  ///< The number of trials for Monte Carlo simulations.
   int num_quantiles_ = 20;  ///< The number of quantiles for distributions.
@@ -321,6 +643,7 @@ class Settings {
   double mission_time_ = 8760;  ///< System mission time.
   double time_step_ = 0;  ///< The time step for probability analyses.
   double cut_off_ = 1e-8;  ///< The cut-off probability for products.
+  double pass_budget_ = 0;  ///< The time limit for preprocessing passes.
 };
 
 }  // namespace core
@@ -32,6 +32,7 @@
 #include "event.h"
 #include "expression.h"
 #include "logger.h"
+#include "parameter.h"
 
 namespace scram {
 namespace core {
@@ -41,19 +42,26 @@ UncertaintyAnalysis::UncertaintyAnalysis(
     : Analysis(prob_analysis->settings()),
       mean_(0),
       sigma_(0),
-      error_factor_(1) {}
+      error_factor_(1) {
+  for (const std::pair<double, double>& point : prob_analysis->p_time())
+    times_.push_back(point.second);
+  if (times_.empty())
+    times_.push_back(Analysis::settings().mission_time());
+}
 
 void UncertaintyAnalysis::Analyze() noexcept {
   CLOCK(analysis_time);
   CLOCK(sample_time);
   LOG(DEBUG3) << "Sampling probabilities...";
   // Sample probabilities and generate data.
-  std::vector<double> samples = this->Sample();
+  std::vector<std::vector<double>> samples = this->Sample();
   LOG(DEBUG3) << "Finished sampling probabilities in " << DUR(sample_time);
 
   {
     TIMER(DEBUG3, "Calculating statistics");
-    CalculateStatistics(samples);  // Perform statistical analysis.
+    CalculateStatistics(samples.back());  // At the final mission time.
+    if (Analysis::settings().time_step())
+      CalculateStatistics(samples);
   }
 
   Analysis::AddAnalysisTime(DUR(analysis_time));
@@ -71,17 +79,37 @@ UncertaintyAnalysis::GatherDeviateExpressions(const Pdag* graph) noexcept {
   return deviate_expressions;
 }
 
+std::vector<Pdag::IndexMap<double>> UncertaintyAnalysis::EvaluateVariables(
+    const Pdag* graph, mef::MissionTime* mission_time) noexcept {
+  std::vector<Pdag::IndexMap<double>> p_vars_time(times_.size());
+  for (int i = 0; i < times_.size(); ++i) {
+    mission_time->value(times_[i]);
+    p_vars_time[i].reserve(graph->basic_events().size());
+    for (const mef::BasicEvent* event : graph->basic_events())
+      p_vars_time[i].push_back(event->p());
+  }
+  return p_vars_time;
+}
+
 void UncertaintyAnalysis::SampleExpressions(
     const std::vector<std::pair<int, mef::Expression&>>& deviate_expressions,
-    Pdag::IndexMap<double>* p_vars) noexcept {
+    mef::MissionTime* mission_time,
+    std::vector<Pdag::IndexMap<double>>* p_vars_time) noexcept {
   // Reset distributions.
   for (const auto& expression : deviate_expressions)
     expression.second.Reset();
 
-  // Sample all expressions with distributions.
-  for (const auto& expression : deviate_expressions) {
-    double prob = expression.second.Sample();
-    (*p_vars)[expression.first] = prob > 1 ? 1 : prob < 0 ? 0 : prob;
+  for (int i = 0; i < times_.size(); ++i) {
+    mission_time->value(times_[i]);
+    if (i) {  // Re-evaluate the time-dependent values with the same sample.
+      for (const auto& expression : deviate_expressions)
+        expression.second.ResetDerived();
+    }
+    // Sample all expressions with distributions.
+    for (const auto& expression : deviate_expressions) {
+      double prob = expression.second.Sample();
+      (*p_vars_time)[i][expression.first] = prob > 1 ? 1 : prob < 0 ? 0 : prob;
+    }
   }
 }
 
@@ -121,5 +149,28 @@ void UncertaintyAnalysis::CalculateStatistics(
   }
 }
 
+void UncertaintyAnalysis::CalculateStatistics(
+    const std::vector<std::vector<double>>& samples) noexcept {
+  using namespace boost::accumulators;  // NOLINT
+  std::vector<double> probabilities;
+  int num_quantiles = Analysis::settings().num_quantiles();
+  double delta = 1.0 / num_quantiles;
+  for (int i = 0; i < num_quantiles; ++i)
+    probabilities.push_back(delta * (i + 1));
+
+  assert(samples.size() == times_.size());
+  for (int i = 0; i < times_.size(); ++i) {
+    accumulator_set<double, stats<tag::mean, tag::extended_p_square_quantile>>
+        acc(extended_p_square_probabilities = probabilities);
+    for (double sample : samples[i])
+      acc(sample);
+    TimePoint point{times_[i], boost::accumulators::mean(acc), {}};
+    for (double probability : probabilities)
+      point.quantiles.push_back(
+          quantile(acc, quantile_probability = probability));
+    p_time_.push_back(std::move(point));
+  }
+}
+
 }  // namespace core
 }  // namespace scram
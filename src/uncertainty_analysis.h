@@ -33,6 +33,7 @@ namespace scram {
 
 namespace mef {  // Decouple from the implementation dependence.
 class Expression;
+class MissionTime;
 }  // namespace mef
 
 namespace core {
@@ -42,6 +43,13 @@ namespace core {
 /// with probability distributions of basic events.
 class UncertaintyAnalysis : public Analysis {
  public:
+  /// The statistics of the total probability at a point of the mission time.
+  struct TimePoint {
+    double time;  ///< The mission time.
+    double mean;  ///< The mean of the distribution.
+    std::vector<double> quantiles;  ///< The quantiles of the distribution.
+  };
+
   /// Uncertainty analysis
   /// on the fault tree processed
   /// by probability analysis.
@@ -78,6 +86,11 @@ class UncertaintyAnalysis : public Analysis {
   /// @returns Quantiles of the distribution.
   const std::vector<double>& quantiles() const { return quantiles_; }
 
+  /// @returns The distribution statistics over the mission time
+  ///          at the time steps of the probability analysis.
+  ///          The empty container implies no time steps are requested.
+  const std::vector<TimePoint>& p_time() const { return p_time_; }
+
  protected:
   /// Gathers deviate expressions of variables.
   ///
@@ -87,27 +100,54 @@ class UncertaintyAnalysis : public Analysis {
   std::vector<std::pair<int, mef::Expression&>> GatherDeviateExpressions(
       const Pdag* graph) noexcept;
 
-  /// Samples uncertain probabilities.
+  /// Evaluates variable probabilities at the mission time points.
+  ///
+  /// @param[in] graph  PDAG with the variables.
+  /// @param[in,out] mission_time  The mission time expression of the model.
+  ///
+  /// @returns Indices to probabilities mappings for each time point.
+  ///
+  /// @post The mission time is at the last time point.
+  std::vector<Pdag::IndexMap<double>> EvaluateVariables(
+      const Pdag* graph, mef::MissionTime* mission_time) noexcept;
+
+  /// Samples uncertain probabilities at the mission time points.
+  /// The deviates are sampled once for all the time points;
+  /// only the time-dependent values are re-evaluated.
   ///
   /// @param[in] deviate_expressions  A collection of deviate expressions.
-  /// @param[in,out] p_vars  Indices to probabilities mapping with values.
+  /// @param[in,out] mission_time  The mission time expression of the model.
+  /// @param[in,out] p_vars_time  Probability mappings for each time point.
+  ///
+  /// @post The mission time is at the last time point.
   void SampleExpressions(
       const std::vector<std::pair<int, mef::Expression&>>& deviate_expressions,
-      Pdag::IndexMap<double>* p_vars) noexcept;
+      mef::MissionTime* mission_time,
+      std::vector<Pdag::IndexMap<double>>* p_vars_time) noexcept;
 
  private:
   /// Performs Monte Carlo Simulation
   /// by sampling the probability distributions
-  /// and providing the final sampled values of the final probability.
+  /// and providing the sampled values of the total probability
+  /// at the mission time points.
   ///
-  /// @returns Sampled values.
-  virtual std::vector<double> Sample() noexcept = 0;
+  /// @returns Sampled values for each time point.
+  virtual std::vector<std::vector<double>> Sample() noexcept = 0;
 
   /// Calculates statistical values from the final distribution.
   ///
   /// @param[in] samples  Gathered samples for statistical analysis.
   void CalculateStatistics(const std::vector<double>& samples) noexcept;
 
+  /// Calculates the mean and quantiles at each mission time point.
+  ///
+  /// @param[in] samples  Gathered samples for each time point.
+  void CalculateStatistics(
+      const std::vector<std::vector<double>>& samples) noexcept;
+
+  /// The mission time points with the last at the final mission time.
+  std::vector<double> times_;
+
   double mean_;  ///< The mean of the final distribution.
   double sigma_;  ///< The standard deviation of the final distribution.
   double error_factor_;  ///< Error factor for 95% confidence level.
@@ -117,6 +157,7 @@ class UncertaintyAnalysis : public Analysis {
   std::vector<std::pair<double, double>> distribution_;
   /// The quantiles of the distribution.
   std::vector<double> quantiles_;
+  std::vector<TimePoint> p_time_;  ///< The statistics over the mission time.
 };
 
 /// Uncertainty analysis facility.
@@ -135,26 +176,33 @@ class UncertaintyAnalyzer : public UncertaintyAnalysis {
         prob_analyzer_(prob_analyzer) {}
 
  private:
-  /// @returns Samples of the total probability.
-  std::vector<double> Sample() noexcept override;
+  /// @returns Samples of the total probability at the mission time points.
+  std::vector<std::vector<double>> Sample() noexcept override;
 
   /// Calculator of the total probability.
   ProbabilityAnalyzer<Calculator>* prob_analyzer_;
 };
 
 template <class Calculator>
-std::vector<double> UncertaintyAnalyzer<Calculator>::Sample() noexcept {
+std::vector<std::vector<double>>
+UncertaintyAnalyzer<Calculator>::Sample() noexcept {
   std::vector<std::pair<int, mef::Expression&>> deviate_expressions =
       UncertaintyAnalysis::GatherDeviateExpressions(prob_analyzer_->graph());
-  Pdag::IndexMap<double> p_vars = prob_analyzer_->p_vars();  // Private copy!
-  std::vector<double> samples;
-  samples.reserve(Analysis::settings().num_trials());
+  std::vector<Pdag::IndexMap<double>> p_vars_time =
+      UncertaintyAnalysis::EvaluateVariables(prob_analyzer_->graph(),
+                                             &prob_analyzer_->mission_time());
+  std::vector<std::vector<double>> samples(p_vars_time.size());
+  for (std::vector<double>& time_samples : samples)
+    time_samples.reserve(Analysis::settings().num_trials());
 
   for (int i = 0; i < Analysis::settings().num_trials(); ++i) {
-    UncertaintyAnalysis::SampleExpressions(deviate_expressions, &p_vars);
-    double result = prob_analyzer_->CalculateTotalProbability(p_vars);
-    assert(result >= 0 && result <= 1);
-    samples.push_back(result);
+    UncertaintyAnalysis::SampleExpressions(
+        deviate_expressions, &prob_analyzer_->mission_time(), &p_vars_time);
+    for (int j = 0; j < p_vars_time.size(); ++j) {
+      double result = prob_analyzer_->CalculateTotalProbability(p_vars_time[j]);
+      assert(result >= 0 && result <= 1);
+      samples[j].push_back(result);
+    }
   }
 
   return samples;
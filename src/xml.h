@@ -22,6 +22,7 @@
 #define SCRAM_SRC_XML_H_
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <type_traits>
 
@@ -58,6 +59,30 @@ inline std::unique_ptr<xmlpp::DomParser> ConstructDomParser(
   }
 }
 
+/// Validates an XML document against a RELAX NG schema.
+///
+/// The validators are shared by concurrent jobs of the process;
+/// however, libxml++ validators and error reports are not thread-safe,
+/// so the validation is serialized.
+///
+/// @param[in] document  The document to validate.
+/// @param[in,out] validator  The validator with the loaded schema.
+/// @param[in] kind  The kind of the document for error messages.
+///
+/// @throws ValidationError  The document does not conform to the schema.
+inline void ValidateDocument(const xmlpp::Document* document,
+                             xmlpp::RelaxNGValidator* validator,
+                             const std::string& kind) {
+  static std::mutex validation_mutex;
+  std::lock_guard<std::mutex> lock(validation_mutex);
+  try {
+    validator->validate(document);
+  } catch (const xmlpp::validity_error&) {
+    throw ValidationError(kind + " failed schema validation:\n" +
+                          xmlpp::format_xml_error());
+  }
+}
+
 /// Helper function to statically cast to XML element.
 ///
 /// @param[in] node  XML node known to be XML element.
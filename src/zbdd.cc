@@ -23,12 +23,14 @@
 #include <cstdlib>
 
 #include <algorithm>
+#include <future>
 
 #include <boost/range/algorithm.hpp>
 
 #include "ext/algorithm.h"
 #include "ext/find_iterator.h"
 #include "logger.h"
+#include "parallel.h"
 
 namespace scram {
 namespace core {
@@ -53,6 +55,12 @@ void Zbdd::Log() noexcept {
   LOG(DEBUG4) << "# of entries in OR table: " << or_table_.size();
   LOG(DEBUG4) << "# of entries in subsume table: " << subsume_table_.size();
   LOG(DEBUG4) << "# of entries in minimal table: " << minimal_results_.size();
+  LOG(DEBUG4) << "# of entries in prune table: " << prune_results_.size();
+  LOG(DEBUG4) << "AND table hit rate: " << and_table_.hit_rate();
+  LOG(DEBUG4) << "OR table hit rate: " << or_table_.hit_rate();
+  LOG(DEBUG4) << "Subsume table hit rate: " << subsume_table_.hit_rate();
+  LOG(DEBUG4) << "Minimal table hit rate: " << minimal_results_.hit_rate();
+  LOG(DEBUG4) << "Prune table hit rate: " << prune_results_.hit_rate();
   ClearMarks(root_, false);
   LOG(DEBUG4) << "# of SetNodes in ZBDD: " << CountSetNodes(root_);
   ClearMarks(root_, false);
@@ -96,9 +104,36 @@ void Zbdd::Analyze() noexcept {
 
   Prune(root_, kSettings_.limit_order());
   Freeze();  // Complete cleanup of the memory.
+  std::unordered_map<int, int> chains;
+  root_chain_ = ReduceChains(root_, &chains);
+  LOG(DEBUG4) << "# of chains in G" << module_index_ << ": " << chains.size()
+              << " with " << literals_.size() << " literals";
+  if (!root_->terminal())
+    root_.reset();  // The set graph is superseded by the chains.
   LOG(DEBUG3) << "G" << module_index_ << " analysis time: " << DUR(zbdd_time);
 }
 
+std::vector<Zbdd::Range> Zbdd::Partition(int max_ranges) const {
+  assert(max_ranges > 0 && "Partition into no ranges.");
+  std::vector<int> branches;  // The top-level chains along the low edges.
+  for (int chain = root_chain_; chain != kEmptyChain;
+       chain = chains_[chain].low) {
+    branches.push_back(chain);
+    if (chain == kBaseChain)
+      break;  // The unity set closes the path.
+  }
+  std::vector<Range> ranges;
+  int num_ranges = std::min<int>(max_ranges, branches.size());
+  for (int i = 0; i < num_ranges; ++i) {
+    int first = branches.size() * i / num_ranges;
+    int last = branches.size() * (i + 1) / num_ranges;
+    ranges.push_back(Range(*this, branches[first],
+                           last == branches.size() ? kEmptyChain
+                                                   : branches[last]));
+  }
+  return ranges;
+}
+
 Zbdd::Zbdd(const Settings& settings, bool coherent, int module_index) noexcept
     : kBase_(new Terminal<SetNode>(true)),
       kEmpty_(new Terminal<SetNode>(false)),
@@ -106,7 +141,14 @@ Zbdd::Zbdd(const Settings& settings, bool coherent, int module_index) noexcept
       root_(kEmpty_),
       coherent_(coherent),
       module_index_(module_index),
-      set_id_(2) {}
+      and_table_(1000, settings.cache_size()),
+      or_table_(1000, settings.cache_size()),
+      minimal_results_(1000, settings.cache_size()),
+      subsume_table_(1000, settings.cache_size()),
+      prune_results_(1000, settings.cache_size()),
+      set_id_(2),
+      chains_(2),  // Terminal placeholders.
+      root_chain_(kEmptyChain) {}
 
 Zbdd::Zbdd(const Bdd::Function& module, bool coherent, Bdd* bdd,
            const Settings& settings, int module_index) noexcept
@@ -114,8 +156,8 @@ Zbdd::Zbdd(const Bdd::Function& module, bool coherent, Bdd* bdd,
   CLOCK(init_time);
   LOG(DEBUG2) << "Creating ZBDD from BDD: G" << module_index;
   LOG(DEBUG4) << "Limit on product order: " << settings.limit_order();
-  PairTable<VertexPtr> ites;
-  root_ = Minimize(ConvertBdd(module.vertex, module.complement, bdd,
+  MemoTable ites(1000, kSettings_.cache_size());
+  root_ = Minimize(ConvertBdd(module.vertex(), module.complement(), bdd,
                               kSettings_.limit_order(), &ites));
   assert(root_->terminal() || SetNode::Ref(root_).minimal());
   Log();
@@ -125,20 +167,22 @@ Zbdd::Zbdd(const Bdd::Function& module, bool coherent, Bdd* bdd,
   for (const auto& entry : sub_modules) {
     int index = entry.first;
     assert(!modules_.count(index) && "Recalculating modules.");
-    Bdd::Function sub = bdd->modules().find(std::abs(index))->second;
-    assert(!sub.vertex->terminal() && "Unexpected BDD terminal vertex.");
+    const Bdd::Function& sub = bdd->modules().find(std::abs(index))->second;
+    assert(!Bdd::terminal(sub.vertex()) && "Unexpected BDD terminal vertex.");
     int limit = entry.second.second;
     assert(limit >= 0 && "Order cut-off is not strict.");
     bool module_coherence = entry.second.first && (index > 0);
-    if (limit == 0 && module_coherence) {  // Unity is impossible.
+    // Prime implicants of non-constant modules are never Unity.
+    if (limit == 0 && (module_coherence || settings.prime_implicants())) {
       JoinModule(index, std::unique_ptr<Zbdd>(new Zbdd(settings)));
       continue;
     }
     Settings adjusted(settings);
     adjusted.limit_order(limit);
-    sub.complement ^= index < 0;
-    JoinModule(index, std::unique_ptr<Zbdd>(new Zbdd(sub, module_coherence, bdd,
-                                                     adjusted, index)));
+    Bdd::Function function(sub.edge() ^ (index < 0), bdd);
+    JoinModule(index,
+               std::unique_ptr<Zbdd>(new Zbdd(function, module_coherence, bdd,
+                                              adjusted, index)));
   }
   if (ext::any_of(modules_, [](const ModuleEntry& member) {
         return member.second->root_->terminal();
@@ -172,6 +216,8 @@ Zbdd::Zbdd(const Gate& gate, const Settings& settings) noexcept
   LOG(DEBUG3) << "Finished module conversion to ZBDD in " << DUR(init_time);
   std::map<int, std::pair<bool, int>> sub_modules;
   GatherModules(root_, 0, &sub_modules);
+  // Module graphs share no vertices and are analyzed concurrently.
+  std::vector<std::pair<int, std::future<std::unique_ptr<Zbdd>>>> jobs;
   for (const auto& entry : sub_modules) {
     int index = entry.first;
     assert(index > 0 && "No complement gates.");
@@ -186,8 +232,13 @@ Zbdd::Zbdd(const Gate& gate, const Settings& settings) noexcept
     const Gate* module_gate = module_gates.find(index)->second;
     Settings adjusted(settings);
     adjusted.limit_order(limit);
-    JoinModule(index, std::unique_ptr<Zbdd>(new Zbdd(*module_gate, adjusted)));
+    jobs.emplace_back(index, Workers::Spawn(settings.num_threads(), [=] {
+                        return std::unique_ptr<Zbdd>(
+                            new Zbdd(*module_gate, adjusted));
+                      }));
   }
+  for (auto& job : jobs)
+    JoinModule(job.first, job.second.get());
   EliminateConstantModules();
 }
 
@@ -210,6 +261,7 @@ SetNodePtr Zbdd::FindOrAddVertex(int index, const VertexPtr& high,
   high_order += !MayBeUnity(*node);
   int low_order = low->terminal() ? 0 : SetNode::Ref(low).max_set_order();
   node->max_set_order(std::max(high_order, low_order));
+  node->Summarize();
 
   in_table = node;
   return node;
@@ -229,7 +281,7 @@ SetNodePtr Zbdd::FindOrAddVertex(const Gate& gate, const VertexPtr& high,
                          gate.coherent());
 }
 
-Zbdd::VertexPtr Zbdd::GetReducedVertex(const ItePtr& ite, bool complement,
+Zbdd::VertexPtr Zbdd::GetReducedVertex(Bdd::Ite ite, bool complement,
                                        const VertexPtr& high,
                                        const VertexPtr& low) noexcept {
   if (high->id() == low->id())
@@ -238,10 +290,10 @@ Zbdd::VertexPtr Zbdd::GetReducedVertex(const ItePtr& ite, bool complement,
     return low;
   if (low->terminal() && Terminal<SetNode>::Ref(low).value())
     return low;
-  assert(ite->index() > 0 && "BDD indices are never negative.");
-  return FindOrAddVertex(complement ? -ite->index() : ite->index(),
-                         high, low, ite->order(), ite->module(),
-                         ite->coherent());
+  assert(ite.index() > 0 && "BDD indices are never negative.");
+  return FindOrAddVertex(complement ? -ite.index() : ite.index(),
+                         high, low, ite.order(), ite.module(),
+                         ite.coherent());
 }
 
 Zbdd::VertexPtr Zbdd::GetReducedVertex(const SetNodePtr& node,
@@ -258,34 +310,36 @@ Zbdd::VertexPtr Zbdd::GetReducedVertex(const SetNodePtr& node,
   return FindOrAddVertex(node, high, low);
 }
 
-Zbdd::VertexPtr Zbdd::ConvertBdd(const Bdd::VertexPtr& vertex, bool complement,
+Zbdd::VertexPtr Zbdd::ConvertBdd(Bdd::Vertex vertex, bool complement,
                                  Bdd* bdd_graph, int limit_order,
-                                 PairTable<VertexPtr>* ites) noexcept {
-  if (vertex->terminal())
+                                 MemoTable* ites) noexcept {
+  if (Bdd::terminal(vertex))
     return complement ? kEmpty_ : kBase_;
-  VertexPtr& result =
-      (*ites)[{complement ? -vertex->id() : vertex->id(), limit_order}];
-  if (result)
-    return result;
+  int id = vertex;  // Vertices are not reclaimed during the conversion.
+  std::pair<int, int> key = {complement ? -id : id, limit_order};
+  if (auto it = ext::find(*ites, key))
+    return it->second;
+  VertexPtr result;
   if (!coherent_ && kSettings_.prime_implicants()) {
-    result = ConvertBddPrimeImplicants(Ite::Ptr(vertex), complement, bdd_graph,
-                                       limit_order, ites);
+    result = ConvertBddPrimeImplicants(bdd_graph->ite(vertex), complement,
+                                       bdd_graph, limit_order, ites);
   } else {
-    result =
-        ConvertBdd(Ite::Ptr(vertex), complement, bdd_graph, limit_order, ites);
+    result = ConvertBdd(bdd_graph->ite(vertex), complement, bdd_graph,
+                        limit_order, ites);
   }
   assert(result->terminal() ||
          SetNode::Ref(result).max_set_order() <= limit_order);
+  ites->emplace(key, result);
   return result;
 }
 
-Zbdd::VertexPtr Zbdd::ConvertBdd(const ItePtr& ite, bool complement,
+Zbdd::VertexPtr Zbdd::ConvertBdd(Bdd::Ite ite, bool complement,
                                  Bdd* bdd_graph, int limit_order,
-                                 PairTable<VertexPtr>* ites) noexcept {
-  if (ite->module() && !ite->coherent())
+                                 MemoTable* ites) noexcept {
+  if (ite.module() && !ite.coherent())
     return ConvertBddPrimeImplicants(ite, complement, bdd_graph, limit_order,
                                      ites);
-  VertexPtr low = ConvertBdd(ite->low(), ite->complement_edge() ^ complement,
+  VertexPtr low = ConvertBdd(ite.low(), ite.complement_edge() ^ complement,
                              bdd_graph, limit_order, ites);
   if (limit_order == 0) {  // Cut-off on the set order.
     if (low->terminal())
@@ -293,30 +347,35 @@ Zbdd::VertexPtr Zbdd::ConvertBdd(const ItePtr& ite, bool complement,
     return kEmpty_;
   }
   VertexPtr high =
-      ConvertBdd(ite->high(), complement, bdd_graph, --limit_order, ites);
+      ConvertBdd(ite.high(), complement, bdd_graph, --limit_order, ites);
   return GetReducedVertex(ite, false, high, low);
 }
 
 Zbdd::VertexPtr
-Zbdd::ConvertBddPrimeImplicants(const ItePtr& ite, bool complement,
+Zbdd::ConvertBddPrimeImplicants(Bdd::Ite ite, bool complement,
                                 Bdd* bdd_graph, int limit_order,
-                                PairTable<VertexPtr>* ites) noexcept {
-  Bdd::Function common = Bdd::Consensus()(bdd_graph, ite, complement);
-  VertexPtr consensus = ConvertBdd(common.vertex, common.complement, bdd_graph,
-                                   limit_order, ites);
+                                MemoTable* ites) noexcept {
+  // The consensus of a reduced vertex is never the constant True,
+  // so no prime implicant fits into the cut-off.
+  if (limit_order == 0 && kSettings_.prime_implicants())
+    return kEmpty_;
+  Bdd::Function common =
+      Bdd::Consensus()(bdd_graph, ite.vertex(), complement);
+  VertexPtr consensus = ConvertBdd(common.vertex(), common.complement(),
+                                   bdd_graph, limit_order, ites);
   if (limit_order == 0) {  // Cut-off on the product order.
     if (consensus->terminal())
       return consensus;
     return kEmpty_;
   }
   int sublimit = limit_order - 1;  // Assumes non-Unity element.
-  if (ite->module() && !kSettings_.prime_implicants()) {
-    assert(!ite->coherent() && "Only non-coherent modules through PI.");
+  if (ite.module() && !kSettings_.prime_implicants()) {
+    assert(!ite.coherent() && "Only non-coherent modules through PI.");
     sublimit += 1;  // Unity modules may happen with minimal cut sets.
   }
   VertexPtr high =
-      ConvertBdd(ite->high(), complement, bdd_graph, sublimit, ites);
-  VertexPtr low = ConvertBdd(ite->low(), ite->complement_edge() ^ complement,
+      ConvertBdd(ite.high(), complement, bdd_graph, sublimit, ites);
+  VertexPtr low = ConvertBdd(ite.low(), ite.complement_edge() ^ complement,
                              bdd_graph, sublimit, ites);
   return GetReducedVertex(ite, false, high,
                           GetReducedVertex(ite, true, low, consensus));
@@ -449,10 +508,9 @@ Zbdd::VertexPtr Zbdd::Apply<kAnd>(const VertexPtr& arg_one,
   if (arg_one->id() == arg_two->id())
     return Prune(arg_one, limit_order);
 
-  VertexPtr& result =
-      and_table_[GetResultKey(arg_one, arg_two, limit_order)];
-  if (result)
-    return result;  // Already computed.
+  Triplet key = GetResultKey(arg_one, arg_two, limit_order);
+  if (auto it = ext::find(and_table_, key))
+    return it->second;  // Already computed.
 
   SetNodePtr set_one = SetNode::Ptr(arg_one);
   SetNodePtr set_two = SetNode::Ptr(arg_two);
@@ -462,9 +520,10 @@ Zbdd::VertexPtr Zbdd::Apply<kAnd>(const VertexPtr& arg_one,
              set_one->index() < set_two->index()) {
     std::swap(set_one, set_two);
   }
-  result = Apply<kAnd>(set_one, set_two, limit_order);
+  VertexPtr result = Apply<kAnd>(set_one, set_two, limit_order);
   assert(result->terminal() ||
          SetNode::Ref(result).max_set_order() <= limit_order);
+  and_table_.emplace(key, result);
   return result;
 }
 
@@ -518,10 +577,9 @@ Zbdd::VertexPtr Zbdd::Apply<kOr>(const VertexPtr& arg_one,
   if (arg_one->id() == arg_two->id())
     return Prune(arg_one, limit_order);
 
-  VertexPtr& result =
-      or_table_[GetResultKey(arg_one, arg_two, limit_order)];
-  if (result)
-    return result;  // Already computed.
+  Triplet key = GetResultKey(arg_one, arg_two, limit_order);
+  if (auto it = ext::find(or_table_, key))
+    return it->second;  // Already computed.
 
   SetNodePtr set_one = SetNode::Ptr(arg_one);
   SetNodePtr set_two = SetNode::Ptr(arg_two);
@@ -531,9 +589,10 @@ Zbdd::VertexPtr Zbdd::Apply<kOr>(const VertexPtr& arg_one,
              set_one->index() < set_two->index()) {
     std::swap(set_one, set_two);
   }
-  result = Apply<kOr>(set_one, set_two, limit_order);
+  VertexPtr result = Apply<kOr>(set_one, set_two, limit_order);
   assert(result->terminal() ||
          SetNode::Ref(result).max_set_order() <= limit_order);
+  or_table_.emplace(key, result);
   return result;
 }
 
@@ -621,19 +680,19 @@ Zbdd::VertexPtr Zbdd::Minimize(const VertexPtr& vertex) noexcept {
   SetNodePtr node = SetNode::Ptr(vertex);
   if (node->minimal())
     return vertex;
-  VertexPtr& result = minimal_results_[vertex->id()];
-  if (result)
-    return result;
+  if (auto it = ext::find(minimal_results_, vertex->id()))
+    return it->second;
   VertexPtr high = Minimize(node->high());
   VertexPtr low = Minimize(node->low());
   high = Subsume(high, low);
   assert(high->id() != low->id() && "Subsume failed!");
   if (high->terminal() && !Terminal<SetNode>::Ref(high).value()) {
-    result = low;  // Reduction rule.
-    return result;
+    minimal_results_.emplace(vertex->id(), low);  // Reduction rule.
+    return low;
   }
-  result = FindOrAddVertex(node, high, low);
-  SetNode::Ref(result).minimal(true);
+  SetNodePtr result = FindOrAddVertex(node, high, low);
+  result->minimal(true);
+  minimal_results_.emplace(vertex->id(), result);
   return result;
 }
 
@@ -643,16 +702,19 @@ Zbdd::VertexPtr Zbdd::Subsume(const VertexPtr& high,
     return Terminal<SetNode>::Ref(low).value() ? kEmpty_ : high;
   if (high->terminal())
     return high;  // No need to reduce terminal sets.
-  VertexPtr& computed = subsume_table_[{high->id(), low->id()}];
-  if (computed)
-    return computed;
+  if (!SetNode::Ref(high).MaySubsume(SetNode::Ref(low)))
+    return high;
+  std::pair<int, int> key = {high->id(), low->id()};
+  if (auto it = ext::find(subsume_table_, key))
+    return it->second;
 
   SetNodePtr high_node = SetNode::Ptr(high);
   SetNodePtr low_node = SetNode::Ptr(low);
   if (high_node->order() > low_node->order() ||
       (high_node->order() == low_node->order() &&
        high_node->index() < low_node->index())) {
-    computed = Subsume(high, low_node->low());
+    VertexPtr computed = Subsume(high, low_node->low());
+    subsume_table_.emplace(key, computed);
     return computed;
   }
   VertexPtr subhigh;
@@ -671,14 +733,14 @@ Zbdd::VertexPtr Zbdd::Subsume(const VertexPtr& high,
     sublow = Subsume(high_node->low(), low);
   }
   if (subhigh->terminal() && !Terminal<SetNode>::Ref(subhigh).value()) {
-    computed = sublow;
-    return computed;
+    subsume_table_.emplace(key, sublow);
+    return sublow;
   }
   assert(subhigh->id() != sublow->id());
   SetNodePtr new_high = FindOrAddVertex(high_node, subhigh, sublow);
   new_high->minimal(high_node->minimal());
-  computed = new_high;
-  return computed;
+  subsume_table_.emplace(key, new_high);
+  return new_high;
 }
 
 Zbdd::VertexPtr Zbdd::Prune(const VertexPtr& vertex, int limit_order) noexcept {
@@ -691,15 +753,16 @@ Zbdd::VertexPtr Zbdd::Prune(const VertexPtr& vertex, int limit_order) noexcept {
   if (node->max_set_order() <= limit_order)
     return node;
 
-  VertexPtr& result = prune_results_[{node->id(), limit_order}];
-  if (result)
-    return result;
+  std::pair<int, int> key = {node->id(), limit_order};
+  if (auto it = ext::find(prune_results_, key))
+    return it->second;
 
   int limit_high = limit_order - !MayBeUnity(*node);
-  result = GetReducedVertex(node, Prune(node->high(), limit_high),
-                            Prune(node->low(), limit_order));
+  VertexPtr result = GetReducedVertex(node, Prune(node->high(), limit_high),
+                                      Prune(node->low(), limit_order));
   if (!result->terminal())
     SetNode::Ref(result).minimal(node->minimal());
+  prune_results_.emplace(key, result);
   return result;
 }
 
@@ -846,6 +909,37 @@ void Zbdd::TestStructure(const VertexPtr& vertex, bool modules) noexcept {
   TestStructure(node.low(), modules);
 }
 
+int Zbdd::ReduceChains(const VertexPtr& vertex,
+                       std::unordered_map<int, int>* chains) noexcept {
+  if (vertex->terminal())
+    return Terminal<SetNode>::Ref(vertex).value() ? kBaseChain : kEmptyChain;
+  if (auto it = ext::find(*chains, vertex->id()))
+    return it->second;
+  const SetNode& node = SetNode::Ref(vertex);
+  const SetNode* last = &node;  // The end of the run.
+  Chain chain{};
+  chain.begin = literals_.size();
+  if (node.module()) {
+    chain.module = modules_.find(node.index())->second.get();
+  } else {
+    literals_.push_back(node.index());
+    // Only exclusively owned nodes are collapsed to avoid literal copies.
+    while (!last->high()->terminal()) {
+      const SetNode& next = SetNode::Ref(last->high());
+      if (next.module() || next.low() != kEmpty_ || next.use_count() > 1)
+        break;
+      literals_.push_back(next.index());
+      last = &next;
+    }
+  }
+  chain.end = literals_.size();
+  chain.high = ReduceChains(last->high(), chains);
+  chain.low = ReduceChains(node.low(), chains);
+  chains_.push_back(chain);
+  chains->emplace(vertex->id(), chains_.size() - 1);
+  return chains_.size() - 1;
+}
+
 namespace zbdd {
 
 CutSetContainer::CutSetContainer(const Settings& settings, int module_index,
@@ -878,6 +972,42 @@ Zbdd::VertexPtr CutSetContainer::ConvertGate(const Gate& gate) noexcept {
   return result;
 }
 
+Zbdd::VertexPtr CutSetContainer::ConvertProducts(
+    std::vector<std::vector<const Node*>> products) noexcept {
+  auto by_order = [](const Node* lhs, const Node* rhs) {
+    return lhs->order() < rhs->order();
+  };
+  for (std::vector<const Node*>& product : products)
+    boost::sort(product, by_order);
+  boost::sort(products, [&by_order](const std::vector<const Node*>& lhs,
+                                    const std::vector<const Node*>& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                        rhs.end(), by_order);
+  });
+  return ConvertProducts(products.cbegin(), products.cend(), 0);
+}
+
+Zbdd::VertexPtr CutSetContainer::ConvertProducts(ProductIterator first,
+                                                 ProductIterator last,
+                                                 int depth) noexcept {
+  if (first == last)
+    return kEmpty_;
+  if (first->size() == depth) {  // The prefix itself is the only product.
+    assert(std::next(first) == last && "Non-minimal products.");
+    return kBase_;
+  }
+  const Node* node = (*first)[depth];
+  auto mid = std::find_if(first, last,
+                          [node, depth](const std::vector<const Node*>& p) {
+                            return p[depth] != node;
+                          });
+  VertexPtr high = ConvertProducts(first, mid, depth + 1);
+  VertexPtr low = ConvertProducts(mid, last, depth);
+  if (node->index() > gate_index_bound_)
+    return FindOrAddVertex(static_cast<const Gate&>(*node), high, low);
+  return FindOrAddVertex(node->index(), high, low, node->order());
+}
+
 Zbdd::VertexPtr CutSetContainer::ExtractIntermediateCutSets(
     int index) noexcept {
   assert(index && index > gate_index_bound_);
@@ -30,7 +30,6 @@
 #include <utility>
 #include <vector>
 
-#include <boost/functional/hash.hpp>
 #include <boost/iterator/iterator_facade.hpp>
 #include <boost/noncopyable.hpp>
 
@@ -42,6 +41,11 @@ namespace core {
 /// Representation of non-terminal nodes in ZBDD.
 /// Complement variables are represented with negative indices.
 /// The order of the complement is higher than the order of the variable.
+///
+/// The summary of the variables for pruning of subsumption
+/// is limited to the Bloom signatures and the largest set order.
+/// The smallest set order and the range of variable orders are not kept
+/// because the node has no room left for them within 64 bytes.
 class SetNode : public NonTerminal<SetNode> {
  public:
   using NonTerminal::NonTerminal;
@@ -63,6 +67,45 @@ class SetNode : public NonTerminal<SetNode> {
   /// @param[in] order  The order/size of the largest set.
   void max_set_order(int order) { max_set_order_ = order; }
 
+  /// @returns The Bloom signature of all the variables in the ZBDD.
+  std::uint32_t signature() const { return signature_; }
+
+  /// @returns The Bloom signature of the variables common to all the sets,
+  ///          i.e., the intersection of signatures of the sets.
+  ///          0 for the ZBDD with the empty set.
+  std::uint32_t common_signature() const { return common_signature_; }
+
+  /// Computes the variable signatures of the ZBDD from its branches.
+  ///
+  /// @pre The non-terminal branches are already summarized.
+  void Summarize() noexcept {
+    std::uint32_t bit = GetSignatureBit(NonTerminal::index());
+    signature_ = bit | GetSignature(NonTerminal::high()) |
+                 GetSignature(NonTerminal::low());
+    common_signature_ = (bit | GetCommonSignature(NonTerminal::high())) &
+                        GetCommonSignature(NonTerminal::low());
+  }
+
+  /// Checks the variable summaries of sets
+  /// for a possibility of the subsume operation to remove anything.
+  ///
+  /// @param[in] low  The sets that may be subsets of the sets in this ZBDD.
+  ///
+  /// @returns false if no low set can be a subset of any set in this ZBDD.
+  bool MaySubsume(const SetNode& low) const {
+    // Otherwise, every low set has a variable absent in this ZBDD.
+    return (low.common_signature_ & ~signature_) == 0;
+  }
+
+  /// @param[in] index  The index of a variable, gate, or complement.
+  ///
+  /// @returns The Bloom filter bit for the index.
+  static std::uint32_t GetSignatureBit(int index) noexcept {
+    // Fibonacci hashing to spread sequential indices over the bits.
+    return std::uint32_t(1)
+           << ((static_cast<std::uint64_t>(index) * 0x9E3779B97F4A7C15) >> 59);
+  }
+
   /// @returns Whatever count is stored in this node.
   std::int64_t count() const { return count_; }
 
@@ -82,53 +125,47 @@ class SetNode : public NonTerminal<SetNode> {
   void count(std::int64_t number) { count_ = number; }
 
  private:
+  /// @returns The union signature of all variables in the ZBDD vertex.
+  static std::uint32_t GetSignature(
+      const IntrusivePtr<Vertex<SetNode>>& vertex) noexcept {
+    return vertex->terminal() ? 0 : Ref(vertex).signature_;
+  }
+
+  /// @returns The intersection signature of sets in the ZBDD vertex.
+  static std::uint32_t GetCommonSignature(
+      const IntrusivePtr<Vertex<SetNode>>& vertex) noexcept {
+    if (vertex->terminal())  // The Empty set family has no sets to intersect.
+      return Terminal<SetNode>::Ref(vertex).value() ? 0 : ~std::uint32_t(0);
+    return Ref(vertex).common_signature_;
+  }
+
   bool minimal_ = false;  ///< A flag for minimized collection of sets.
   int max_set_order_ = 0;  ///< The order of the largest set in the ZBDD.
+  std::uint32_t signature_ = 0;  ///< The union signature of variables.
+  std::uint32_t common_signature_ = 0;  ///< The intersection signature.
   std::int64_t count_ = 0;  ///< The number of products, nodes, or anything.
 };
 
 using SetNodePtr = IntrusivePtr<SetNode>;  ///< Shared ZBDD set nodes.
 
-/// Function for hashing a pair of ordered numbers.
-struct PairHash {
-  /// Operator overload for hashing two ordered numbers.
-  ///
-  /// @param[in] p  The pair of numbers.
-  ///
-  /// @returns Hash value of the pair.
-  std::size_t operator()(const std::pair<int, int>& p) const noexcept {
-    return boost::hash_value(p);
-  }
-};
-
-/// Hash table with pairs of numbers as keys.
-///
-/// @tparam Value  Type of values to be stored in the table.
-template <typename Value>
-using PairTable = std::unordered_map<std::pair<int, int>, Value, PairHash>;
-
 using Triplet = std::array<int, 3>;  ///< Triplet of numbers for functions.
 
-/// Functor for hashing triplets of ordered numbers.
-struct TripletHash {
-  /// Operator overload for hashing three ordered numbers.
-  ///
-  /// @param[in] triplet  Three numbers.
-  ///
-  /// @returns Hash value of the triplet.
-  std::size_t operator()(const Triplet& triplet) const noexcept {
-    return boost::hash_range(triplet.begin(), triplet.end());
-  }
-};
-
-/// Hash table with triplets of numbers as keys.
-///
-/// @tparam Value  Type of values to be stored in the table.
-template <typename Value>
-using TripletTable = std::unordered_map<Triplet, Value, TripletHash>;
-
 /// Zero-Suppressed Binary Decision Diagrams for set manipulations.
 class Zbdd : private boost::noncopyable {
+  /// Read-only node of the chain-reduced final ZBDD.
+  /// A chain represents a run of set nodes connected with high edges
+  /// where all the nodes but the first have Empty low branches.
+  /// Module proxies are kept as separate chains without literals.
+  /// The chains only store the final products for the iteration;
+  /// the set operations work on the set nodes before the encoding.
+  struct Chain {
+    int high;  ///< The chain on the high branch of the last node in the run.
+    int low;  ///< The chain on the low branch of the first node in the run.
+    int begin;  ///< The start position of the run literals.
+    int end;  ///< The end position of the run literals.
+    const Zbdd* module;  ///< The module ZBDD for module proxies.
+  };
+
  public:
   using VertexPtr = IntrusivePtr<Vertex<SetNode>>;  ///< ZBDD vertex base.
   using TerminalPtr = IntrusivePtr<Terminal<SetNode>>;  ///< Terminal vertex.
@@ -138,24 +175,25 @@ class Zbdd : private boost::noncopyable {
   /// A single stack is used by all consecutive and recursive modules.
   ///
   /// @pre No constant ZBDD modules resulting in the Base set.
+  /// @pre The ZBDD has been analyzed and encoded into chains.
   class const_iterator
       : public boost::iterator_facade<const_iterator, const std::vector<int>,
                                       boost::forward_traversal_tag> {
     friend class boost::iterator_core_access;
 
-    /// Iterator over sets in the module ZBDD represented by a proxy node.
+    /// Iterator over sets in the module ZBDD represented by a proxy chain.
     /// Modules within a module (i.e., sub-modules) are recursive,
     /// while consecutive modules are not.
     class module_iterator {
      public:
       /// Constructs module iterator based on the host ZBDD iterator.
       ///
-      /// @param[in] node  The proxy node for module.
+      /// @param[in] node  The proxy chain for module.
       ///                  nullptr for the root ZBDD itself.
       /// @param[in] zbdd  The module ZBDD.
       /// @param[in,out] it  The host iterator with product stacks for output.
       /// @param[in] sentinel  The flag for end iterators.
-      module_iterator(const SetNode* node, const Zbdd& zbdd, const_iterator* it,
+      module_iterator(const Chain* node, const Zbdd& zbdd, const_iterator* it,
                       bool sentinel = false)
           : sentinel_(sentinel),
             start_pos_(it->product_.size()),
@@ -164,7 +202,7 @@ class Zbdd : private boost::noncopyable {
             node_(node),
             zbdd_(zbdd) {
         if (!sentinel_) {
-          sentinel_ = !GenerateProduct(zbdd_.root());
+          sentinel_ = !GenerateProduct(node_ ? zbdd_.root_chain_ : it_.first_);
           end_pos_ = it_.product_.size();
         }
       }
@@ -183,17 +221,17 @@ class Zbdd : private boost::noncopyable {
         while (start_pos_ != it_.product_.size()) {
           if (!module_stack_.empty() &&
               it_.product_.size() == module_stack_.back().end_pos_) {
-            const SetNode* node = module_stack_.back().node_;
+            const Chain* node = module_stack_.back().node_;
             for (++module_stack_.back(); module_stack_.back();
                  ++module_stack_.back()) {
-              if (GenerateProduct(node->high()))
+              if (GenerateProduct(node->high))
                 goto outer_break;
             }
             module_stack_.pop_back();
-            if (GenerateProduct(node->low()))
+            if (GenerateProduct(node->low))
               break;
 
-          } else if (GenerateProduct(Pop()->low())) {
+          } else if (GenerateProduct(Pop()->low)) {
             break;
           }
         }
@@ -205,59 +243,66 @@ class Zbdd : private boost::noncopyable {
      private:
       /// Generates a next product in the ZBDD traversal.
       ///
-      /// @param[in] vertex  The vertex to start adding into the product.
+      /// @param[in] chain  The chain to start adding into the product.
       ///
       /// @returns true if a new product has been generated.
       ///
       /// @post If the new product is generated,
       ///       the product and stack containers are updated accordingly.
-      bool GenerateProduct(const VertexPtr& vertex) noexcept {
-        if (vertex->terminal())
-          return Terminal<SetNode>::Ref(vertex).value();
+      bool GenerateProduct(int chain) noexcept {
+        if (!node_ && chain == it_.last_ && it_.product_.size() == start_pos_)
+          return false;  // The top-level branch beyond the range.
+        if (chain == kEmptyChain || chain == kBaseChain)
+          return chain == kBaseChain;
         if (it_.product_.size() >= it_.zbdd_.settings().limit_order())
           return false;
-        const SetNode& node = SetNode::Ref(vertex);
-        if (node.module()) {
-          module_stack_.emplace_back(
-              &node, *zbdd_.modules_.find(node.index())->second, &it_);
+        const Chain& node = zbdd_.chains_[chain];
+        if (node.module) {
+          module_stack_.emplace_back(&node, *node.module, &it_);
           for (; module_stack_.back(); ++module_stack_.back()) {
-            if (GenerateProduct(node.high()))
+            if (GenerateProduct(node.high))
               return true;
           }
           assert(it_.product_.size() == module_stack_.back().start_pos_);
           module_stack_.pop_back();
-          return GenerateProduct(node.low());
+          return GenerateProduct(node.low);
+
+        } else if (it_.product_.size() + node.end - node.begin >
+                   it_.zbdd_.settings().limit_order()) {
+          return GenerateProduct(node.low);  // The run is beyond the limit.
 
         } else {
           Push(&node);
-          return GenerateProduct(node.high()) || GenerateProduct(Pop()->low());
+          return GenerateProduct(node.high) || GenerateProduct(Pop()->low);
         }
       }
 
-      /// Removes the current leaf node from the product.
+      /// Removes the current leaf chain from the product.
       ///
-      /// @returns The current leaf node in the product.
-      const SetNode* Pop() noexcept {
+      /// @returns The current leaf chain in the product.
+      const Chain* Pop() noexcept {
         assert(start_pos_ < it_.product_.size() && "Access beyond the range!");
-        const SetNode* leaf = it_.node_stack_.back();
+        const Chain* leaf = it_.node_stack_.back();
         it_.node_stack_.pop_back();
-        it_.product_.pop_back();
+        for (int i = leaf->begin; i != leaf->end; ++i)
+          it_.product_.pop_back();
         return leaf;
       }
 
-      /// Updates the current product with a literal.
+      /// Updates the current product with the literals of a chain.
       ///
-      /// @param[in] set_node  The current leaf set node to add to the product.
-      void Push(const SetNode* set_node) noexcept {
-        it_.node_stack_.push_back(set_node);
-        it_.product_.push_back(set_node->index());
+      /// @param[in] chain  The current leaf chain to add to the product.
+      void Push(const Chain* chain) noexcept {
+        it_.node_stack_.push_back(chain);
+        for (int i = chain->begin; i != chain->end; ++i)
+          it_.product_.push_back(zbdd_.literals_[i]);
       }
 
       bool sentinel_;  ///< The signal to end the iteration.
       const int start_pos_;  ///< The initial position on the start.
       int end_pos_;  ///< The current end position in the product.
       const_iterator& it_;  ///< The host iterator.
-      const SetNode* node_;  ///< The proxy node representing the module.
+      const Chain* node_;  ///< The proxy chain representing the module.
       const Zbdd& zbdd_;  ///< The module ZBDD.
       /// The stack for consecutive modules' iterators.
       std::vector<module_iterator> module_stack_;
@@ -269,7 +314,23 @@ class Zbdd : private boost::noncopyable {
     ///
     /// @pre The ZBDD container is not modified during the iteration.
     explicit const_iterator(const Zbdd& zbdd, bool sentinel = false)
-        : sentinel_(sentinel), zbdd_(zbdd), it_(nullptr, zbdd, this, sentinel) {
+        : const_iterator(zbdd, zbdd.root_chain_, kEmptyChain, sentinel) {}
+
+    /// Constructs an iterator over a range of the top-level branches.
+    ///
+    /// @param[in] zbdd  The container to iterate over.
+    /// @param[in] first  The first top-level chain in the range.
+    /// @param[in] last  The top-level chain past the range.
+    /// @param[in] sentinel  The flag to turn the iterator into an end sentinel.
+    ///
+    /// @pre The chains are on the low-branch path of the root chain.
+    /// @pre The ZBDD container is not modified during the iteration.
+    const_iterator(const Zbdd& zbdd, int first, int last, bool sentinel)
+        : sentinel_(sentinel),
+          zbdd_(zbdd),
+          first_(first),
+          last_(last),
+          it_(nullptr, zbdd, this, sentinel) {
       sentinel_ = !it_;
     }
 
@@ -279,6 +340,8 @@ class Zbdd : private boost::noncopyable {
     const_iterator(const const_iterator& other) noexcept
         : sentinel_(other.sentinel_),
           zbdd_(other.zbdd_),
+          first_(other.first_),
+          last_(other.last_),
           it_(nullptr, zbdd_, this, sentinel_) {
       assert(*this == other && "Copy ctor is only for begin/end iterators.");
     }
@@ -304,11 +367,40 @@ class Zbdd : private boost::noncopyable {
 
     bool sentinel_;  ///< The marker for the end of traversal.
     const Zbdd& zbdd_;  ///< The source container for the products.
+    const int first_;  ///< The first top-level chain to iterate.
+    const int last_;  ///< The top-level chain to stop the iteration.
     std::vector<int> product_;  ///< The current product.
-    std::vector<const SetNode*> node_stack_;  ///< The traversal stack.
+    std::vector<const Chain*> node_stack_;  ///< The traversal stack.
     module_iterator it_;  ///< The root module iterator for the whole ZBDD.
   };
 
+  /// Disjoint range of products in the ZBDD.
+  /// The range spans consecutive top-level branches,
+  /// i.e., the chains on the low-branch path of the root chain.
+  /// Ranges can be iterated concurrently
+  /// since the iteration does not modify the ZBDD.
+  class Range {
+    friend class Zbdd;
+
+   public:
+    /// @returns Iterators over products in the range.
+    /// @{
+    auto begin() const { return const_iterator(zbdd_, first_, last_, false); }
+    auto end() const { return const_iterator(zbdd_, first_, last_, true); }
+    /// @}
+
+   private:
+    /// @param[in] zbdd  The host container.
+    /// @param[in] first  The first top-level chain in the range.
+    /// @param[in] last  The top-level chain past the range.
+    Range(const Zbdd& zbdd, int first, int last)
+        : zbdd_(zbdd), first_(first), last_(last) {}
+
+    const Zbdd& zbdd_;  ///< The host container.
+    int first_;  ///< The first top-level chain.
+    int last_;  ///< The top-level chain past the range.
+  };
+
   /// Converts Reduced Ordered BDD
   /// into Zero-Suppressed BDD.
   ///
@@ -338,17 +430,34 @@ class Zbdd : private boost::noncopyable {
 
   /// Runs the analysis
   /// with the representation of a PDAG as ZBDD.
+  ///
+  /// @post The final products are encoded into chains,
+  ///       and the set graph is released.
   void Analyze() noexcept;
 
   /// @returns Products generated by the analysis.
   const Zbdd& products() const { return *this; }
 
+  /// @returns Analysis setting with this ZBDD.
+  const Settings& settings() const { return kSettings_; }
+
   /// @returns Iterators over sets in the ZBDD.
   /// @{
   auto begin() const { return const_iterator(*this); }
   auto end() const { return const_iterator(*this, /*sentinel=*/true); }
   /// @}
 
+  /// Splits the products into disjoint ranges along the top-level branches.
+  /// The concatenation of the ranges in order
+  /// is the same sequence of products as the whole ZBDD iteration.
+  ///
+  /// @param[in] max_ranges  The max number of ranges to split into.
+  ///
+  /// @returns The ranges in the order of the ZBDD iteration.
+  ///          There are fewer ranges than requested
+  ///          if the ZBDD has not enough top-level branches.
+  std::vector<Range> Partition(int max_ranges) const;
+
   /// @returns The number of *products* in the ZBDD.
   ///
   /// @note This is not cheap.
@@ -359,7 +468,9 @@ class Zbdd : private boost::noncopyable {
   bool empty() const { return begin() == end(); }
 
   /// @returns true if the ZBDD represents a base/unity set.
-  bool base() const { return root_ == kBase_; }
+  ///
+  /// @pre The ZBDD has been analyzed and encoded into chains.
+  bool base() const { return root_chain_ == kBaseChain; }
 
  protected:
   /// The common constructor to initialize member variables.
@@ -371,16 +482,18 @@ class Zbdd : private boost::noncopyable {
                 int module_index = 0) noexcept;
 
   /// @returns Current root vertex of the ZBDD.
-  const VertexPtr& root() const { return root_; }
+  ///
+  /// @pre The set graph is not superseded by the chains upon analysis.
+  const VertexPtr& root() const {
+    assert(root_ && "The set graph is released after analysis.");
+    return root_;
+  }
 
   /// Sets a new root vertex for ZBDD.
   ///
   /// @param[in] vertex  A vertex already registered in this ZBDD.
   void root(const VertexPtr& vertex) { root_ = vertex; }
 
-  /// @returns Analysis setting with this ZBDD.
-  const Settings& settings() const { return kSettings_; }
-
   /// @returns A set of registered and fully processed modules;
   const std::map<int, std::unique_ptr<Zbdd>>& modules() const {
     return modules_;
@@ -515,13 +628,22 @@ class Zbdd : private boost::noncopyable {
                     int current_order,
                     std::map<int, std::pair<bool, int>>* modules) noexcept;
 
-  /// Clears all memoization tables.
+  /// Clears the Apply memoization tables at phase boundaries,
+  /// i.e., after a gate or a set of cut sets is fully processed.
+  ///
+  /// The minimization and pruning results are keyed by immutable vertex ids,
+  /// so they are kept for reuse by later phases
+  /// only up to the cache retention limit of the settings.
   void ClearTables() noexcept {
     and_table_.clear();
     or_table_.clear();
-    minimal_results_.clear();
-    subsume_table_.clear();
-    prune_results_.clear();
+    if (minimal_results_.size() + subsume_table_.size() +
+            prune_results_.size() >
+        kSettings_.cache_retention()) {
+      minimal_results_.clear();
+      subsume_table_.clear();
+      prune_results_.clear();
+    }
   }
 
   /// Freezes the graph.
@@ -531,10 +653,14 @@ class Zbdd : private boost::noncopyable {
   void Freeze() noexcept {
     unique_table_.Release();
     Zbdd::ClearTables();
+    minimal_results_.clear();
+    subsume_table_.clear();
+    prune_results_.clear();
     and_table_.reserve(0);
     or_table_.reserve(0);
     minimal_results_.reserve(0);
     subsume_table_.reserve(0);
+    prune_results_.reserve(0);
   }
 
   /// Joins a ZBDD representing a module gate.
@@ -559,7 +685,8 @@ class Zbdd : private boost::noncopyable {
 
  private:
   using SetNodeWeakPtr = WeakIntrusivePtr<SetNode>;  ///< Pointer for tables.
-  using ComputeTable = TripletTable<VertexPtr>;  ///< General computation table.
+  using ComputeTable = CacheTable<VertexPtr, Triplet>;  ///< Apply results.
+  using MemoTable = CacheTable<VertexPtr>;  ///< Results keyed by id pairs.
   /// Module entry in the tables with its original gate index.
   using ModuleEntry = std::pair<const int, std::unique_ptr<Zbdd>>;
 
@@ -619,7 +746,7 @@ class Zbdd : private boost::noncopyable {
   /// @param[in] low  The low ZBDD vertex.
   ///
   /// @returns Resultant reduced vertex.
-  VertexPtr GetReducedVertex(const ItePtr& ite, bool complement,
+  VertexPtr GetReducedVertex(Bdd::Ite ite, bool complement,
                              const VertexPtr& high,
                              const VertexPtr& low) noexcept;
 
@@ -662,9 +789,9 @@ class Zbdd : private boost::noncopyable {
   /// @returns Pointer to the root vertex of the ZBDD graph.
   ///
   /// @post The input BDD structure is not changed.
-  VertexPtr ConvertBdd(const Bdd::VertexPtr& vertex, bool complement,
+  VertexPtr ConvertBdd(Bdd::Vertex vertex, bool complement,
                        Bdd* bdd_graph, int limit_order,
-                       PairTable<VertexPtr>* ites) noexcept;
+                       MemoTable* ites) noexcept;
 
   /// Converts BDD if-then-else vertex into ZBDD graph.
   /// This overload differs in that
@@ -679,9 +806,9 @@ class Zbdd : private boost::noncopyable {
   /// @param[in,out] ites  Processed function graphs with ids and limit order.
   ///
   /// @returns Pointer to the root vertex of the ZBDD graph.
-  VertexPtr ConvertBdd(const ItePtr& ite, bool complement,
+  VertexPtr ConvertBdd(Bdd::Ite ite, bool complement,
                        Bdd* bdd_graph, int limit_order,
-                       PairTable<VertexPtr>* ites) noexcept;
+                       MemoTable* ites) noexcept;
 
   /// Converts BDD if-then-else vertex into ZBDD graph for prime implicants.
   /// This is used by the BDD vertex to ZBDD converter,
@@ -694,9 +821,9 @@ class Zbdd : private boost::noncopyable {
   /// @param[in,out] ites  Processed function graphs with ids and limit order.
   ///
   /// @returns Pointer to the root vertex of the ZBDD graph.
-  VertexPtr ConvertBddPrimeImplicants(const ItePtr& ite, bool complement,
+  VertexPtr ConvertBddPrimeImplicants(Bdd::Ite ite, bool complement,
                                       Bdd* bdd_graph, int limit_order,
-                                      PairTable<VertexPtr>* ites) noexcept;
+                                      MemoTable* ites) noexcept;
 
   /// Transforms a PDAG gate into a Zbdd set graph.
   ///
@@ -842,6 +969,21 @@ class Zbdd : private boost::noncopyable {
   /// @pre SetNode marks are clear (false).
   void TestStructure(const VertexPtr& vertex, bool modules) noexcept;
 
+  /// Encodes the final ZBDD into chains
+  /// by collapsing runs of set nodes with Empty low branches.
+  ///
+  /// @param[in] vertex  The root vertex of the ZBDD.
+  /// @param[in,out] chains  The memoization of vertex chains by vertex ids.
+  ///
+  /// @returns The chain of the vertex.
+  ///
+  /// @pre Modules are already encoded into chains.
+  int ReduceChains(const VertexPtr& vertex,
+                   std::unordered_map<int, int>* chains) noexcept;
+
+  static const int kEmptyChain = 0;  ///< The chain of the Empty terminal.
+  static const int kBaseChain = 1;  ///< The chain of the Base terminal.
+
   const Settings kSettings_;  ///< Analysis settings.
   VertexPtr root_;  ///< The root vertex of ZBDD.
   bool coherent_;  ///< Inherited coherence from BDD.
@@ -862,14 +1004,18 @@ class Zbdd : private boost::noncopyable {
   /// @}
 
   /// Memoization of minimal ZBDD vertices.
-  std::unordered_map<int, VertexPtr> minimal_results_;
+  CacheTable<VertexPtr, int> minimal_results_;
   /// The results of subsume operations over sets.
-  PairTable<VertexPtr> subsume_table_;
+  MemoTable subsume_table_;
   /// The results of pruning operations.
-  PairTable<VertexPtr> prune_results_;
+  MemoTable prune_results_;
 
   std::map<int, std::unique_ptr<Zbdd>> modules_;  ///< Module graphs.
   int set_id_;  ///< Identification assignment for new set graphs.
+
+  std::vector<Chain> chains_;  ///< The chain-reduced final products.
+  std::vector<int> literals_;  ///< The literals of chain runs.
+  int root_chain_;  ///< The root chain of the final products.
 };
 
 namespace zbdd {
@@ -901,6 +1047,16 @@ class CutSetContainer : public Zbdd {
   /// @returns The root vertex of the ZBDD representing the gate cut sets.
   VertexPtr ConvertGate(const Gate& gate) noexcept;
 
+  /// Converts explicit products of variables and modules into cut sets.
+  ///
+  /// @param[in] products  A minimal family of positive products.
+  ///
+  /// @returns The root vertex of the ZBDD representing the products.
+  ///
+  /// @pre Module gates in products are indexed above the gate index bound.
+  VertexPtr
+  ConvertProducts(std::vector<std::vector<const Node*>> products) noexcept;
+
   /// Finds a gate in intermediate cut sets.
   ///
   /// @returns The index of the gate in intermediate cut sets.
@@ -996,6 +1152,19 @@ class CutSetContainer : public Zbdd {
     return node.index() > gate_index_bound_;
   }
 
+  /// Products sorted lexicographically by the variable order.
+  using ProductIterator = std::vector<std::vector<const Node*>>::const_iterator;
+
+  /// Converts a sorted range of products sharing a common prefix.
+  ///
+  /// @param[in] first  The start of the product range.
+  /// @param[in] last  The end of the product range.
+  /// @param[in] depth  The length of the common prefix of the products.
+  ///
+  /// @returns The ZBDD vertex representing the products without the prefix.
+  VertexPtr ConvertProducts(ProductIterator first, ProductIterator last,
+                            int depth) noexcept;
+
   int gate_index_bound_;  ///< The exclusive lower bound for the gate indices.
 };
 
@@ -59,6 +59,44 @@ TEST_P(RiskAnalysisTest, Baobab1L8) {
   EXPECT_EQ(distr, ProductDistribution());
 }
 
+// Concurrent analysis must reproduce the serial results.
+TEST_P(RiskAnalysisTest, Baobab1L6Threads) {
+  std::vector<std::string> input_files = {
+      "./share/scram/input/Baobab/baobab1.xml",
+      "./share/scram/input/Baobab/baobab1-basic-events.xml"};
+  settings.limit_order(6);
+  ASSERT_NO_THROW(ProcessInputFiles(input_files));
+  ASSERT_NO_THROW(analysis->Analyze());
+  std::set<std::set<std::string>> serial = products();
+  EXPECT_EQ(2684, serial.size());
+
+  settings.num_threads(4);
+  ASSERT_NO_THROW(ProcessInputFiles(input_files));
+  ASSERT_NO_THROW(analysis->Analyze());
+  EXPECT_EQ(serial, products());
+  std::vector<int> distr = {0, 1, 1, 70, 400, 2212};
+  EXPECT_EQ(distr, ProductDistribution());
+}
+
+// The concurrent BDD Apply must produce the same function graph.
+TEST_F(RiskAnalysisTest, Baobab1BddThreads) {
+  std::vector<std::string> input_files = {
+      "./share/scram/input/Baobab/baobab1.xml",
+      "./share/scram/input/Baobab/baobab1-basic-events.xml"};
+  settings.algorithm("bdd").limit_order(6).probability_analysis(true);
+  ASSERT_NO_THROW(ProcessInputFiles(input_files));
+  ASSERT_NO_THROW(analysis->Analyze());
+  double p_serial = p_total();
+  EXPECT_NEAR(1.2823e-6, p_serial, 1e-8);
+
+  settings.num_threads(4);
+  ASSERT_NO_THROW(ProcessInputFiles(input_files));
+  ASSERT_NO_THROW(analysis->Analyze());
+  EXPECT_DOUBLE_EQ(p_serial, p_total());
+  std::vector<int> distr = {0, 1, 1, 70, 400, 2212};
+  EXPECT_EQ(distr, ProductDistribution());
+}
+
 TEST_P(RiskAnalysisTest, Baobab1L4Importance) {
   std::vector<std::string> input_files = {
       "./share/scram/input/Baobab/baobab1.xml",
@@ -61,12 +61,22 @@ TEST(ConfigTest, FullSettings) {
   const core::Settings& settings = config.settings();
   EXPECT_EQ(core::Algorithm::kBdd, settings.algorithm());
   EXPECT_FALSE(settings.prime_implicants());
+  EXPECT_TRUE(settings.sort_products());
+  EXPECT_TRUE(settings.fallback());
   EXPECT_TRUE(settings.probability_analysis());
   EXPECT_TRUE(settings.importance_analysis());
   EXPECT_TRUE(settings.uncertainty_analysis());
   EXPECT_TRUE(settings.ccf_analysis());
   EXPECT_TRUE(settings.safety_integrity_levels());
   EXPECT_EQ(core::Approximation::kRareEvent, settings.approximation());
+  EXPECT_EQ(core::VariableOrder::kForce, settings.variable_order());
+  EXPECT_EQ(core::Combination::kQueue, settings.combination());
+  EXPECT_FALSE(settings.preprocessing_pass(
+      core::PreprocessingPass::kBooleanOptimization));
+  EXPECT_FALSE(
+      settings.preprocessing_pass(core::PreprocessingPass::kDecomposition));
+  EXPECT_TRUE(
+      settings.preprocessing_pass(core::PreprocessingPass::kDistributivity));
   EXPECT_EQ(11, settings.limit_order());
   EXPECT_EQ(48, settings.mission_time());
   EXPECT_EQ(1, settings.time_step());
@@ -75,6 +85,16 @@ TEST(ConfigTest, FullSettings) {
   EXPECT_EQ(13, settings.num_quantiles());
   EXPECT_EQ(31, settings.num_bins());
   EXPECT_EQ(97531, settings.seed());
+  EXPECT_EQ(4096, settings.cache_size());
+  EXPECT_EQ(1024, settings.cache_retention());
+  EXPECT_EQ(512, settings.bdd_width());
+  EXPECT_EQ(4, settings.inclusion_exclusion_depth());
+  EXPECT_EQ(256, settings.product_buffer());
+  EXPECT_EQ(3, settings.pass_iterations());
+  EXPECT_EQ(1.5, settings.pass_budget());
+  EXPECT_EQ(2, settings.num_threads());
+  EXPECT_EQ(2, settings.num_workers());
+  EXPECT_EQ(2048, settings.memory_limit());
 }
 
 TEST(ConfigTest, PrimeImplicantsSettings) {
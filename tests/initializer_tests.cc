@@ -17,6 +17,10 @@
 
 #include "initializer.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "error.h"
@@ -96,7 +100,9 @@ TEST(InitializerTest, CorrectEtaInputs) {
                                   "link_instruction.xml",
                                   "link_in_rule.xml",
                                   "test_initiating_event.xml",
-                                  "test_functional_event.xml"};
+                                  "test_functional_event.xml",
+                                  "end_states.xml",
+                                  "end_states_expressions.xml"};
   for (const auto& input : correct_inputs) {
     EXPECT_NO_THROW(Initializer({dir + input}, core::Settings()))
         << " Filename: " << input;
@@ -142,7 +148,8 @@ TEST(InitializerTest, IncorrectEtaInputs) {
       "undefined_arg_collect_formula.xml",
       "mixing_collect_instructions.xml",
       "mixing_collect_instructions_link.xml",
-      "mixing_collect_instructions_fork.xml"};
+      "mixing_collect_instructions_fork.xml",
+      "invalid_end_state.xml"};
   for (const auto& input : incorrect_inputs) {
     EXPECT_THROW(Initializer({dir + input}, core::Settings()), ValidationError)
         << " Filename: " << input;
@@ -225,6 +232,45 @@ TEST(InitializerTest, CorrectProbabilityInputs) {
   }
 }
 
+// Test the tabular reliability data with the model from XML.
+TEST(InitializerTest, CorrectTableInputs) {
+  std::string dir = "./share/scram/input/fta/";
+  const char* correct_inputs[] = {"tabular_data.csv", "tabular_data.tsv"};
+
+  core::Settings settings;
+  settings.probability_analysis(true);
+
+  for (const auto& input : correct_inputs) {
+    std::unique_ptr<Initializer> init;
+    // The table goes first to test the deferred processing.
+    ASSERT_NO_THROW(init = std::make_unique<Initializer>(
+                        std::vector<std::string>{dir + input,
+                                                 dir + "tabular_tree.xml"},
+                        settings))
+        << " Filename: " << input;
+    EXPECT_EQ(4, init->model()->basic_events().size()) << input;
+    EXPECT_EQ(1, init->model()->parameters().size()) << input;
+    EXPECT_DOUBLE_EQ(
+        0.1,
+        init->model()->basic_events().find("PumpOne")->get()->p())
+        << input;
+  }
+}
+
+TEST(InitializerTest, IncorrectTableInputs) {
+  std::string dir = "./share/scram/input/fta/";
+  const char* incorrect_inputs[] = {
+      "tabular_no_header.csv",        "tabular_bad_number.csv",
+      "tabular_bad_distribution.csv", "tabular_bad_arity.csv",
+      "tabular_negative_rate.csv",    "tabular_bad_element.csv",
+      "tabular_redefinition.csv"};
+
+  for (const auto& input : incorrect_inputs) {
+    EXPECT_THROW(Initializer({dir + input}, core::Settings()), ValidationError)
+        << " Filename: " << input;
+  }
+}
+
 // Test incorrect fault tree inputs
 TEST(InitializerTest, IncorrectFtaInputs) {
   std::string dir = "./share/scram/input/fta/";
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2017 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "model_builder.h"
+
+#include <cmath>
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "error.h"
+#include "expression/constant.h"
+#include "expression/exponential.h"
+#include "risk_analysis.h"
+
+namespace scram {
+namespace mef {
+namespace test {
+
+TEST(ModelBuilderTest, AnalyzeBuiltModel) {
+  ModelBuilder builder;
+  Expression* p_a = builder.AddExpression<ConstantExpression>(0.1);
+  Parameter* lambda = builder.AddParameter(
+      "lambda", builder.AddExpression<ConstantExpression>(1e-3));
+  Expression* p_b =
+      builder.AddExpression<Exponential>(lambda, builder.mission_time());
+  BasicEvent* a = builder.AddBasicEvent("A", p_a);
+  BasicEvent* b = builder.AddBasicEvent("B", p_b);
+  Expression* p_c = builder.AddExpression<ConstantExpression>(0.3);
+  BasicEvent* c = builder.AddBasicEvent("C", p_c);
+  HouseEvent* h = builder.AddHouseEvent("H", true);
+
+  FaultTree* fault_tree = builder.AddFaultTree("FT");
+  Gate* top = builder.AddGate("TOP", fault_tree);
+  Gate* inter = builder.AddGate("INTER", fault_tree);
+  auto top_formula = std::make_unique<Formula>(kOr);
+  top_formula->AddArgument(a);
+  top_formula->AddArgument(inter);  // Defined after the use.
+  builder.DefineGate(top, std::move(top_formula));
+  auto inter_formula = std::make_unique<Formula>(kAnd);
+  inter_formula->AddArgument(b);
+  inter_formula->AddArgument(c);
+  inter_formula->AddArgument(h);
+  builder.DefineGate(inter, std::move(inter_formula));
+
+  core::Settings settings;
+  settings.probability_analysis(true).mission_time(100);
+  std::shared_ptr<Model> model;
+  ASSERT_NO_THROW(model = builder.Build(settings));
+  ASSERT_EQ(1, model->fault_trees().size());
+  ASSERT_EQ(1, (*model->fault_trees().begin())->top_events().size());
+  EXPECT_EQ(top, (*model->fault_trees().begin())->top_events().front());
+
+  core::RiskAnalysis analysis(model.get(), settings);
+  analysis.Analyze();
+  ASSERT_EQ(1, analysis.results().size());
+  const auto& result = analysis.results().front();
+  ASSERT_TRUE(result.probability_analysis);
+  double p_inter = (1 - std::exp(-1e-3 * 100)) * 0.3;
+  EXPECT_NEAR(1 - (1 - 0.1) * (1 - p_inter),
+              result.probability_analysis->p_total(), 1e-12);
+}
+
+TEST(ModelBuilderTest, BuildCcfGroup) {
+  ModelBuilder builder;
+  FaultTree* fault_tree = builder.AddFaultTree("FT");
+  Gate* top = builder.AddGate("TOP", fault_tree);
+  CcfGroup* ccf_group = nullptr;
+  ASSERT_NO_THROW(ccf_group = builder.AddCcfGroup<BetaFactorModel>(
+                      "Pumps", {"PumpOne", "PumpTwo"},
+                      builder.AddExpression<ConstantExpression>(0.1),
+                      {builder.AddExpression<ConstantExpression>(0.2)}));
+  ASSERT_EQ(2, ccf_group->members().size());
+  auto formula = std::make_unique<Formula>(kAnd);
+  for (BasicEvent* member : ccf_group->members())
+    formula->AddArgument(member);
+  builder.DefineGate(top, std::move(formula));
+
+  core::Settings settings;
+  settings.ccf_analysis(true);
+  std::shared_ptr<Model> model;
+  ASSERT_NO_THROW(model = builder.Build(settings));
+  for (BasicEvent* member : ccf_group->members())
+    EXPECT_TRUE(member->HasCcf());
+}
+
+TEST(ModelBuilderTest, InvalidConstructs) {
+  ModelBuilder builder;
+  // Invalid probability.
+  EXPECT_THROW(
+      builder.AddBasicEvent("A", builder.AddExpression<ConstantExpression>(2)),
+      ValidationError);
+  // Negative rate.
+  EXPECT_THROW(builder.AddExpression<Exponential>(
+                   builder.AddExpression<ConstantExpression>(-1),
+                   builder.mission_time()),
+               ValidationError);
+  // Redefinition.
+  builder.AddBasicEvent("B");
+  EXPECT_THROW(builder.AddBasicEvent("B"), ValidationError);
+  EXPECT_THROW(builder.AddHouseEvent("B"), ValidationError);
+
+  FaultTree* fault_tree = builder.AddFaultTree("FT");
+  Gate* top = builder.AddGate("TOP", fault_tree);
+  EXPECT_THROW(builder.AddGate("TOP", fault_tree), ValidationError);
+  // Invalid formula arity.
+  auto formula = std::make_unique<Formula>(kAnd);
+  formula->AddArgument(builder.AddBasicEvent("C"));
+  EXPECT_THROW(builder.DefineGate(top, std::move(formula)), ValidationError);
+  // Undefined gate.
+  EXPECT_THROW(builder.Build(core::Settings()), ValidationError);
+}
+
+TEST(ModelBuilderTest, DetectCycles) {
+  ModelBuilder builder;
+  FaultTree* fault_tree = builder.AddFaultTree("FT");
+  Gate* top = builder.AddGate("TOP", fault_tree);
+  Gate* middle = builder.AddGate("MIDDLE", fault_tree);
+  auto top_formula = std::make_unique<Formula>(kOr);
+  top_formula->AddArgument(middle);
+  top_formula->AddArgument(builder.AddBasicEvent("A"));
+  builder.DefineGate(top, std::move(top_formula));
+  auto middle_formula = std::make_unique<Formula>(kOr);
+  middle_formula->AddArgument(top);
+  middle_formula->AddArgument(builder.AddBasicEvent("B"));
+  builder.DefineGate(middle, std::move(middle_formula));
+  EXPECT_THROW(builder.Build(core::Settings()), CycleError);
+}
+
+}  // namespace test
+}  // namespace mef
+}  // namespace scram
@@ -22,6 +22,7 @@
 #include "initializer.h"
 #include "fault_tree.h"
 #include "model.h"
+#include "preprocessor.h"
 #include "settings.h"
 
 namespace scram {
@@ -77,6 +78,7 @@ class GateTest : public ::testing::Test {
     assert(g->args<Gate>().empty());
   }
 
+  Pdag graph;  // The manager of unique indices.
   GatePtr g;  // Main gate for manipulations.
   // Collection of variables for gate input.
   VariablePtr var_one;
@@ -84,7 +86,6 @@ class GateTest : public ::testing::Test {
   VariablePtr var_three;
 
  private:
-  Pdag graph;  // The manager of unique indices.
   std::vector<VariablePtr> vars_;  // For convenience only.
 };
 
@@ -159,6 +160,51 @@ TEST_DUP_ARG_TYPE_CHANGE(Nand, Not)
 #undef TEST_DUP_ARG_TYPE_CHANGE
 #undef ADD_ARG_IGNORE_TEST
 
+// Tracking of structural changes for graph analyses.
+TEST_F(GateTest, GraphRevision) {
+  DefineGate(kAnd, 2);
+  int revision = graph.revision();
+  g->NegateArg(var_one->index());  // The structure is the same.
+  EXPECT_EQ(revision, graph.revision());
+  g->AddArg(var_three);
+  EXPECT_LT(revision, graph.revision());
+  revision = graph.revision();
+  g->EraseArg(var_three->index());
+  EXPECT_LT(revision, graph.revision());
+  revision = graph.revision();
+  g->type(kOr);
+  EXPECT_LT(revision, graph.revision());
+  revision = graph.revision();
+  g->module(true);
+  EXPECT_LT(revision, graph.revision());
+}
+
+// Module detection is skipped for the same revision of the graph.
+TEST_F(GateTest, ModuleDetectionRevision) {
+  class ModuleDetector : public Preprocessor {
+   public:
+    using Preprocessor::Preprocessor;
+    using Preprocessor::DetectModules;
+
+   private:
+    void Run() noexcept override {}
+  };
+  DefineGate(kAnd, 2);
+  graph.root(g);
+  ModuleDetector detector(&graph, Settings());
+  detector.DetectModules();
+  EXPECT_EQ(1, g->EnterTime());
+  EXPECT_TRUE(g->module());
+
+  graph.Clear<Pdag::kVisit>();  // The visit times are not the structure.
+  detector.DetectModules();
+  EXPECT_EQ(0, g->EnterTime()) << "The graph is traversed again.";
+
+  g->AddArg(var_three);
+  detector.DetectModules();
+  EXPECT_EQ(1, g->EnterTime()) << "The changed graph is not traversed.";
+}
+
 TEST_F(GateTest, DuplicateArgXor) {
   DefineGate(kXor, 1);
   g->AddArg(var_one);
@@ -56,12 +56,12 @@ namespace test {
 TEST(RegressionTest, ObjectSize) {
   // x86-64 platform.
   // 64-bit platform with alignment at 8-byte boundaries.
-  EXPECT_EQ(8, sizeof(WeakIntrusivePtr<Vertex<Ite>>));
-  EXPECT_EQ(8, sizeof(IntrusivePtr<Vertex<Ite>>));
-  EXPECT_EQ(16, sizeof(Vertex<Ite>));
-  EXPECT_EQ(48, sizeof(NonTerminal<Ite>));
-  EXPECT_EQ(64, sizeof(Ite));
-  EXPECT_EQ(56, sizeof(SetNode));
+  EXPECT_EQ(4, sizeof(Bdd::Edge));
+  EXPECT_EQ(12, sizeof(Bdd::Node));
+  EXPECT_EQ(8, sizeof(WeakIntrusivePtr<Vertex<SetNode>>));
+  EXPECT_EQ(8, sizeof(IntrusivePtr<Vertex<SetNode>>));
+  EXPECT_EQ(16, sizeof(Vertex<SetNode>));
+  EXPECT_EQ(64, sizeof(SetNode));
 }
 #endif
 
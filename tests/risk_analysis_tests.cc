@@ -17,11 +17,21 @@
 
 #include "risk_analysis_tests.h"
 
+#include <algorithm>
+#include <fstream>
+#include <map>
 #include <sstream>
 #include <utility>
 
+#include <boost/filesystem.hpp>
+#include <boost/range/algorithm.hpp>
 #include <libxml++/libxml++.h>
 
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "checkpoint.h"
 #include "env.h"
 #include "error.h"
 #include "initializer.h"
@@ -40,6 +50,12 @@ void RiskAnalysisTest::SetUp() {
     if (param == "pi") {
       settings.algorithm("bdd");
       settings.prime_implicants(true);
+    } else if (param == "bdd-queue") {
+      settings.algorithm("bdd");
+      settings.combination("queue");
+    } else if (param == "zbdd-force") {
+      settings.algorithm("zbdd");
+      settings.variable_order("force");
     } else {
       settings.algorithm(GetParam());
     }
@@ -237,6 +253,26 @@ TEST_P(RiskAnalysisTest, AnalyzeWithProbability) {
   EXPECT_DOUBLE_EQ(0.2, product_probability().at(mcs_4));
 }
 
+// Products sorted by probability with blocks spilled to disk.
+TEST_P(RiskAnalysisTest, SortProductsOutOfCore) {
+  std::string with_prob =
+      "./share/scram/input/fta/correct_tree_input_with_probs.xml";
+  settings.probability_analysis(true).sort_products(true).product_buffer(1);
+  ASSERT_NO_THROW(ProcessInputFile(with_prob));
+  ASSERT_NO_THROW(analysis->Analyze());
+  const auto& products =
+      analysis->results().front().fault_tree_analysis->products();
+  std::vector<double> probabilities;
+  ASSERT_NO_THROW(products.VisitByProbability(
+      settings.product_buffer(), [&probabilities](const Product& product) {
+        probabilities.push_back(product.p());
+      }));
+  std::vector<double> expected = {0.42, 0.3, 0.28, 0.2};
+  ASSERT_EQ(expected.size(), probabilities.size());
+  for (int i = 0; i < expected.size(); ++i)
+    EXPECT_DOUBLE_EQ(expected[i], probabilities[i]);
+}
+
 // Test for exact probability calculation
 // regardless of the qualitative analysis algorithm.
 TEST_P(RiskAnalysisTest, EnforceExactProbability) {
@@ -333,6 +369,83 @@ TEST_F(RiskAnalysisTest, Mcub) {
   EXPECT_DOUBLE_EQ(0.766144, p_total());
 }
 
+// Apply the truncated inclusion-exclusion with the Bonferroni bounds.
+TEST_F(RiskAnalysisTest, InclusionExclusion) {
+  std::string with_prob =
+      "./share/scram/input/fta/correct_tree_input_with_probs.xml";
+  settings.approximation("inclusion-exclusion").probability_analysis(true);
+  ASSERT_NO_THROW(ProcessInputFile(with_prob));
+  ASSERT_NO_THROW(analysis->Analyze());
+  EXPECT_NEAR(0.73, p_total(), 1e-12);  // The 3rd partial sum.
+  EXPECT_NEAR(0.42, p_lower(), 1e-12);  // The largest product.
+
+  // The expansion is exact with all the intersections of the 4 products.
+  settings.inclusion_exclusion_depth(4);
+  ASSERT_NO_THROW(ProcessInputFile(with_prob));
+  ASSERT_NO_THROW(analysis->Analyze());
+  EXPECT_NEAR(0.646, p_total(), 1e-12);
+  EXPECT_NEAR(0.646, p_lower(), 1e-12);
+}
+
+// The intersection terms of many products with shared sub-families.
+TEST_F(RiskAnalysisTest, InclusionExclusionSharedProducts) {
+  std::string tree_input = "./share/scram/input/core/and_of_ors.xml";
+  settings.probability_analysis(true);
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  ASSERT_NO_THROW(analysis->Analyze());
+  double exact = p_total();
+  EXPECT_NEAR(1.4273e-9, exact, 1e-13);  // 0.28^16
+
+  settings.algorithm("zbdd").approximation("inclusion-exclusion");
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  ASSERT_NO_THROW(analysis->Analyze());
+  EXPECT_EQ(1 << 16, analysis->results()
+                         .front()
+                         .fault_tree_analysis->products()
+                         .size());
+  EXPECT_NEAR(4.3047e-9, p_total(), 1e-13);  // 0.3^16
+  EXPECT_NEAR(6.5536e-12, p_lower(), 1e-16);  // 0.2^16
+  EXPECT_LE(p_lower(), exact);
+  EXPECT_LE(exact, p_total());
+}
+
+// Apply the bounded-width BDD narrow enough to drop vertices.
+TEST_F(RiskAnalysisTest, BoundedWidthBdd) {
+  struct {
+    std::string input;
+    int width;
+    double exact;
+  } cases[] = {{"./share/scram/input/core/atleast.xml", 1, 0.098},
+               {"./share/scram/input/core/atleast_non_coherent.xml", 2, 0.2}};
+  for (const auto& test_case : cases) {
+    for (const char* algorithm : {"bdd", "zbdd", "mocus"}) {
+      settings.algorithm(algorithm).probability_analysis(true);
+      settings.approximation("none");
+      ASSERT_NO_THROW(ProcessInputFile(test_case.input));
+      ASSERT_NO_THROW(analysis->Analyze());
+      double exact = p_total();
+      EXPECT_NEAR(test_case.exact, exact, 1e-12);
+      std::set<std::set<std::string>> exact_products = products();
+
+      settings.approximation("bounds").bdd_width(test_case.width);
+      ASSERT_NO_THROW(ProcessInputFile(test_case.input));
+      ASSERT_NO_THROW(analysis->Analyze());
+      EXPECT_LT(p_lower(), p_total());  // The width truncates the BDD.
+      EXPECT_LE(p_lower(), exact);
+      EXPECT_LE(exact, p_total());
+      // The products of the upper bound function absorb the exact products.
+      EXPECT_NE(exact_products, products());
+      for (const std::set<std::string>& product : exact_products) {
+        EXPECT_TRUE(std::any_of(products().begin(), products().end(),
+                                [&product](const auto& bound_product) {
+                                  return boost::includes(product,
+                                                         bound_product);
+                                }));
+      }
+    }
+  }
+}
+
 // Apply the minimal cut set upper bound approximation for non-coherent tree.
 // This should be a warning.
 TEST_F(RiskAnalysisTest, McubNonCoherent) {
@@ -380,6 +493,98 @@ TEST_P(RiskAnalysisTest, AnalyzeProbabilityOverTime) {
   ASSERT_TRUE(time);
 }
 
+TEST_P(RiskAnalysisTest, AnalyzeUncertaintyOverTime) {
+  std::string tree_input =
+      "./share/scram/input/core/lognormal_exponential.xml";
+  settings.uncertainty_analysis(true).seed(42).mission_time(120);
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  ASSERT_NO_THROW(analysis->Analyze());
+  ASSERT_FALSE(analysis->results().empty());
+  ASSERT_TRUE(analysis->results().front().uncertainty_analysis);
+  const auto& final_analysis =
+      *analysis->results().front().uncertainty_analysis;
+  double final_mean = final_analysis.mean();
+  std::vector<double> final_quantiles = final_analysis.quantiles();
+
+  settings.time_step(24);
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  ASSERT_NO_THROW(analysis->Analyze());
+  ASSERT_FALSE(analysis->results().empty());
+  const auto& result = analysis->results().front();
+  ASSERT_TRUE(result.probability_analysis);
+  ASSERT_TRUE(result.uncertainty_analysis);
+  const auto& p_time = result.probability_analysis->p_time();
+  const auto& ua_time = result.uncertainty_analysis->p_time();
+  ASSERT_EQ(p_time.size(), ua_time.size());
+  for (int i = 0; i < ua_time.size(); ++i) {
+    EXPECT_EQ(p_time[i].second, ua_time[i].time);
+    ASSERT_EQ(settings.num_quantiles(), ua_time[i].quantiles.size());
+    if (!i)
+      continue;  // Nothing fails at the start of the mission.
+    EXPECT_LT(ua_time[i].quantiles.front(), ua_time[i].quantiles.back());
+    // The same deviates are sampled for all the time points.
+    EXPECT_LE(ua_time[i - 1].mean, ua_time[i].mean);
+    for (int j = 0; j < ua_time[i].quantiles.size(); ++j)
+      EXPECT_LE(ua_time[i - 1].quantiles[j], ua_time[i].quantiles[j]);
+  }
+  EXPECT_EQ(final_mean, ua_time.back().mean);
+  EXPECT_EQ(final_quantiles, ua_time.back().quantiles);
+  EXPECT_EQ(final_mean, result.uncertainty_analysis->mean());
+  EXPECT_EQ(final_quantiles, result.uncertainty_analysis->quantiles());
+}
+
+TEST_P(RiskAnalysisTest, AnalyzeImportanceOverTime) {
+  std::string tree_input = "./share/scram/input/core/multiple_exponential.xml";
+  settings.importance_analysis(true).mission_time(120);
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  ASSERT_NO_THROW(analysis->Analyze());
+  ASSERT_FALSE(analysis->results().empty());
+  ASSERT_TRUE(analysis->results().front().importance_analysis);
+  std::map<std::string, ImportanceFactors> final_factors;
+  for (const ImportanceRecord& record :
+       analysis->results().front().importance_analysis->importance()) {
+    final_factors.emplace(record.event.id(), record.factors);
+  }
+  ASSERT_EQ(3, final_factors.size());
+
+  settings.time_step(24);
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  ASSERT_NO_THROW(analysis->Analyze());
+  ASSERT_FALSE(analysis->results().empty());
+  const auto& result = analysis->results().front();
+  ASSERT_TRUE(result.probability_analysis);
+  ASSERT_TRUE(result.importance_analysis);
+  const auto& p_time = result.probability_analysis->p_time();
+  const auto& importance = result.importance_analysis->importance();
+  const auto& importance_time = result.importance_analysis->importance_time();
+  ASSERT_EQ(p_time.size(), importance_time.size());
+  for (int i = 0; i < p_time.size(); ++i) {
+    EXPECT_EQ(p_time[i].second, importance_time[i].time);
+    ASSERT_EQ(importance.size(), importance_time[i].factors.size());
+    ASSERT_EQ(importance.size(), importance_time[i].probabilities.size());
+  }
+  // The factors are undefined at the start of the mission without failures.
+  ASSERT_LT(2, importance_time.size());
+  const ImportanceTimePoint& first = importance_time[1];
+  const ImportanceTimePoint& last = importance_time.back();
+  for (int j = 0; j < importance.size(); ++j) {
+    const ImportanceRecord& record = importance[j];
+    EXPECT_LT(first.probabilities[j], last.probabilities[j]);
+    EXPECT_NE(first.factors[j].mif, last.factors[j].mif) << record.event.id();
+    EXPECT_NE(first.factors[j].dif, last.factors[j].dif) << record.event.id();
+
+    const ImportanceFactors& factors = final_factors.at(record.event.id());
+    EXPECT_EQ(record.event.p(), last.probabilities[j]);
+    EXPECT_EQ(factors.mif, last.factors[j].mif);
+    EXPECT_EQ(factors.cif, last.factors[j].cif);
+    EXPECT_EQ(factors.dif, last.factors[j].dif);
+    EXPECT_EQ(factors.raw, last.factors[j].raw);
+    EXPECT_EQ(factors.rrw, last.factors[j].rrw);
+    EXPECT_EQ(factors.mif, record.factors.mif);
+    EXPECT_EQ(factors.dif, record.factors.dif);
+  }
+}
+
 TEST_P(RiskAnalysisTest, AnalyzeSil) {
   std::string tree_input = "./share/scram/input/core/single_exponential.xml";
   settings.time_step(24).safety_integrity_levels(true);
@@ -424,6 +629,244 @@ TEST_P(RiskAnalysisTest, AnalyzeEventTree) {
   }
 }
 
+TEST_P(RiskAnalysisTest, AnalyzeEndStates) {
+  const char* tree_input = "./share/scram/input/eta/end_states.xml";
+  settings.probability_analysis(true);
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  ASSERT_NO_THROW(analysis->Analyze());
+  ASSERT_EQ(1, analysis->event_tree_results().size());
+  const auto& eta = *analysis->event_tree_results().front();
+  EXPECT_EQ(3, eta.sequences().size());
+  ASSERT_EQ(1, eta.end_states().size());
+  EXPECT_EQ("Damage", eta.end_states().front().sequence.name());
+  // The product shared by the sequences is not double-counted.
+  double p_damage = settings.approximation() == Approximation::kNone
+                        ? 1 - 0.9 * 0.8 * 0.7
+                        : 0.1 + 0.2 + 0.3;
+  EXPECT_NEAR(p_damage, eta.end_states().front().p_sequence, 1e-12);
+
+  ASSERT_EQ(4, analysis->results().size());  // The end state is the last.
+  std::set<std::set<std::string>> products;
+  for (const Product& product :
+       analysis->results().back().fault_tree_analysis->products()) {
+    std::set<std::string> names;
+    for (const Literal& literal : product)
+      names.insert(literal.event.id());
+    products.insert(names);
+  }
+  std::set<std::set<std::string>> mcs = {{"A"}, {"B"}, {"C"}};
+  EXPECT_EQ(mcs, products);
+}
+
+// The paths without collect instructions are not summed with the expressions.
+TEST_P(RiskAnalysisTest, AnalyzeExpressionEndStates) {
+  const char* tree_input =
+      "./share/scram/input/eta/end_states_expressions.xml";
+  settings.probability_analysis(true);
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  ASSERT_NO_THROW(analysis->Analyze());
+  ASSERT_EQ(1, analysis->event_tree_results().size());
+  const auto& eta = *analysis->event_tree_results().front();
+  EXPECT_EQ(3, eta.sequences().size());
+  ASSERT_EQ(1, eta.end_states().size());
+  EXPECT_TRUE(eta.end_states().front().is_expression_only);
+  EXPECT_NEAR(0.1 + 0.2, eta.end_states().front().p_sequence, 1e-12);
+}
+
+// The shards partition the targets of the full analysis.
+TEST_P(RiskAnalysisTest, AnalyzeShards) {
+  const char* tree_input = "./share/scram/input/EventTrees/bcd.xml";
+  settings.probability_analysis(true);
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  ASSERT_NO_THROW(analysis->Analyze());
+  int num_targets = analysis->results().size();
+  const int kNumShards = 3;
+  int num_shard_targets = 0;
+  int num_sequences = 0;
+  for (int i = 1; i <= kNumShards; ++i) {
+    settings.shard(i, kNumShards);
+    ASSERT_NO_THROW(ProcessInputFile(tree_input));
+    ASSERT_NO_THROW(analysis->Analyze());
+    num_shard_targets += analysis->results().size();
+    for (const auto& eta : analysis->event_tree_results())
+      num_sequences += eta->sequences().size();
+  }
+  EXPECT_EQ(num_targets, num_shard_targets);
+  EXPECT_EQ(2, num_sequences);
+}
+
+// The merged report keeps the warnings of all the shards.
+TEST_F(RiskAnalysisTest, MergeShardWarnings) {
+  namespace fs = boost::filesystem;
+  const char* tree_input = "./share/scram/input/EventTrees/bcd.xml";
+  const char* kWarning = "The analysis of the second shard failed.";
+  settings.probability_analysis(true);
+  std::vector<std::string> shards;
+  for (int i = 1; i <= 2; ++i) {
+    settings.shard(i, 2);
+    ASSERT_NO_THROW(ProcessInputFile(tree_input));
+    ASSERT_NO_THROW(analysis->Analyze());
+    std::stringstream output;
+    ASSERT_NO_THROW(Reporter().Report(*analysis, output));
+    std::string report = output.str();
+    if (i == 2) {
+      std::string::size_type pos = report.find("</information>");
+      ASSERT_NE(std::string::npos, pos);
+      report.insert(pos, "<warning>" + std::string(kWarning) + "</warning>");
+    }
+    shards.push_back(
+        (fs::temp_directory_path() / fs::unique_path("%%%%-%%%%.xml"))
+            .string());
+    std::ofstream(shards.back()) << report;
+  }
+  std::stringstream merged;
+  ASSERT_NO_THROW(Reporter().Merge(shards, merged));
+  EXPECT_NE(std::string::npos, merged.str().find(kWarning));
+  for (const std::string& shard : shards)
+    fs::remove(shard);
+}
+
+// Reuse of the checkpoints of targets unchanged since the previous run.
+TEST_P(RiskAnalysisTest, CheckpointUnchangedTargets) {
+  namespace fs = boost::filesystem;
+  std::string tree_input = "./share/scram/input/fta/constant_propagation.xml";
+  std::string directory =
+      (fs::temp_directory_path() / fs::unique_path()).string();
+  settings.probability_analysis(true);
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  {
+    Checkpoint checkpoint(directory, settings, /*resume=*/false);
+    ASSERT_NO_THROW(analysis->Analyze(&checkpoint));
+    EXPECT_FALSE(analysis->results().front().restored);
+  }
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  {
+    Checkpoint checkpoint(directory, settings, /*resume=*/true);
+    ASSERT_NO_THROW(analysis->Analyze(&checkpoint));
+    ASSERT_EQ(1, analysis->results().size());
+    EXPECT_TRUE(analysis->results().front().restored);
+    std::stringstream output;
+    EXPECT_NO_THROW(Reporter(&checkpoint).Report(*analysis, output));
+  }
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  house_events().find("h2")->get()->state(true);  // The model revision.
+  {
+    Checkpoint checkpoint(directory, settings, /*resume=*/true);
+    ASSERT_NO_THROW(analysis->Analyze(&checkpoint));
+    EXPECT_FALSE(analysis->results().front().restored);
+    EXPECT_DOUBLE_EQ(1, p_total());
+  }
+  settings.importance_analysis(true);
+  EXPECT_THROW(Checkpoint(directory, settings, /*resume=*/true),
+               ValidationError);
+  fs::remove_all(directory);
+}
+
+// The restored probabilities of targets are exact.
+TEST_P(RiskAnalysisTest, CheckpointRoundTrip) {
+  namespace fs = boost::filesystem;
+  const char* tree_input = "./share/scram/input/eta/end_states.xml";
+  std::string directory =
+      (fs::temp_directory_path() / fs::unique_path()).string();
+  settings.probability_analysis(true);
+  auto get_probabilities = [this] {
+    std::map<std::string, double> p_sequences;
+    const auto& eta = *analysis->event_tree_results().front();
+    for (const auto* results : {&eta.sequences(), &eta.end_states()}) {
+      for (const auto& result : *results)
+        p_sequences.emplace(result.sequence.name(), result.p_sequence);
+    }
+    return p_sequences;
+  };
+  std::map<std::string, double> p_sequences;
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  {
+    Checkpoint checkpoint(directory, settings, /*resume=*/false);
+    ASSERT_NO_THROW(analysis->Analyze(&checkpoint));
+    p_sequences = get_probabilities();
+  }
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  {
+    Checkpoint checkpoint(directory, settings, /*resume=*/true);
+    ASSERT_NO_THROW(analysis->Analyze(&checkpoint));
+    for (const auto& result : analysis->results())
+      EXPECT_TRUE(result.restored);
+    EXPECT_EQ(p_sequences, get_probabilities());
+  }
+  fs::remove_all(directory);
+}
+
+// The worker processes reproduce the analysis within the main process.
+TEST_F(RiskAnalysisTest, IsolatedWorkers) {
+  namespace fs = boost::filesystem;
+  const char* tree_input = "./share/scram/input/eta/end_states.xml";
+  std::string directory =
+      (fs::temp_directory_path() / fs::unique_path()).string();
+  settings.probability_analysis(true);
+  auto get_probabilities = [this] {
+    std::map<std::string, double> p_sequences;
+    const auto& eta = *analysis->event_tree_results().front();
+    for (const auto* results : {&eta.sequences(), &eta.end_states()}) {
+      for (const auto& result : *results)
+        p_sequences.emplace(result.sequence.name(), result.p_sequence);
+    }
+    return p_sequences;
+  };
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  ASSERT_NO_THROW(analysis->Analyze());
+  std::map<std::string, double> p_sequences = get_probabilities();
+
+  settings.num_workers(2);
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  Checkpoint checkpoint(directory, settings, /*resume=*/false);
+  ASSERT_NO_THROW(analysis->Analyze(&checkpoint));
+  for (const auto& result : analysis->results()) {
+    EXPECT_TRUE(result.restored);
+    EXPECT_TRUE(result.warning.empty());
+  }
+  EXPECT_EQ(p_sequences, get_probabilities());
+  fs::remove_all(directory);
+}
+
+#ifdef __linux__
+// The worker out of memory is retried with the cheaper analysis.
+TEST_F(RiskAnalysisTest, IsolatedWorkerFallback) {
+  namespace fs = boost::filesystem;
+  const char* tree_input = "./share/scram/input/core/parity.xml";
+  std::string directory =
+      (fs::temp_directory_path() / fs::unique_path()).string();
+  // The prime implicants of the parity function exhaust the memory
+  // left above the address space of this process.
+  long num_pages = 0;
+  std::ifstream("/proc/self/statm") >> num_pages;
+  int memory = num_pages * ::sysconf(_SC_PAGESIZE) >> 20;
+  settings.algorithm("bdd").prime_implicants(true).probability_analysis(true);
+  settings.num_workers(2).memory_limit(memory + 256).fallback(true);
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  {
+    Checkpoint checkpoint(directory, settings, /*resume=*/false);
+    ASSERT_NO_THROW(analysis->Analyze(&checkpoint));
+    ASSERT_EQ(1, analysis->results().size());
+    EXPECT_TRUE(analysis->results().front().restored);
+    EXPECT_NE(std::string::npos,
+              analysis->results().front().warning.find("retried"));
+  }
+  // The warning of the fallback is restored with the results.
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  {
+    Checkpoint checkpoint(directory, settings, /*resume=*/true);
+    ASSERT_NO_THROW(analysis->Analyze(&checkpoint));
+    EXPECT_TRUE(analysis->results().front().restored);
+    EXPECT_NE(std::string::npos,
+              analysis->results().front().warning.find("retried"));
+    std::stringstream output;
+    ASSERT_NO_THROW(Reporter(&checkpoint).Report(*analysis, output));
+    EXPECT_NE(std::string::npos, output.str().find("retried"));
+  }
+  fs::remove_all(directory);
+}
+#endif
+
 TEST_P(RiskAnalysisTest, AnalyzeTestEventDefault) {
   const char* tree_input = "./share/scram/input/eta/test_event_default.xml";
   settings.probability_analysis(true);
@@ -514,6 +957,12 @@ TEST_F(RiskAnalysisTest, ReportImportanceFactors) {
   CheckReport(tree_input);
 }
 
+TEST_F(RiskAnalysisTest, ReportImportanceOverTime) {
+  std::string tree_input = "./share/scram/input/core/single_exponential.xml";
+  settings.importance_analysis(true).time_step(24).mission_time(120);
+  CheckReport(tree_input);
+}
+
 // Reporting of uncertainty analysis.
 TEST_F(RiskAnalysisTest, ReportUncertaintyResults) {
   std::string tree_input =
@@ -522,6 +971,12 @@ TEST_F(RiskAnalysisTest, ReportUncertaintyResults) {
   CheckReport(tree_input);
 }
 
+TEST_F(RiskAnalysisTest, ReportUncertaintyCurve) {
+  std::string tree_input = "./share/scram/input/core/single_exponential.xml";
+  settings.uncertainty_analysis(true).time_step(24).mission_time(720);
+  CheckReport(tree_input);
+}
+
 // Reporting event tree analysis with an initiating event.
 TEST_F(RiskAnalysisTest, ReportInitiatingEventAnalysis) {
   const char* tree_input = "./share/scram/input/EventTrees/bcd.xml";
@@ -529,6 +984,13 @@ TEST_F(RiskAnalysisTest, ReportInitiatingEventAnalysis) {
   CheckReport(tree_input);
 }
 
+// Reporting of sequences grouped into end states.
+TEST_F(RiskAnalysisTest, ReportEndStates) {
+  const char* tree_input = "./share/scram/input/eta/end_states.xml";
+  settings.probability_analysis(true);
+  CheckReport(tree_input);
+}
+
 // Reporting of CCF analysis.
 TEST_F(RiskAnalysisTest, ReportCCF) {
   std::string tree_input = "./share/scram/input/core/mgl_ccf.xml";
@@ -607,6 +1069,65 @@ TEST_P(RiskAnalysisTest, ConstantGates) {
   EXPECT_EQ(kUnity, products());
 }
 
+// Disjoint ranges of products for concurrent processing.
+TEST_P(RiskAnalysisTest, PartitionProducts) {
+  std::string tree_input = "./share/scram/input/ThreeMotor/three_motor.xml";
+  settings.probability_analysis(true).num_threads(4);
+  ASSERT_NO_THROW(ProcessInputFile(tree_input));
+  ASSERT_NO_THROW(analysis->Analyze());
+  const ProductContainer& container =
+      analysis->results().front().fault_tree_analysis->products();
+  auto to_ids = [](const Product& product) {
+    std::vector<std::string> ids;
+    for (const Literal& literal : product)
+      ids.push_back((literal.complement ? "not " : "") + literal.event.id());
+    return ids;
+  };
+  std::vector<std::vector<std::string>> whole;
+  std::vector<int> distribution;
+  double sum = 0;
+  for (const Product& product : container) {
+    whole.push_back(to_ids(product));
+    if (distribution.size() < product.order())
+      distribution.resize(product.order());
+    distribution[product.order() - 1]++;
+    sum += product.p();
+  }
+  std::vector<ProductContainer::Range> ranges = container.Partition(4);
+  EXPECT_FALSE(ranges.empty());
+  EXPECT_GE(4, ranges.size());
+  std::vector<std::vector<std::string>> joined;
+  for (const ProductContainer::Range& range : ranges) {
+    for (const Product& product : range)
+      joined.push_back(to_ids(product));
+  }
+  EXPECT_EQ(whole, joined);
+  EXPECT_EQ(distribution, container.Distribution());
+  EXPECT_NEAR(sum, container.SumProbabilities(), 1e-12);
+}
+
+// Cut sets of MOCUS with dense bitset families
+// and with the fallback to the ZBDD expansion past the family size limit.
+TEST_F(RiskAnalysisTest, DenseModuleCutSets) {
+  std::string tree_input = "./share/scram/input/core/wide_atleast.xml";
+  // The distributions with the bitset families and with the fallback.
+  std::map<int, std::vector<int>> distributions = {{4, {0, 6}},
+                                                   {5, {0, 6, 0, 0, 5733}}};
+  for (const auto& entry : distributions) {
+    settings.limit_order(entry.first);
+    settings.algorithm("zbdd");
+    ASSERT_NO_THROW(ProcessInputFile(tree_input));
+    ASSERT_NO_THROW(analysis->Analyze());
+    std::set<std::set<std::string>> expected = products();
+
+    settings.algorithm("mocus");
+    ASSERT_NO_THROW(ProcessInputFile(tree_input));
+    ASSERT_NO_THROW(analysis->Analyze());
+    EXPECT_EQ(expected, products()) << entry.first;
+    EXPECT_EQ(entry.second, ProductDistribution()) << entry.first;
+  }
+}
+
 // Mixed roles with undefined event types
 TEST_F(RiskAnalysisTest, UndefinedEventsMixedRoles) {
   std::string tree_input =
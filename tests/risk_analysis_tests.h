@@ -82,6 +82,12 @@ class RiskAnalysisTest : public ::testing::TestWithParam<const char*> {
     return analysis->results().front().probability_analysis->p_total();
   }
 
+  double p_lower() {
+    assert(analysis->results().size() == 1);
+    assert(analysis->results().front().probability_analysis);
+    return analysis->results().front().probability_analysis->p_lower();
+  }
+
   /// @returns Products and their probabilities.
   const std::map<std::set<std::string>, double>& product_probability();
 
@@ -31,6 +31,10 @@ TEST(SettingsTest, IncorrectSetup) {
   EXPECT_THROW(s.algorithm("the-best"), InvalidArgument);
   // Incorrect approximation argument.
   EXPECT_THROW(s.approximation("approx"), InvalidArgument);
+  // Incorrect variable ordering heuristic.
+  EXPECT_THROW(s.variable_order("random"), InvalidArgument);
+  // Incorrect argument combination order.
+  EXPECT_THROW(s.combination("random"), InvalidArgument);
   // Incorrect limit order for products.
   EXPECT_THROW(s.limit_order(-1), InvalidArgument);
   // Incorrect cut-off probability.
@@ -47,6 +51,35 @@ TEST(SettingsTest, IncorrectSetup) {
   EXPECT_THROW(s.num_bins(0), InvalidArgument);
   // Incorrect seed.
   EXPECT_THROW(s.seed(-1), InvalidArgument);
+  // Incorrect size of computation caches.
+  EXPECT_THROW(s.cache_size(-10), InvalidArgument);
+  EXPECT_THROW(s.cache_size(0), InvalidArgument);
+  // Incorrect number of retained cache entries.
+  EXPECT_THROW(s.cache_retention(-1), InvalidArgument);
+  // Incorrect approximate BDD width.
+  EXPECT_THROW(s.bdd_width(-1), InvalidArgument);
+  EXPECT_THROW(s.bdd_width(0), InvalidArgument);
+  // Incorrect inclusion-exclusion depth.
+  EXPECT_THROW(s.inclusion_exclusion_depth(-1), InvalidArgument);
+  EXPECT_THROW(s.inclusion_exclusion_depth(0), InvalidArgument);
+  // Incorrect product buffer size.
+  EXPECT_THROW(s.product_buffer(-1), InvalidArgument);
+  EXPECT_THROW(s.product_buffer(0), InvalidArgument);
+  // Incorrect preprocessing pass setup.
+  EXPECT_THROW(s.preprocessing_pass("coalescing", false), InvalidArgument);
+  EXPECT_THROW(s.pass_iterations(-1), InvalidArgument);
+  EXPECT_THROW(s.pass_budget(-1), InvalidArgument);
+  // Incorrect shards.
+  EXPECT_THROW(s.shard(1, 0), InvalidArgument);
+  EXPECT_THROW(s.shard(0, 2), InvalidArgument);
+  EXPECT_THROW(s.shard(3, 2), InvalidArgument);
+  // Incorrect number of threads.
+  EXPECT_THROW(s.num_threads(-1), InvalidArgument);
+  EXPECT_THROW(s.num_threads(0), InvalidArgument);
+  // Incorrect number of worker processes.
+  EXPECT_THROW(s.num_workers(-1), InvalidArgument);
+  // Incorrect memory limit of worker processes.
+  EXPECT_THROW(s.memory_limit(-1), InvalidArgument);
   // Incorrect mission time.
   EXPECT_THROW(s.mission_time(-10), InvalidArgument);
   // Incorrect time step.
@@ -69,6 +102,21 @@ TEST(SettingsTest, CorrectSetup) {
   // Correct approximation argument.
   EXPECT_NO_THROW(s.approximation("rare-event"));
   EXPECT_NO_THROW(s.approximation("mcub"));
+  EXPECT_NO_THROW(s.approximation("bounds"));
+  EXPECT_NO_THROW(s.approximation("inclusion-exclusion"));
+
+  // Correct variable ordering heuristic.
+  EXPECT_NO_THROW(s.variable_order("topological"));
+  EXPECT_NO_THROW(s.variable_order("force"));
+  EXPECT_NO_THROW(s.variable_order("weighted-dfs"));
+  EXPECT_NO_THROW(s.variable_order("fan-out"));
+  EXPECT_NO_THROW(s.variable_order("best"));
+
+  // Correct argument combination order.
+  EXPECT_NO_THROW(s.combination("order"));
+  EXPECT_NO_THROW(s.combination("balanced"));
+  EXPECT_NO_THROW(s.combination("size"));
+  EXPECT_NO_THROW(s.combination("queue"));
 
   // Correct limit order for products.
   EXPECT_NO_THROW(s.limit_order(1));
@@ -95,6 +143,55 @@ TEST(SettingsTest, CorrectSetup) {
   // Correct seed.
   EXPECT_NO_THROW(s.seed(1));
 
+  // Correct size of computation caches.
+  EXPECT_NO_THROW(s.cache_size(1));
+  EXPECT_NO_THROW(s.cache_size(1e6));
+
+  // Correct number of retained cache entries.
+  EXPECT_NO_THROW(s.cache_retention(0));
+  EXPECT_NO_THROW(s.cache_retention(1e6));
+
+  // Correct approximate BDD width.
+  EXPECT_NO_THROW(s.bdd_width(1));
+  EXPECT_NO_THROW(s.bdd_width(1e4));
+
+  // Correct inclusion-exclusion depth.
+  EXPECT_NO_THROW(s.inclusion_exclusion_depth(1));
+  EXPECT_NO_THROW(s.inclusion_exclusion_depth(4));
+
+  // Correct product buffer size.
+  EXPECT_NO_THROW(s.product_buffer(1));
+  EXPECT_NO_THROW(s.product_buffer(1e6));
+
+  // Correct preprocessing pass setup.
+  EXPECT_NO_THROW(s.preprocessing_pass("boolean-optimization", false));
+  EXPECT_FALSE(
+      s.preprocessing_pass(PreprocessingPass::kBooleanOptimization));
+  EXPECT_TRUE(s.preprocessing_pass(PreprocessingPass::kDecomposition));
+  EXPECT_NO_THROW(s.preprocessing_pass("boolean-optimization", true));
+  EXPECT_TRUE(
+      s.preprocessing_pass(PreprocessingPass::kBooleanOptimization));
+  EXPECT_NO_THROW(s.pass_iterations(0));
+  EXPECT_NO_THROW(s.pass_iterations(3));
+  EXPECT_NO_THROW(s.pass_budget(0));
+  EXPECT_NO_THROW(s.pass_budget(0.5));
+
+  // Correct shards.
+  EXPECT_NO_THROW(s.shard(1, 1));
+  EXPECT_NO_THROW(s.shard(2, 2));
+
+  // Correct number of threads.
+  EXPECT_NO_THROW(s.num_threads(1));
+  EXPECT_NO_THROW(s.num_threads(8));
+
+  // Correct number of worker processes.
+  EXPECT_NO_THROW(s.num_workers(0));
+  EXPECT_NO_THROW(s.num_workers(4));
+
+  // Correct memory limit of worker processes.
+  EXPECT_NO_THROW(s.memory_limit(0));
+  EXPECT_NO_THROW(s.memory_limit(1024));
+
   // Correct mission time.
   EXPECT_NO_THROW(s.mission_time(0));
   EXPECT_NO_THROW(s.mission_time(10));
@@ -122,6 +219,8 @@ TEST(SettingsTest, SetupForPrimeImplicants) {
   EXPECT_NO_THROW(s.approximation("none"));
   EXPECT_THROW(s.approximation("rare-event"), InvalidArgument);
   EXPECT_THROW(s.approximation("mcub"), InvalidArgument);
+  EXPECT_THROW(s.approximation("bounds"), InvalidArgument);
+  EXPECT_THROW(s.approximation("inclusion-exclusion"), InvalidArgument);
 }
 
 }  // namespace test
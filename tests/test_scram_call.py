@@ -16,6 +16,7 @@
 """Tests to command-line SCRAM with correct and incorrect arguments."""
 
 import os
+import shutil
 from subprocess import call
 
 from nose.tools import assert_equal, assert_not_equal
@@ -100,6 +101,16 @@ def test_fta_calls():
            "--num-quantiles", "20"]
     yield assert_equal, 0, call(cmd)
 
+    # Test the preprocessing pass setup
+    cmd = ["scram", fta_input, "--skip-pass", "boolean-optimization",
+           "--skip-pass", "decomposition", "--pass-iterations", "2",
+           "--pass-budget", "0.5"]
+    yield assert_equal, 0, call(cmd)
+    cmd = ["scram", fta_input, "--skip-pass", "coalescing"]
+    yield assert_not_equal, 0, call(cmd)
+    cmd = ["scram", fta_input, "--pass-budget", "-1"]
+    yield assert_not_equal, 0, call(cmd)
+
     # Test calls for prime implicants
     cmd = ["scram", fta_input, "--prime-implicants", "--mocus"]
     yield assert_not_equal, 0, call(cmd)
@@ -109,6 +120,98 @@ def test_fta_calls():
     yield assert_not_equal, 0, call(cmd)
 
 
+def test_shard_calls():
+    """Tests calls for sharded analysis and merging of shard reports."""
+    eta_input = "./input/EventTrees/bcd.xml"
+    shards = ["./shard_1_temp.xml", "./shard_2_temp.xml"]
+    for i, shard in enumerate(shards, 1):
+        cmd = ["scram", eta_input, "--shard", "%d/2" % i, "-o", shard]
+        yield assert_equal, 0, call(cmd)
+
+    cmd = ["scram", "--merge"] + shards
+    yield assert_equal, 0, call(cmd)
+
+    # Missing shard reports
+    cmd = ["scram", "--merge", shards[0]]
+    yield assert_not_equal, 0, call(cmd)
+
+    # Sharded merging
+    cmd = ["scram", "--merge", "--shard", "1/2"] + shards
+    yield assert_not_equal, 0, call(cmd)
+
+    for shard in shards:
+        if os.path.isfile(shard):
+            os.remove(shard)
+
+    # Invalid shards
+    cmd = ["scram", eta_input, "--shard", "3/2"]
+    yield assert_not_equal, 0, call(cmd)
+    cmd = ["scram", eta_input, "--shard", "1-2"]
+    yield assert_not_equal, 0, call(cmd)
+
+
+def test_checkpoint_calls():
+    """Tests calls with checkpoints of analysis targets."""
+    eta_input = "./input/EventTrees/bcd.xml"
+    checkpoint = "./checkpoint_temp"
+    cmd = ["scram", eta_input, "--probability", "1",
+           "--checkpoint", checkpoint]
+    yield assert_equal, 0, call(cmd)
+    yield assert_equal, 0, call(cmd + ["--resume"])
+
+    # Resumption with different settings
+    cmd = ["scram", eta_input, "--checkpoint", checkpoint, "--resume"]
+    yield assert_not_equal, 0, call(cmd)
+
+    # Resumption without checkpoints
+    cmd = ["scram", eta_input, "--resume"]
+    yield assert_not_equal, 0, call(cmd)
+
+    if os.path.isdir(checkpoint):
+        shutil.rmtree(checkpoint)
+
+
+def test_batch_calls():
+    """Tests calls with configuration files as batch jobs."""
+    config_file = "./input/fta/pi_configuration.xml"
+    out_temp = "./input/fta/temp_results.xml"
+    cmd = ["scram", "--batch", config_file]
+    yield assert_equal, 0, call(cmd)
+    yield assert_equal, 0, call(cmd + ["--batch-jobs", "2", "--ccf", "0"])
+
+    # Failure of a job
+    cmd = ["scram", "--batch", "--batch-jobs", "2", config_file,
+           "./input/fta/invalid_configuration.xml"]
+    yield assert_not_equal, 0, call(cmd)
+    if os.path.isfile(out_temp):
+        os.remove(out_temp)
+
+    # Invalid batch arguments
+    cmd = ["scram", "--batch"]
+    yield assert_not_equal, 0, call(cmd)
+    cmd = ["scram", "--batch", config_file, "-o", "output_temp.xml"]
+    yield assert_not_equal, 0, call(cmd)
+    cmd = ["scram", "--batch", config_file, "--batch-jobs", "0"]
+    yield assert_not_equal, 0, call(cmd)
+
+
+def test_isolated_calls():
+    """Tests calls with the analysis of targets in worker processes."""
+    fta_input = "./input/fta/correct_tree_input_with_probs.xml"
+    cmd = ["scram", fta_input, "--probability", "1", "--num-workers", "2"]
+    yield assert_equal, 0, call(cmd)
+    eta_input = "./input/EventTrees/bcd.xml"
+    cmd = ["scram", eta_input, "--num-workers", "2", "--memory-limit", "4096",
+           "--fallback"]
+    yield assert_equal, 0, call(cmd)
+
+    # Invalid limits
+    cmd = ["scram", fta_input, "--num-workers", "-1"]
+    yield assert_not_equal, 0, call(cmd)
+    cmd = ["scram", fta_input, "--num-workers", "1", "--memory-limit", "-1"]
+    yield assert_not_equal, 0, call(cmd)
+
+
 def test_config_file():
     """Tests calls with configuration files."""
     # Test with a configuration file
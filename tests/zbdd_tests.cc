@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2017 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "zbdd.h"
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "event.h"
+#include "fault_tree_analysis.h"
+
+namespace scram {
+namespace core {
+namespace test {
+
+// Variable signatures rule out subsumption of unrelated sets.
+TEST(ZbddTest, SetNodeSignatures) {
+  const int a = 1, b = 2, c = 3;
+  // The test relies on distinct Bloom filter bits of the variables.
+  ASSERT_NE(SetNode::GetSignatureBit(a), SetNode::GetSignatureBit(b));
+  ASSERT_NE(SetNode::GetSignatureBit(a), SetNode::GetSignatureBit(c));
+  ASSERT_NE(SetNode::GetSignatureBit(b), SetNode::GetSignatureBit(c));
+
+  IntrusivePtr<Vertex<SetNode>> base(new Terminal<SetNode>(true));
+  IntrusivePtr<Vertex<SetNode>> empty(new Terminal<SetNode>(false));
+  int id = 2;
+  auto make_node = [&id](int index, const IntrusivePtr<Vertex<SetNode>>& high,
+                         const IntrusivePtr<Vertex<SetNode>>& low) {
+    SetNodePtr node(new SetNode(index, index, id++, high, low));
+    node->Summarize();
+    return node;
+  };
+  SetNodePtr set_b = make_node(b, base, empty);  // {{b}}
+  SetNodePtr set_ab = make_node(a, set_b, empty);  // {{a, b}}
+  SetNodePtr set_c = make_node(c, base, empty);  // {{c}}
+  SetNodePtr set_a_c = make_node(a, base, set_c);  // {{a}, {c}}
+  SetNodePtr set_ab_a = make_node(a, set_b, base);  // {{a, b}, {}}
+
+  EXPECT_EQ(SetNode::GetSignatureBit(a) | SetNode::GetSignatureBit(b),
+            set_ab->signature());
+  EXPECT_EQ(set_ab->signature(), set_ab->common_signature());
+  EXPECT_EQ(0, set_a_c->common_signature());
+  EXPECT_EQ(0, set_ab_a->common_signature());
+
+  EXPECT_TRUE(set_ab->MaySubsume(*set_b));
+  EXPECT_TRUE(set_ab->MaySubsume(*set_ab));
+  EXPECT_FALSE(set_ab->MaySubsume(*set_c));  // {c} is not in {a, b}.
+  EXPECT_FALSE(set_b->MaySubsume(*set_ab));  // {a, b} is larger than {b}.
+  EXPECT_TRUE(set_ab->MaySubsume(*set_a_c));  // {a} is a subset.
+  EXPECT_TRUE(set_c->MaySubsume(*set_a_c));  // {c} is a subset.
+}
+
+// Products from multi-literal chains and module proxies
+// with the order cut-off applied upon the iteration.
+TEST(ZbddTest, ChainIterationWithLimitOrder) {
+  std::vector<std::unique_ptr<mef::BasicEvent>> events;
+  auto event = [&events](const char* name) {
+    events.push_back(std::make_unique<mef::BasicEvent>(name));
+    return events.back().get();
+  };
+  auto formula = [](mef::Operator type,
+                    std::vector<mef::Formula::EventArg> args) {
+    auto result = std::make_unique<mef::Formula>(type);
+    for (const mef::Formula::EventArg& arg : args)
+      result->AddArgument(arg);
+    return result;
+  };
+  // ((a & b & c) | d) & ((e & f & g) | h)
+  // The modules of the AND gates are single chains of three literals,
+  // which are joined over the order limit only upon the iteration.
+  mef::Gate abc("ABC"), efg("EFG"), left("Left"), right("Right"), top("Top");
+  abc.formula(formula(mef::kAnd, {event("a"), event("b"), event("c")}));
+  efg.formula(formula(mef::kAnd, {event("e"), event("f"), event("g")}));
+  left.formula(formula(mef::kOr, {&abc, event("d")}));
+  right.formula(formula(mef::kOr, {&efg, event("h")}));
+  top.formula(formula(mef::kAnd, {&left, &right}));
+
+  std::map<int, std::set<std::set<std::string>>> expected = {
+      {3, {{"d", "h"}}},
+      {5, {{"d", "h"}, {"a", "b", "c", "h"}, {"d", "e", "f", "g"}}},
+      {6,
+       {{"d", "h"},
+        {"a", "b", "c", "h"},
+        {"d", "e", "f", "g"},
+        {"a", "b", "c", "e", "f", "g"}}}};
+  for (const auto& entry : expected) {
+    Settings settings;
+    settings.limit_order(entry.first);
+    FaultTreeAnalyzer<Zbdd> analysis(top, settings);
+    analysis.Analyze();
+    std::set<std::set<std::string>> products;
+    for (const Product& product : analysis.products()) {
+      std::set<std::string> ids;
+      for (const Literal& literal : product)
+        ids.insert(literal.event.id());
+      products.insert(ids);
+    }
+    EXPECT_EQ(entry.second, products) << entry.first;
+    EXPECT_FALSE(analysis.algorithm()->base());
+  }
+}
+
+// Prime implicants of the BDD with the memoized consensus calculations
+// compared with the brute-force enumeration of all the implicants.
+TEST(ZbddTest, PrimeImplicantsWithLimitOrder) {
+  const std::vector<std::string> names = {"a", "b", "c", "d", "e", "f", "g"};
+  std::vector<std::unique_ptr<mef::BasicEvent>> events;
+  for (const std::string& name : names)
+    events.push_back(std::make_unique<mef::BasicEvent>(name));
+  auto formula = [](mef::Operator type,
+                    std::vector<mef::Formula::EventArg> args) {
+    auto result = std::make_unique<mef::Formula>(type);
+    for (const mef::Formula::EventArg& arg : args)
+      result->AddArgument(arg);
+    return result;
+  };
+  auto* a = events[0].get(), *b = events[1].get(), *c = events[2].get(),
+      *d = events[3].get(), *e = events[4].get(), *f = events[5].get(),
+      *g = events[6].get();
+  // (e & ~f) | (g & (a ^ b)) | (~g & c & d)
+  // The XOR gate is a non-coherent module
+  // reached over the order limit after the g variable.
+  mef::Gate not_f("NotF"), not_g("NotG"), xor_ab("XorAB"), ef("EF"),
+      gab("GAB"), gcd("GCD"), top("Top");
+  not_f.formula(formula(mef::kNot, {f}));
+  not_g.formula(formula(mef::kNot, {g}));
+  xor_ab.formula(formula(mef::kXor, {a, b}));
+  ef.formula(formula(mef::kAnd, {e, &not_f}));
+  gab.formula(formula(mef::kAnd, {g, &xor_ab}));
+  gcd.formula(formula(mef::kAnd, {&not_g, c, d}));
+  top.formula(formula(mef::kOr, {&ef, &gab, &gcd}));
+  auto evaluate = [](int x) {  // The bits of the variables in the name order.
+    auto bit = [x](int i) { return static_cast<bool>(x & (1 << i)); };
+    return (bit(4) && !bit(5)) || (bit(6) && (bit(0) != bit(1))) ||
+           (!bit(6) && bit(2) && bit(3));
+  };
+
+  // Terms with the variables absent (0), positive (1), or negative (2).
+  const int num_vars = names.size();
+  auto is_implicant = [&evaluate, num_vars](const std::vector<int>& term) {
+    for (int x = 0; x < (1 << num_vars); ++x) {
+      bool covered = true;
+      for (int i = 0; i < num_vars && covered; ++i)
+        covered = !term[i] || (term[i] == 1) == static_cast<bool>(x & (1 << i));
+      if (covered && !evaluate(x))
+        return false;
+    }
+    return true;
+  };
+  std::set<std::set<std::string>> prime_implicants;
+  std::vector<int> term(num_vars, 0);
+  for (int code = 0; code < std::pow(3, num_vars); ++code) {
+    for (int i = 0, rest = code; i < num_vars; ++i, rest /= 3)
+      term[i] = rest % 3;
+    if (!is_implicant(term))
+      continue;
+    bool prime = true;
+    for (int i = 0; i < num_vars && prime; ++i) {
+      if (!term[i])
+        continue;
+      std::vector<int> reduced = term;
+      reduced[i] = 0;
+      prime = !is_implicant(reduced);
+    }
+    if (!prime)
+      continue;
+    std::set<std::string> literals;
+    for (int i = 0; i < num_vars; ++i) {
+      if (term[i])
+        literals.insert((term[i] == 2 ? "~" : "") + names[i]);
+    }
+    prime_implicants.insert(literals);
+  }
+  ASSERT_FALSE(prime_implicants.empty());
+
+  for (int limit : {0, 1, 2, num_vars}) {
+    Settings settings;
+    settings.prime_implicants(true).limit_order(limit);
+    FaultTreeAnalyzer<Bdd> analysis(top, settings);
+    analysis.Analyze();
+    std::set<std::set<std::string>> products;
+    for (const Product& product : analysis.products()) {
+      std::set<std::string> literals;
+      for (const Literal& literal : product)
+        literals.insert((literal.complement ? "~" : "") + literal.event.id());
+      products.insert(literals);
+    }
+    std::set<std::set<std::string>> expected;
+    for (const std::set<std::string>& literals : prime_implicants) {
+      if (literals.size() <= limit)
+        expected.insert(literals);
+    }
+    EXPECT_EQ(expected, products) << limit;
+    if (limit == num_vars)
+      EXPECT_LT(0, analysis.algorithm()->num_consensus_hits());
+  }
+}
+
+}  // namespace test
+}  // namespace core
+}  // namespace scram